@@ -1003,6 +1003,11 @@ private:
         Ledger::pointer newOL = std::make_shared<Ledger>
             (true, *newLCL);
 
+        // Record what goes into it, so the next one can reuse the results
+        OpenLedgerRecord::pointer newRecord;
+        if (getConfig ().OPEN_LEDGER_REUSE)
+            newRecord = std::make_shared<OpenLedgerRecord> (newLCL);
+
         // Apply disputed transactions that didn't get in
         TransactionEngine engine (newOL);
         bool anyDisputes = false;
@@ -1034,7 +1039,8 @@ private:
         if (anyDisputes)
         {
             applyTransactions (std::shared_ptr<SHAMap>(),
-                newOL, newLCL, retriableTransactions, true);
+                newOL, newLCL, retriableTransactions, true,
+                    nullptr, newRecord);
         }
 
         {
@@ -1049,16 +1055,33 @@ private:
             {
                 WriteLog (lsDEBUG, LedgerConsensus)
                     << "Applying transactions from current open ledger";
+
+                // Reuse the results the old open ledger recorded
+                OpenLedgerRecord::pointer oldRecord;
+                if (newRecord)
+                {
+                    oldRecord = getApp().getLedgerMaster().getOpenRecord ();
+                    if (oldRecord && !oldRecord->prepare (oldOL, newLCL, newOL))
+                        oldRecord.reset ();
+                }
+
                 applyTransactions (oldOL->peekTransactionMap (),
-                    newOL, newLCL, retriableTransactions, true);
+                    newOL, newLCL, retriableTransactions, true,
+                        oldRecord, newRecord);
             }
 
             // Apply local transactions
             TransactionEngine engine (newOL);
+            uint256 const applied = newOL->peekTransactionMap ()->getHash ();
             m_localTX.apply (engine);
 
+            // Local transactions aren't recorded
+            if (newRecord &&
+                    (newOL->peekTransactionMap ()->getHash () != applied))
+                newRecord->invalidate ();
+
             // We have a new Last Closed Ledger and new Open Ledger
-            getApp().getLedgerMaster ().pushLedger (newLCL, newOL);
+            getApp().getLedgerMaster ().pushLedger (newLCL, newOL, newRecord);
         }
 
         mNewLedgerHash = newLCL->getHash ();
@@ -1126,15 +1149,17 @@ private:
             {
                 // transaction is only in first map
                 assert (!pos.second.second);
+                auto const& item = pos.second.first;
                 addDisputedTransaction (pos.first
-                    , pos.second.first->peekData ());
+                    , Blob (item->data (), item->data () + item->size ()));
             }
             else if (pos.second.second)
             {
                 // transaction is only in second map
                 assert (!pos.second.first);
+                auto const& item = pos.second.second;
                 addDisputedTransaction (pos.first
-                    , pos.second.second->peekData ());
+                    , Blob (item->data (), item->data () + item->size ()));
             }
             else // No other disagreement over a transaction should be possible
                 assert (false);
@@ -1471,7 +1496,7 @@ private:
 
                 if (it.second->getOurVote ()) // now a yes
                 {
-                    ourPosition->addItem (SHAMapItem (it.first
+                    ourPosition->addGiveItem (make_shamapitem (it.first
                         , it.second->peekTransaction ()), true, false);
                     //              addedTx.push_back(it.first);
                 }
@@ -1792,11 +1817,13 @@ make_LedgerConsensus (LocalTxs& localtx,
   @param txn          The transaction to be applied to ledger.
   @param openLedger   true if ledger is open
   @param retryAssured true if the transaction should be retried on failure.
+  @param record       If set, records the transaction if it applies.
   @return             One of resultSuccess, resultFail or resultRetry.
 */
 static
 int applyTransaction (TransactionEngine& engine
-    , STTx::ref txn, bool openLedger, bool retryAssured)
+    , STTx::ref txn, bool openLedger, bool retryAssured
+    , OpenLedgerRecord* record = nullptr)
 {
     // Returns false if the transaction has need not be retried.
     TransactionEngineParams parms = openLedger ? tapOPEN_LEDGER : tapNONE;
@@ -1820,7 +1847,9 @@ int applyTransaction (TransactionEngine& engine
 
     try
     {
-        auto result = engine.applyTransaction (*txn, parms);
+        auto result = record
+            ? record->apply (engine, *txn, parms)
+            : engine.applyTransaction (*txn, parms);
 
         if (result.second)
         {
@@ -1858,16 +1887,25 @@ int applyTransaction (TransactionEngine& engine
                                messages (typically new last closed ledger).
   @param retriableTransactions collect failed transactions in this set
   @param openLgr               true if applyLedger is open, else false.
+  @param reuse                 If set, the prepared record of the open
+                               ledger the transactions in the set come from.
+                               Results that still hold are reused.
+  @param record                If set, records what is applied.
 */
 void applyTransactions (std::shared_ptr<SHAMap> const& set,
     Ledger::ref applyLedger, Ledger::ref checkLedger,
-    CanonicalTXSet& retriableTransactions, bool openLgr)
+    CanonicalTXSet& retriableTransactions, bool openLgr,
+    OpenLedgerRecord::pointer const& reuse,
+    OpenLedgerRecord::pointer const& record)
 {
     TransactionEngine engine (applyLedger);
 
     if (set)
     {
-        for (std::shared_ptr<SHAMapItem> item = set->peekFirstItem (); !!item;
+        int candidates = 0;
+        int reused = 0;
+
+        for (SHAMapItem::pointer item = set->peekFirstItem (); !!item;
             item = set->peekNextItem (item->getTag ()))
         {
             // If the checkLedger doesn't have the transaction
@@ -1878,11 +1916,17 @@ void applyTransactions (std::shared_ptr<SHAMap> const& set,
                     "Processing candidate transaction: " << item->getTag ();
                 try
                 {
-                    SerialIter sit (item->peekSerializer ());
+                    SerialIter sit (item->slice ());
                     STTx::pointer txn
                         = std::make_shared<STTx>(sit);
-                    if (applyTransaction (engine, txn,
-                              openLgr, true) == LedgerConsensusImp::resultRetry)
+                    ++candidates;
+                    if (reuse && record &&
+                        record->reapply (engine, *txn, *reuse))
+                    {
+                        ++reused;
+                    }
+                    else if (applyTransaction (engine, txn, openLgr, true,
+                        record.get ()) == LedgerConsensusImp::resultRetry)
                     {
                         // On failure, stash the failed transaction for
                         // later retry.
@@ -1895,6 +1939,10 @@ void applyTransactions (std::shared_ptr<SHAMap> const& set,
                 }
             }
         }
+
+        CondLog (reuse != nullptr, lsDEBUG, LedgerConsensus) <<
+            "Reused " << reused << " of " << candidates <<
+            " transaction results";
     }
 
     int changes;
@@ -1914,7 +1962,7 @@ void applyTransactions (std::shared_ptr<SHAMap> const& set,
             try
             {
                 switch (applyTransaction (engine, it->second,
-                        openLgr, certainRetry))
+                        openLgr, certainRetry, record.get ()))
                 {
                 case LedgerConsensusImp::resultSuccess:
                     it = retriableTransactions.erase (it);
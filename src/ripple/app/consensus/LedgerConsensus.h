@@ -22,6 +22,7 @@
 
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/ledger/LedgerProposal.h>
+#include <ripple/app/ledger/OpenLedgerRecord.h>
 #include <ripple/app/misc/CanonicalTXSet.h>
 #include <ripple/app/misc/FeeVote.h>
 #include <ripple/app/tx/LocalTxs.h>
@@ -83,7 +84,9 @@ make_LedgerConsensus (LocalTxs& localtx,
 void
 applyTransactions(std::shared_ptr<SHAMap> const& set, Ledger::ref applyLedger,
                   Ledger::ref checkLedger,
-                  CanonicalTXSet& retriableTransactions, bool openLgr);
+                  CanonicalTXSet& retriableTransactions, bool openLgr,
+                  OpenLedgerRecord::pointer const& reuse = nullptr,
+                  OpenLedgerRecord::pointer const& record = nullptr);
 
 } // ripple
 
@@ -19,8 +19,11 @@
 
 #include <BeastConfig.h>
 #include <ripple/app/ledger/AcceptedLedger.h>
+#include <ripple/app/main/Application.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/seconds_clock.h>
+#include <ripple/core/ParallelFor.h>
+#include <thread>
 
 namespace ripple {
 
@@ -31,16 +34,39 @@ TaggedCache <uint256, AcceptedLedger> AcceptedLedger::s_cache (
     "AcceptedLedger", 4, 60, get_seconds_clock (),
         deprecatedLogs().journal("TaggedCache"));
 
+// Transactions for each job helping to build an accepted ledger
+static std::size_t const txnsPerHelper = 16;
+
 AcceptedLedger::AcceptedLedger (Ledger::ref ledger) : mLedger (ledger)
 {
     SHAMap& txSet = *ledger->peekTransactionMap ();
 
-    for (std::shared_ptr<SHAMapItem> item = txSet.peekFirstItem (); item;
+    std::vector <SHAMapItem::pointer> items;
+    for (SHAMapItem::pointer item = txSet.peekFirstItem (); item;
          item = txSet.peekNextItem (item->getTag ()))
     {
-        SerialIter sit (item->peekSerializer ());
-        insert (std::make_shared<AcceptedLedgerTx> (ledger, std::ref (sit)));
+        items.push_back (item);
     }
+
+    // Parsing the transactions and metadata and rendering their JSON is
+    // independent per transaction, so spread it across the job queue.
+    // Small ledgers get no helpers and are built on this thread.
+    std::vector <AcceptedLedgerTx::pointer> txns (items.size ());
+
+    parallelFor (getApp().getJobQueue (), jtPUBLEDGER, "AcceptedLedger",
+        items.size (), std::min <std::size_t> (
+            items.size () / txnsPerHelper,
+            std::max (1u, std::thread::hardware_concurrency ()) - 1),
+        [&] (std::size_t i)
+        {
+            SerialIter sit (items[i]->slice ());
+            txns[i] = std::make_shared<AcceptedLedgerTx> (
+                ledger, std::ref (sit));
+        });
+
+    // Insert in ledger order so the result does not depend on scheduling
+    for (auto const& txn : txns)
+        insert (txn);
 }
 
 AcceptedLedger::pointer AcceptedLedger::makeAcceptedLedger (Ledger::ref ledger)
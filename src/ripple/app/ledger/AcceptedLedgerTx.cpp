@@ -21,6 +21,7 @@
 #include <ripple/app/ledger/AcceptedLedgerTx.h>
 #include <ripple/app/ledger/LedgerEntrySet.h>
 #include <ripple/basics/StringUtilities.h>
+#include <ripple/json/to_string.h>
 #include <ripple/protocol/JsonFields.h>
 
 namespace ripple {
@@ -103,6 +104,32 @@ void AcceptedLedgerTx::buildJson ()
             mJson[jss::transaction][jss::owner_funds] = ownerFunds.getText ();
         }
     }
+
+    if (mMeta)
+        buildPublishJson ();
+}
+
+void AcceptedLedgerTx::buildPublishJson ()
+{
+    std::string sToken;
+    std::string sHuman;
+
+    transResultInfo (mResult, sToken, sHuman);
+
+    mPublishJson = Json::objectValue;
+    mPublishJson[jss::type]                  = "transaction";
+    mPublishJson[jss::transaction]           = mJson[jss::transaction];
+    mPublishJson[jss::transaction][jss::date] = mLedger->getCloseTimeNC ();
+    mPublishJson[jss::ledger_index]          = mLedger->getLedgerSeq ();
+    mPublishJson[jss::ledger_hash]           = to_string (mLedger->getHash ());
+    mPublishJson[jss::validated]             = true;
+    mPublishJson[jss::status]                = "closed";
+    mPublishJson[jss::engine_result]         = sToken;
+    mPublishJson[jss::engine_result_code]    = mResult;
+    mPublishJson[jss::engine_result_message] = sHuman;
+    mPublishJson[jss::meta]                  = mJson[jss::meta];
+
+    mPublishString = to_string (mPublishJson);
 }
 
 } // ripple
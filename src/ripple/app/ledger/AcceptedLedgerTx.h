@@ -94,11 +94,26 @@ public:
         return mMeta ? mMeta->getIndex () : 0;
     }
     std::string getEscMeta () const;
-    Json::Value getJson () const
+    Json::Value const& getJson () const
     {
         return mJson;
     }
 
+    /** The message sent to "transactions" and "accounts" subscribers.
+
+        Only available for applied transactions. It is rendered along with
+        the rest of the JSON so publishing does not repeat the work for
+        every stream.
+    */
+    Json::Value const& getPublishJson () const
+    {
+        return mPublishJson;
+    }
+    std::string const& getPublishString () const
+    {
+        return mPublishString;
+    }
+
 private:
     Ledger::pointer                 mLedger;
     STTx::pointer  mTxn;
@@ -107,8 +122,11 @@ private:
     std::vector <RippleAddress>     mAffected;
     Blob        mRawMeta;
     Json::Value                     mJson;
+    Json::Value                     mPublishJson;
+    std::string                     mPublishString;
 
     void buildJson ();
+    void buildPublishJson ();
 };
 
 } // ripple
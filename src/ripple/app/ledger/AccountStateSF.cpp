@@ -27,7 +27,8 @@
 
 namespace ripple {
 
-AccountStateSF::AccountStateSF()
+AccountStateSF::AccountStateSF (std::uint32_t ledgerSeq)
+    : ledgerSeq_ (ledgerSeq)
 {
 }
 
@@ -41,7 +42,7 @@ void AccountStateSF::gotNode (bool fromFilter,
     //        SHAMap should provide an accessor to get the injected Database,
     //        and this should use that Database instad of getNodeStore
     getApp().getNodeStore ().store (
-        hotACCOUNT_NODE, std::move (nodeData), nodeHash);
+        hotACCOUNT_NODE, std::move (nodeData), nodeHash, ledgerSeq_);
 }
 
 bool AccountStateSF::haveNode (SHAMapNodeID const& id,
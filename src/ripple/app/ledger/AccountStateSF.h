@@ -29,7 +29,8 @@ namespace ripple {
 class AccountStateSF : public SHAMapSyncFilter
 {
 public:
-    AccountStateSF();
+    explicit
+    AccountStateSF (std::uint32_t ledgerSeq);
 
     // Note that the nodeData is overwritten by this call
     void gotNode (bool fromFilter,
@@ -41,6 +42,10 @@ public:
     bool haveNode (SHAMapNodeID const& id,
                    uint256 const& nodeHash,
                    Blob& nodeData) override;
+
+private:
+    // The ledger whose nodes are being acquired
+    std::uint32_t ledgerSeq_;
 };
 
 } // ripple
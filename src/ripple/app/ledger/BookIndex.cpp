@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/BookIndex.h>
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/protocol/Indexes.h>
+#include <algorithm>
+
+namespace ripple {
+
+BookIndex::BookIndex (Ledger const& ledger)
+    : ledger_ (ledger)
+{
+}
+
+bool BookIndex::isBookRange (uint256 const& key, uint256 const& end)
+{
+    return end <= getQualityNext (getQualityIndex (key));
+}
+
+std::shared_ptr <BookIndex::Book const>
+BookIndex::getBook (uint256 const& key)
+{
+    uint256 const base = getQualityIndex (key);
+
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        auto const iter = books_.find (base);
+        if (iter != books_.end ())
+            return iter->second;
+    }
+
+    // Build without the lock. If two threads race, both build the same
+    // book and the first one stored is kept.
+    auto book = build (base);
+
+    std::lock_guard <std::mutex> lock (mutex_);
+    return books_.emplace (base, std::move (book)).first->second;
+}
+
+uint256 BookIndex::getNextDirectory (uint256 const& key, uint256 const& end)
+{
+    assert (isBookRange (key, end));
+
+    auto const book = getBook (key);
+    auto const iter = std::upper_bound (book->begin (), book->end (), key,
+        [](uint256 const& k, Directory const& dir)
+        {
+            return k < dir.key;
+        });
+
+    if (iter == book->end () || iter->key > end)
+        return uint256 ();
+
+    return iter->key;
+}
+
+std::shared_ptr <BookIndex::Book const>
+BookIndex::build (uint256 const& base) const
+{
+    auto book = std::make_shared <Book> ();
+    auto const& stateMap = *ledger_.peekAccountStateMap ();
+    uint256 const end = getQualityNext (base);
+
+    for (auto item = stateMap.peekNextItem (base);
+        item && item->getTag () <= end;
+        item = stateMap.peekNextItem (item->getTag ()))
+    {
+        Directory dir;
+        dir.key = item->getTag ();
+
+        auto page = ledger_.getSLEi (dir.key);
+        while (page && page->getType () == ltDIR_NODE)
+        {
+            for (auto const& offerKey : page->getFieldV256 (sfIndexes))
+            {
+                Offer offer;
+                offer.key = offerKey;
+                offer.entry = ledger_.getSLEi (offerKey);
+
+                if (offer.entry && offer.entry->getType () == ltOFFER)
+                {
+                    offer.owner = offer.entry->getFieldAccount160 (sfAccount);
+                    offer.takerPays = offer.entry->getFieldAmount (sfTakerPays);
+                    offer.takerGets = offer.entry->getFieldAmount (sfTakerGets);
+                }
+                else
+                {
+                    offer.entry = nullptr;
+                }
+
+                dir.offers.push_back (std::move (offer));
+            }
+
+            std::uint64_t const next = page->getFieldU64 (sfIndexNext);
+            if (next == 0)
+                break;
+
+            page = ledger_.getSLEi (getDirNodeIndex (dir.key, next));
+        }
+
+        book->push_back (std::move (dir));
+    }
+
+    return book;
+}
+
+} // ripple
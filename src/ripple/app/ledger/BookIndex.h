@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_APP_LEDGER_BOOKINDEX_H_INCLUDED
+#define RIPPLE_APP_LEDGER_BOOKINDEX_H_INCLUDED
+
+#include <ripple/protocol/STAmount.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <ripple/protocol/UintTypes.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+class Ledger;
+
+/** The order books of an immutable ledger, sorted for iteration.
+
+    Walking a book in the state tree costs a descent from the root for
+    every quality directory, and the directories and offers are parsed
+    again by every reader. Since an immutable ledger cannot change, each
+    book is instead read once, the first time it is asked for, into an
+    array of its quality directories with their offers already parsed.
+
+    The index only describes the ledger itself. Views which change it, such
+    as a LedgerEntrySet, apply their own changes on top.
+
+    A book covers the keys from its base through the base of the next book,
+    inclusive, so a lookup bounded by getQualityNext gives exactly what the
+    state tree would.
+*/
+class BookIndex
+{
+public:
+    struct Offer
+    {
+        uint256 key;
+
+        // Null if the directory names an offer which does not exist
+        SLE::pointer entry;
+
+        Account owner;
+        STAmount takerPays;
+        STAmount takerGets;
+    };
+
+    struct Directory
+    {
+        // The first page of the directory, which encodes the quality
+        uint256 key;
+
+        // In directory order
+        std::vector <Offer> offers;
+    };
+
+    // Best quality first
+    using Book = std::vector <Directory>;
+
+    explicit BookIndex (Ledger const& ledger);
+
+    BookIndex (BookIndex const&) = delete;
+    BookIndex& operator= (BookIndex const&) = delete;
+
+    /** Return the book which contains the key.
+        @param key Any key at or after the base of the book.
+    */
+    std::shared_ptr <Book const> getBook (uint256 const& key);
+
+    /** Return the first directory after `key` and no later than `end`.
+
+        Both must lie in the same book. Returns zero if there is no
+        directory in the range.
+    */
+    uint256 getNextDirectory (uint256 const& key, uint256 const& end);
+
+    /** Return `true` if a range can be answered from a single book. */
+    static bool isBookRange (uint256 const& key, uint256 const& end);
+
+private:
+    std::shared_ptr <Book const> build (uint256 const& base) const;
+
+    Ledger const& ledger_;
+
+    std::mutex mutex_;
+    hash_map <uint256, std::shared_ptr <Book const>> books_;
+};
+
+} // ripple
+
+#endif
@@ -108,19 +108,27 @@ STAmount DeferredCredits::adjustedBalance (Account const& main,
     STAmount result (curBalance);
 
     Key const k = makeKey (main, other, curBalance.getCurrency ());
-    auto i = map_.find (k);
-    if (i != map_.end ())
+
+    auto adjust = [&](Map const& map)
     {
-        auto const& v = i->second;
-        if (main < other)
+        auto i = map.find (k);
+        if (i != map.end ())
         {
-            result -= get<0> (v);
+            auto const& v = i->second;
+            if (main < other)
+            {
+                result -= get<0> (v);
+            }
+            else
+            {
+                result -= get<1> (v);
+            }
         }
-        else
-        {
-            result -= get<1> (v);
-        }
-    }
+    };
+
+    adjust (map_);
+    for (auto layer = base_.get (); layer; layer = layer->next.get ())
+        adjust (layer->map);
 
     WriteLog (lsTRACE, DeferredCredits)
             << "adjustedBalance: " << main << ", " <<
@@ -132,5 +140,49 @@ STAmount DeferredCredits::adjustedBalance (Account const& main,
 void DeferredCredits::clear ()
 {
     map_.clear ();
+    base_.reset ();
+}
+
+void DeferredCredits::addTo (Value& total, Value const& v)
+{
+    using std::get;
+    get<0> (total) += get<0> (v);
+    get<1> (total) += get<1> (v);
+}
+
+DeferredCredits DeferredCredits::checkpoint () const
+{
+    DeferredCredits result;
+
+    if (map_.empty ())
+    {
+        result.base_ = base_;
+        return result;
+    }
+
+    auto layer = std::make_shared<Layer> ();
+    layer->map = map_;
+    layer->next = base_;
+
+    // Fold in layers that are not much larger than the new one, so the
+    // number of layers stays logarithmic in the number of credits.
+    while (layer->next &&
+        layer->next->map.size () <= 2 * layer->map.size ())
+    {
+        Map merged (layer->next->map);
+        for (auto const& v : layer->map)
+        {
+            auto const i = merged.find (v.first);
+            if (i == merged.end ())
+                merged.insert (v);
+            else
+                addTo (i->second, v.second);
+        }
+        layer->map.swap (merged);
+        layer->next = layer->next->next;
+    }
+
+    result.base_ = std::move (layer);
+    return result;
 }
 }
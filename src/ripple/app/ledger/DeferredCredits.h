@@ -23,6 +23,7 @@
 #include <ripple/protocol/UintTypes.h>
 #include <ripple/protocol/STAmount.h>
 #include <map>
+#include <memory>
 #include <tuple>
 
 namespace ripple {
@@ -42,7 +43,20 @@ private:
             return std::make_tuple(a2, a1, c);
     }
 
-    std::map<Key, Value> map_;
+    using Map = std::map<Key, Value>;
+
+    // Credits recorded before the last checkpoint. Layers are immutable
+    // and shared between checkpoints; credits in all layers add up.
+    struct Layer
+    {
+        Map map;
+        std::shared_ptr<Layer const> next;
+    };
+
+    Map map_;
+    std::shared_ptr<Layer const> base_;
+
+    static void addTo (Value& total, Value const& v);
 
 public:
     void credit (Account const& sender,
@@ -54,6 +68,10 @@ public:
                               Account const& other,
                               STAmount const& curBalance) const;
     void clear ();
+
+    // Return a copy that shares our credits instead of copying them.
+    // Credits made to the copy are kept apart from ours.
+    DeferredCredits checkpoint () const;
 };
 }
 #endif
@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <BeastConfig.h>
+#include <ripple/shamap/SHAMapNodeBatch.h>
 #include <ripple/shamap/SHAMapNodeID.h>
 #include <ripple/app/ledger/AccountStateSF.h>
 #include <ripple/app/ledger/InboundLedger.h>
@@ -27,12 +28,14 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/basics/Log.h>
+#include <ripple/core/Config.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/overlay/Overlay.h>
 #include <ripple/resource/Fees.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <ripple/protocol/JsonFields.h>
 #include <ripple/nodestore/Database.h>
+#include <algorithm>
 
 namespace ripple {
 
@@ -55,6 +58,9 @@ enum
 
     // How many nodes to consider a fetch "small"
     ,fetchSmallNodes = 32
+
+    // The most nodes to ask a peer for in one request
+    ,nodesPerRequest = 128
 };
 
 InboundLedger::InboundLedger (uint256 const& hash, std::uint32_t seq, fcReason reason,
@@ -150,7 +156,7 @@ bool InboundLedger::tryLocal ()
     if (!mHaveHeader)
     {
         // Nothing we can do without the ledger header
-        NodeObject::pointer node = getApp().getNodeStore ().fetch (mHash);
+        NodeObject::pointer node = getApp().getNodeStore ().fetch (mHash, mSeq);
 
         if (!node)
         {
@@ -163,7 +169,7 @@ bool InboundLedger::tryLocal ()
                 "Ledger header found in fetch pack";
             mLedger = std::make_shared<Ledger> (data, true);
             getApp().getNodeStore ().store (
-                hotLEDGER, std::move (data), mHash);
+                hotLEDGER, std::move (data), mHash, mLedger->getLedgerSeq ());
         }
         else
         {
@@ -193,7 +199,7 @@ bool InboundLedger::tryLocal ()
         }
         else
         {
-            TransactionStateSF filter;
+            TransactionStateSF filter (mLedger->getLedgerSeq ());
 
             if (mLedger->peekTransactionMap ()->fetchRoot (
                 mLedger->getTransHash (), &filter))
@@ -221,7 +227,7 @@ bool InboundLedger::tryLocal ()
         }
         else
         {
-            AccountStateSF filter;
+            AccountStateSF filter (mLedger->getLedgerSeq ());
 
             if (mLedger->peekAccountStateMap ()->fetchRoot (
                 mLedger->getAccountHash (), &filter))
@@ -256,6 +262,10 @@ void InboundLedger::onTimer (bool wasProgress, ScopedLockType&)
 {
     mRecentNodes.clear ();
 
+    // Requests still unanswered are presumed lost
+    for (auto& entry : mRequests)
+        entry.second.sent.clear ();
+
     if (isDone())
     {
         if (m_journal.info) m_journal.info <<
@@ -358,6 +368,8 @@ void InboundLedger::done ()
         mLedger->setImmutable ();
         if (mReason != fcHISTORY)
             getApp().getLedgerMaster ().storeLedger (mLedger);
+        else
+            indexHistory ();
         getApp().getInboundLedgers().onLedgerFetched(mReason);
     }
     else
@@ -369,6 +381,28 @@ void InboundLedger::done ()
                    triggers));
 }
 
+/** A history ledger on the validated chain vouches for the hashes of
+    the ledgers before it, so record them for the next fetches.
+*/
+void InboundLedger::indexHistory ()
+{
+    auto& index = getApp().getLedgerMaster ().getLedgerHashIndex ();
+
+    if (mSeq == 0 || index.get (mSeq) != mHash)
+        return;
+
+    try
+    {
+        index.insert (mSeq - 1, mLedger->getParentHash ());
+        index.insert (mLedger->getLedgerHashes ());
+    }
+    catch (SHAMapMissingNode const&)
+    {
+        if (m_journal.debug) m_journal.debug <<
+            "Missing skip list in history ledger " << mSeq;
+    }
+}
+
 bool InboundLedger::addOnComplete (
     std::function <void (InboundLedger::pointer)> triggerFunc)
 {
@@ -514,9 +548,25 @@ void InboundLedger::trigger (Peer::ptr const& peer)
     else
         tmGL.set_querydepth (1);
 
-    // Get the state data first because it's the most likely to be useful
-    // if we wind up abandoning this fetch.
-    if (mHaveHeader && !mHaveState && !mFailed)
+    // Keep the peer's window of node requests full, asking for both maps at
+    // once. The state data comes first because it's the most likely to be
+    // useful if we wind up abandoning this fetch, but when the window has
+    // room for more than one request the transactions get one of them.
+    int const requests = getFreeRequests (peer);
+    bool const needState = mHaveHeader && !mHaveState && !mFailed;
+    bool const needTransactions = mHaveHeader && !mHaveTransactions && !mFailed;
+
+    int txRequests = 0;
+    if (needTransactions)
+        txRequests = needState ? ((requests > 1) ? 1 : 0) : requests;
+    int const asRequests = needState ? requests - txRequests : 0;
+
+    // The first missing nodes are likely to be in flight already, so look
+    // far enough past them to fill the window with new ones
+    int const missingMax = static_cast<int> (
+        (getOutstandingRequests () + requests) * nodesPerRequest);
+
+    if (needState && asRequests > 0)
     {
         assert (mLedger);
 
@@ -527,26 +577,25 @@ void InboundLedger::trigger (Peer::ptr const& peer)
         else if (mLedger->peekAccountStateMap ()->getHash ().isZero ())
         {
             // we need the root node
-            tmGL.set_itype (protocol::liAS_NODE);
-            *tmGL.add_nodeids () = SHAMapNodeID ().getRawString ();
+            protocol::TMGetLedger tmAS (tmGL);
+            tmAS.set_itype (protocol::liAS_NODE);
+            *tmAS.add_nodeids () = SHAMapNodeID ().getRawString ();
             if (m_journal.trace) m_journal.trace <<
                 "Sending AS root request to " << (peer ? "selected peer" : "all peers");
-            sendRequest (tmGL, peer);
-            return;
+            sendNodeRequest (tmAS, peer);
         }
         else
         {
             std::vector<SHAMapNodeID> nodeIDs;
             std::vector<uint256> nodeHashes;
-            // VFALCO Why 256? Make this a constant
-            nodeIDs.reserve (256);
-            nodeHashes.reserve (256);
-            AccountStateSF filter;
+            nodeIDs.reserve (missingMax);
+            nodeHashes.reserve (missingMax);
+            AccountStateSF filter (mLedger->getLedgerSeq ());
 
             // Release the lock while we process the large state map
             sl.unlock();
             mLedger->peekAccountStateMap ()->getMissingNodes (
-                nodeIDs, nodeHashes, 256, &filter);
+                nodeIDs, nodeHashes, missingMax, &filter);
             sl.lock();
 
             // Make sure nothing happened while we released the lock
@@ -566,31 +615,23 @@ void InboundLedger::trigger (Peer::ptr const& peer)
                 }
                 else
                 {
-                    // VFALCO Why 128? Make this a constant
                     if (!mAggressive)
-                        filterNodes (nodeIDs, nodeHashes, 128, !isProgress ());
+                        filterNodes (nodeIDs, nodeHashes,
+                            asRequests * nodesPerRequest, !isProgress ());
 
                     if (!nodeIDs.empty ())
                     {
-                        tmGL.set_itype (protocol::liAS_NODE);
-                        for (auto const& id : nodeIDs)
-                        {
-                            * (tmGL.add_nodeids ()) = id.getRawString ();
-                        }
-
-                        // If we're not querying for a lot of entries,
-                        // query extra deep
-                        if (nodeIDs.size() <= fetchSmallNodes)
-                            tmGL.set_querydepth (tmGL.querydepth() + 1);
+                        protocol::TMGetLedger tmAS (tmGL);
+                        tmAS.set_itype (protocol::liAS_NODE);
+                        int const sent = requestNodes (
+                            tmAS, nodeIDs, asRequests, peer);
 
                         if (m_journal.trace) m_journal.trace <<
                             "Sending AS node " << nodeIDs.size () <<
-                                " request to " << (
+                                " in " << sent << " requests to " << (
                                     peer ? "selected peer" : "all peers");
                         if (nodeIDs.size () == 1 && m_journal.trace) m_journal.trace <<
                             "AS node: " << nodeIDs[0];
-                        sendRequest (tmGL, peer);
-                        return;
                     }
                     else
                         if (m_journal.trace) m_journal.trace <<
@@ -600,7 +641,7 @@ void InboundLedger::trigger (Peer::ptr const& peer)
         }
     }
 
-    if (mHaveHeader && !mHaveTransactions && !mFailed)
+    if (needTransactions && txRequests > 0 && !mFailed)
     {
         assert (mLedger);
 
@@ -611,23 +652,23 @@ void InboundLedger::trigger (Peer::ptr const& peer)
         else if (mLedger->peekTransactionMap ()->getHash ().isZero ())
         {
             // we need the root node
-            tmGL.set_itype (protocol::liTX_NODE);
-            * (tmGL.add_nodeids ()) = SHAMapNodeID ().getRawString ();
+            protocol::TMGetLedger tmTX (tmGL);
+            tmTX.set_itype (protocol::liTX_NODE);
+            * (tmTX.add_nodeids ()) = SHAMapNodeID ().getRawString ();
             if (m_journal.trace) m_journal.trace <<
                 "Sending TX root request to " << (
                     peer ? "selected peer" : "all peers");
-            sendRequest (tmGL, peer);
-            return;
+            sendNodeRequest (tmTX, peer);
         }
         else
         {
             std::vector<SHAMapNodeID> nodeIDs;
             std::vector<uint256> nodeHashes;
-            nodeIDs.reserve (256);
-            nodeHashes.reserve (256);
-            TransactionStateSF filter;
+            nodeIDs.reserve (missingMax);
+            nodeHashes.reserve (missingMax);
+            TransactionStateSF filter (mLedger->getLedgerSeq ());
             mLedger->peekTransactionMap ()->getMissingNodes (
-                nodeIDs, nodeHashes, 256, &filter);
+                nodeIDs, nodeHashes, missingMax, &filter);
 
             if (nodeIDs.empty ())
             {
@@ -644,21 +685,20 @@ void InboundLedger::trigger (Peer::ptr const& peer)
             else
             {
                 if (!mAggressive)
-                    filterNodes (nodeIDs, nodeHashes, 128, !isProgress ());
+                    filterNodes (nodeIDs, nodeHashes,
+                        txRequests * nodesPerRequest, !isProgress ());
 
                 if (!nodeIDs.empty ())
                 {
-                    tmGL.set_itype (protocol::liTX_NODE);
-                    for (auto const& id : nodeIDs)
-                    {
-                        * (tmGL.add_nodeids ()) = id.getRawString ();
-                    }
+                    protocol::TMGetLedger tmTX (tmGL);
+                    tmTX.set_itype (protocol::liTX_NODE);
+                    int const sent = requestNodes (
+                        tmTX, nodeIDs, txRequests, peer);
+
                     if (m_journal.trace) m_journal.trace <<
                         "Sending TX node " << nodeIDs.size () <<
-                        " request to " << (
+                        " in " << sent << " requests to " << (
                             peer ? "selected peer" : "all peers");
-                    sendRequest (tmGL, peer);
-                    return;
                 }
                 else
                     if (m_journal.trace) m_journal.trace <<
@@ -748,6 +788,116 @@ void InboundLedger::filterNodes (std::vector<SHAMapNodeID>& nodeIDs,
     }
 }
 
+/** Return how many more node requests the peer's window allows.
+    A request sent to every peer is not counted against any window.
+    Call with a lock
+*/
+int InboundLedger::getFreeRequests (Peer::ptr const& peer) const
+{
+    if (!peer)
+        return 1;
+
+    int const window = getConfig ().FETCH_WINDOW;
+    auto const iter = mRequests.find (peer->id ());
+
+    if (iter == mRequests.end ())
+        return window;
+
+    return std::max (0, window - static_cast<int> (iter->second.sent.size ()));
+}
+
+/** Return the number of node requests not yet answered, over all peers
+    Call with a lock
+*/
+std::size_t InboundLedger::getOutstandingRequests () const
+{
+    std::size_t ret = 0;
+
+    for (auto const& entry : mRequests)
+        ret += entry.second.sent.size ();
+
+    return ret;
+}
+
+/** Send a request for nodes, counting it against the peer's window
+    Call with a lock
+*/
+void InboundLedger::sendNodeRequest (protocol::TMGetLedger const& tmGL,
+    Peer::ptr const& peer)
+{
+    if (peer)
+        mRequests[peer->id ()].sent.push_back (m_clock.now ());
+
+    sendRequest (tmGL, peer);
+}
+
+/** Spread the nodes over at most the given number of requests
+    Returns the number of requests sent.
+    Call with a lock
+*/
+int InboundLedger::requestNodes (protocol::TMGetLedger& tmGL,
+    std::vector<SHAMapNodeID> const& nodeIDs, int requests,
+        Peer::ptr const& peer)
+{
+    int const depth = tmGL.querydepth ();
+    int sent = 0;
+
+    for (std::size_t first = 0;
+        first < nodeIDs.size () && sent < requests; first += nodesPerRequest)
+    {
+        std::size_t const last = std::min<std::size_t> (
+            nodeIDs.size (), first + nodesPerRequest);
+
+        tmGL.clear_nodeids ();
+        for (std::size_t i = first; i < last; ++i)
+            * (tmGL.add_nodeids ()) = nodeIDs[i].getRawString ();
+
+        // If we're not querying for a lot of entries,
+        // query extra deep
+        tmGL.set_querydepth (
+            (last - first <= fetchSmallNodes) ? depth + 1 : depth);
+
+        sendNodeRequest (tmGL, peer);
+        ++sent;
+    }
+
+    tmGL.set_querydepth (depth);
+    return sent;
+}
+
+/** Account for a peer answering its oldest node request
+    Call with a lock
+*/
+void InboundLedger::gotNodeReply (Peer::id_t peer, int useful)
+{
+    using namespace std::chrono;
+
+    auto const iter = mRequests.find (peer);
+
+    // Answers to requests sent to every peer are not tracked
+    if (iter == mRequests.end () || iter->second.sent.empty ())
+        return;
+
+    PeerRequests& requests = iter->second;
+
+    auto const latency = std::max (milliseconds (1),
+        duration_cast<milliseconds> (m_clock.now () - requests.sent.front ()));
+    requests.sent.pop_front ();
+
+    double const rate = std::max (useful, 0) * 1000.0 / latency.count ();
+
+    if (requests.latency.count () == 0)
+    {
+        requests.latency = latency;
+        requests.rate = rate;
+    }
+    else
+    {
+        requests.latency = (3 * requests.latency + latency) / 4;
+        requests.rate = (3 * requests.rate + rate) / 4;
+    }
+}
+
 /** Take ledger header data
     Call with a lock
 */
@@ -779,7 +929,7 @@ bool InboundLedger::takeHeader (std::string const& data)
     s.add32 (HashPrefix::ledgerMaster);
     s.addRaw (data);
     getApp().getNodeStore ().store (
-        hotLEDGER, std::move (s.modData ()), mHash);
+        hotLEDGER, std::move (s.modData ()), mHash, mLedger->getLedgerSeq ());
 
     progress ();
 
@@ -797,7 +947,7 @@ bool InboundLedger::takeHeader (std::string const& data)
     Call with a lock
 */
 bool InboundLedger::takeTxNode (const std::vector<SHAMapNodeID>& nodeIDs,
-    const std::vector< Blob >& data, SHAMapAddNode& san)
+    const std::vector<Slice>& data, SHAMapAddNode& san)
 {
     if (!mHaveHeader)
     {
@@ -815,7 +965,7 @@ bool InboundLedger::takeTxNode (const std::vector<SHAMapNodeID>& nodeIDs,
 
     auto nodeIDit = nodeIDs.cbegin ();
     auto nodeDatait = data.begin ();
-    TransactionStateSF tFilter;
+    TransactionStateSF tFilter (mLedger->getLedgerSeq ());
 
     while (nodeIDit != nodeIDs.cend ())
     {
@@ -857,7 +1007,7 @@ bool InboundLedger::takeTxNode (const std::vector<SHAMapNodeID>& nodeIDs,
     Call with a lock
 */
 bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
-    const std::vector< Blob >& data, SHAMapAddNode& san)
+    const std::vector<Slice>& data, SHAMapAddNode& san)
 {
     if (m_journal.trace) m_journal.trace <<
         "got ASdata (" << nodeIDs.size () << ") acquiring ledger " << mHash;
@@ -882,7 +1032,7 @@ bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
 
     auto nodeIDit = nodeIDs.cbegin ();
     auto nodeDatait = data.begin ();
-    AccountStateSF tFilter;
+    AccountStateSF tFilter (mLedger->getLedgerSeq ());
 
     while (nodeIDit != nodeIDs.cend ())
     {
@@ -931,7 +1081,7 @@ bool InboundLedger::takeAsNode (const std::vector<SHAMapNodeID>& nodeIDs,
 /** Process AS root node received from a peer
     Call with a lock
 */
-bool InboundLedger::takeAsRootNode (Blob const& data, SHAMapAddNode& san)
+bool InboundLedger::takeAsRootNode (std::string const& data, SHAMapAddNode& san)
 {
     if (mFailed || mHaveState)
     {
@@ -946,16 +1096,22 @@ bool InboundLedger::takeAsRootNode (Blob const& data, SHAMapAddNode& san)
         return false;
     }
 
-    AccountStateSF tFilter;
+    if (data.empty ())
+    {
+        san.incInvalid();
+        return false;
+    }
+
+    AccountStateSF tFilter (mLedger->getLedgerSeq ());
     san += mLedger->peekAccountStateMap ()->addRootNode (
-        mLedger->getAccountHash (), data, snfWIRE, &tFilter);
+        mLedger->getAccountHash (), makeSlice (data), snfWIRE, &tFilter);
     return san.isGood();
 }
 
 /** Process AS root node received from a peer
     Call with a lock
 */
-bool InboundLedger::takeTxRootNode (Blob const& data, SHAMapAddNode& san)
+bool InboundLedger::takeTxRootNode (std::string const& data, SHAMapAddNode& san)
 {
     if (mFailed || mHaveTransactions)
     {
@@ -970,9 +1126,15 @@ bool InboundLedger::takeTxRootNode (Blob const& data, SHAMapAddNode& san)
         return false;
     }
 
-    TransactionStateSF tFilter;
+    if (data.empty ())
+    {
+        san.incInvalid();
+        return false;
+    }
+
+    TransactionStateSF tFilter (mLedger->getLedgerSeq ());
     san += mLedger->peekTransactionMap ()->addRootNode (
-        mLedger->getTransHash (), data, snfWIRE, &tFilter);
+        mLedger->getTransHash (), makeSlice (data), snfWIRE, &tFilter);
     return san.isGood();
 }
 
@@ -989,7 +1151,7 @@ std::vector<InboundLedger::neededHash_t> InboundLedger::getNeededHashes ()
 
     if (!mHaveState)
     {
-        AccountStateSF filter;
+        AccountStateSF filter (mLedger->getLedgerSeq ());
         // VFALCO NOTE What's the number 4?
         for (auto const& h : mLedger->getNeededAccountStateHashes (4, &filter))
         {
@@ -1000,7 +1162,7 @@ std::vector<InboundLedger::neededHash_t> InboundLedger::getNeededHashes ()
 
     if (!mHaveTransactions)
     {
-        TransactionStateSF filter;
+        TransactionStateSF filter (mLedger->getLedgerSeq ());
         // VFALCO NOTE What's the number 4?
         for (auto const& h : mLedger->getNeededTransactionHashes (4, &filter))
         {
@@ -1070,14 +1232,14 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer,
 
 
         if (!mHaveState && (packet.nodes ().size () > 1) &&
-            !takeAsRootNode (strCopy (packet.nodes (1).nodedata ()), san))
+            !takeAsRootNode (packet.nodes (1).nodedata (), san))
         {
             if (m_journal.warning) m_journal.warning <<
                 "Included AS root invalid";
         }
 
         if (!mHaveTransactions && (packet.nodes ().size () > 2) &&
-            !takeTxRootNode (strCopy (packet.nodes (2).nodedata ()), san))
+            !takeTxRootNode (packet.nodes (2).nodedata (), san))
         {
             if (m_journal.warning) m_journal.warning <<
                 "Included TX root invalid";
@@ -1095,35 +1257,53 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer,
     if ((packet.type () == protocol::liTX_NODE) || (
         packet.type () == protocol::liAS_NODE))
     {
-        if (packet.nodes ().size () == 0)
+        if ((packet.nodes ().size () == 0) && !packet.has_packednodes ())
         {
             if (m_journal.info) m_journal.info <<
                 "Got response with no nodes";
+            gotNodeReply (peer->id (), 0);
             peer->charge (Resource::feeInvalidRequest);
             return -1;
         }
 
+        // The node data is parsed straight out of the packet, which
+        // outlives the calls below.
         std::vector<SHAMapNodeID> nodeIDs;
         nodeIDs.reserve(packet.nodes().size());
-        std::vector< Blob > nodeData;
+        std::vector<Slice> nodeData;
         nodeData.reserve(packet.nodes().size());
 
+        // Holds the nodes of a compressed batch
+        Blob unpacked;
+
+        if (packet.has_packednodes () && (packet.packednodes ().empty () ||
+            !unpackNodes (makeSlice (packet.packednodes ()), unpacked,
+                nodeIDs, nodeData) || nodeIDs.empty ()))
+        {
+            if (m_journal.warning) m_journal.warning <<
+                "Got bad node batch";
+            gotNodeReply (peer->id (), 0);
+            peer->charge (Resource::feeInvalidRequest);
+            return -1;
+        }
+
         for (int i = 0; i < packet.nodes ().size (); ++i)
         {
             const protocol::TMLedgerNode& node = packet.nodes (i);
 
-            if (!node.has_nodeid () || !node.has_nodedata ())
+            if (!node.has_nodeid () || !node.has_nodedata () ||
+                node.nodedata ().empty ())
             {
                 if (m_journal.warning) m_journal.warning <<
                     "Got bad node";
+                gotNodeReply (peer->id (), 0);
                 peer->charge (Resource::feeInvalidRequest);
                 return -1;
             }
 
             nodeIDs.push_back (SHAMapNodeID (node.nodeid ().data (),
                 node.nodeid ().size ()));
-            nodeData.push_back (Blob (node.nodedata ().begin (),
-                node.nodedata ().end ()));
+            nodeData.push_back (makeSlice (node.nodedata ()));
         }
 
         SHAMapAddNode ret;
@@ -1141,6 +1321,8 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer,
                 "Ledger AS node stats: " << ret.get();
         }
 
+        gotNodeReply (peer->id (), ret.getGood ());
+
         if (!ret.isInvalid ())
             progress ();
         else
@@ -1154,12 +1336,12 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer,
 }
 
 /** Process pending TMLedgerData
-    Query the 'best' peer
+    Refill the request window of each peer which answered
 */
 void InboundLedger::runData ()
 {
-    std::shared_ptr<Peer> chosenPeer;
-    int chosenPeerCount = -1;
+    // Each peer which answered, with the most useful nodes in one answer
+    std::vector <std::pair <Peer::ptr, int>> responders;
 
     std::vector <PeerDataPairType> data;
     do
@@ -1176,26 +1358,55 @@ void InboundLedger::runData ()
             data.swap(mReceivedData);
         }
 
-        // Select the peer that gives us the most nodes that are useful,
-        // breaking ties in favor of the peer that responded first.
         for (auto& entry : data)
         {
             Peer::ptr peer = entry.first.lock();
             if (peer)
             {
                 int count = processData (peer, *(entry.second));
-                if (count > chosenPeerCount)
-                {
-                    chosenPeer = peer;
-                    chosenPeerCount = count;
-                }
+
+                auto iter = std::find_if (responders.begin (),
+                    responders.end (),
+                    [&peer](std::pair <Peer::ptr, int> const& responder)
+                    {
+                        return responder.first == peer;
+                    });
+
+                if (iter == responders.end ())
+                    responders.emplace_back (std::move (peer), count);
+                else if (count > iter->second)
+                    iter->second = count;
             }
         }
 
     } while (1);
 
-    if (chosenPeer)
-        trigger (chosenPeer);
+    // Serve the peers which deliver the most useful nodes per second
+    // first, so they are sent the nodes nearest the root. Ties go to the
+    // peer that responded first.
+    {
+        ScopedLockType sl (mLock);
+
+        auto const rate = [this](Peer::ptr const& peer)
+        {
+            auto const iter = mRequests.find (peer->id ());
+            return (iter == mRequests.end ()) ? 0.0 : iter->second.rate;
+        };
+
+        std::stable_sort (responders.begin (), responders.end (),
+            [&rate](std::pair <Peer::ptr, int> const& lhs,
+                std::pair <Peer::ptr, int> const& rhs)
+            {
+                return rate (lhs.first) > rate (rhs.first);
+            });
+    }
+
+    for (auto const& responder : responders)
+    {
+        // Peers which sent invalid data are not asked again
+        if (responder.second >= 0)
+            trigger (responder.first);
+    }
 }
 
 Json::Value InboundLedger::getJson (int)
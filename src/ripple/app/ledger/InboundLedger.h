@@ -23,6 +23,9 @@
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/overlay/PeerSet.h>
 #include <ripple/basics/CountedObject.h>
+#include <ripple/basics/Slice.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <deque>
 #include <set>
 
 namespace ripple {
@@ -113,6 +116,8 @@ public:
 private:
     void done ();
 
+    void indexHistory ();
+
     void onTimer (bool progress, ScopedLockType& peerSetLock);
 
     void newPeer (Peer::ptr const& peer)
@@ -127,18 +132,27 @@ private:
 
     int processData (std::shared_ptr<Peer> peer, protocol::TMLedgerData& data);
 
+    int getFreeRequests (Peer::ptr const& peer) const;
+    std::size_t getOutstandingRequests () const;
+    int requestNodes (protocol::TMGetLedger& tmGL,
+        std::vector<SHAMapNodeID> const& nodeIDs, int requests,
+            Peer::ptr const& peer);
+    void sendNodeRequest (protocol::TMGetLedger const& tmGL,
+        Peer::ptr const& peer);
+    void gotNodeReply (Peer::id_t peer, int useful);
+
     bool takeHeader (std::string const& data);
-    bool takeTxNode (const std::vector<SHAMapNodeID>& IDs, const std::vector<Blob>& data,
+    bool takeTxNode (const std::vector<SHAMapNodeID>& IDs, const std::vector<Slice>& data,
                      SHAMapAddNode&);
-    bool takeTxRootNode (Blob const& data, SHAMapAddNode&);
+    bool takeTxRootNode (std::string const& data, SHAMapAddNode&);
 
     // VFALCO TODO Rename to receiveAccountStateNode
     //             Don't use acronyms, but if we are going to use them at least
     //             capitalize them correctly.
     //
-    bool takeAsNode (const std::vector<SHAMapNodeID>& IDs, const std::vector<Blob>& data,
+    bool takeAsNode (const std::vector<SHAMapNodeID>& IDs, const std::vector<Slice>& data,
                      SHAMapAddNode&);
-    bool takeAsRootNode (Blob const& data, SHAMapAddNode&);
+    bool takeAsRootNode (std::string const& data, SHAMapAddNode&);
 
 private:
     Ledger::pointer    mLedger;
@@ -153,6 +167,21 @@ private:
 
     std::set <uint256> mRecentNodes;
 
+    // Node requests sent to one peer, and how quickly it answers them
+    struct PeerRequests
+    {
+        // When each request not yet answered was sent, oldest first
+        std::deque <clock_type::time_point> sent;
+
+        // Smoothed time to answer a request
+        std::chrono::milliseconds latency {0};
+
+        // Smoothed useful nodes per second of latency
+        double rate = 0;
+    };
+
+    hash_map <Peer::id_t, PeerRequests> mRequests;
+
     // Data we have received from peers
     PeerSet::LockType mReceivedDataLock;
     std::vector <PeerDataPairType> mReceivedData;
@@ -24,6 +24,7 @@
 #include <ripple/basics/DecayingSample.h>
 #include <ripple/basics/Log.h>
 #include <ripple/core/JobQueue.h>
+#include <ripple/shamap/SHAMapNodeBatch.h>
 #include <beast/cxx14/memory.h> // <memory>
 #include <beast/module/core/text/LexicalCast.h>
 
@@ -225,20 +226,34 @@ public:
     */
     void gotStaleData (std::shared_ptr<protocol::TMLedgerData> packet_ptr)
     {
+        std::vector<SHAMapNodeID> nodeIDs;
+        std::vector<Slice> nodeData;
+        Blob unpacked;
+
+        if (packet_ptr->has_packednodes () && (
+            packet_ptr->packednodes ().empty () ||
+            !unpackNodes (makeSlice (packet_ptr->packednodes ()),
+                unpacked, nodeIDs, nodeData)))
+            return;
+
+        for (int i = 0; i < packet_ptr->nodes ().size (); ++i)
+        {
+            auto const& node = packet_ptr->nodes (i);
+
+            if (!node.has_nodeid () || !node.has_nodedata () ||
+                node.nodedata ().empty ())
+                return;
+
+            nodeData.push_back (makeSlice (node.nodedata ()));
+        }
+
         const uint256 uZero;
         Serializer s;
         try
         {
-            for (int i = 0; i < packet_ptr->nodes ().size (); ++i)
+            for (auto const& data : nodeData)
             {
-                auto const& node = packet_ptr->nodes (i);
-
-                if (!node.has_nodeid () || !node.has_nodedata ())
-                    return;
-
-                SHAMapTreeNode newNode(
-                    Blob (node.nodedata().begin(), node.nodedata().end()),
-                    0, snfWIRE, uZero, false);
+                SHAMapTreeNode newNode(data, 0, snfWIRE, uZero, false);
 
                 s.erase();
                 newNode.addRaw(s, snfPREFIX);
@@ -20,6 +20,7 @@
 #include <BeastConfig.h>
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/ledger/AcceptedLedger.h>
+#include <ripple/app/ledger/BookIndex.h>
 #include <ripple/app/ledger/InboundLedgers.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/ledger/LedgerTiming.h>
@@ -39,12 +40,15 @@
 #include <ripple/core/Config.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/core/LoadFeeTrack.h>
+#include <ripple/core/ParallelFor.h>
 #include <ripple/json/to_string.h>
 #include <ripple/nodestore/Database.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <beast/module/core/text/LexicalCast.h>
 #include <beast/unit_test/suite.h>
 #include <boost/optional.hpp>
+#include <algorithm>
+#include <thread>
 
 namespace ripple {
 
@@ -370,8 +374,9 @@ bool Ledger::hasAccount (RippleAddress const& accountID) const
 
 bool Ledger::addSLE (SLE const& sle)
 {
-    SHAMapItem item (sle.getIndex(), sle.getSerializer());
-    return mAccountStateMap->addItem(item, false, false);
+    return mAccountStateMap->addGiveItem (
+        make_shamapitem (sle.getIndex (), sle.getSerializer ()),
+        false, false);
 }
 
 AccountState::pointer Ledger::getAccountState (RippleAddress const& accountID) const
@@ -396,7 +401,7 @@ AccountState::pointer Ledger::getAccountState (RippleAddress const& accountID) c
 bool Ledger::addTransaction (uint256 const& txID, const Serializer& txn)
 {
     // low-level - just add to table
-    auto item = std::make_shared<SHAMapItem> (txID, txn.peekData ());
+    auto item = make_shamapitem (txID, txn.peekData ());
 
     if (!mTransactionMap->addGiveItem (item, true, false))
     {
@@ -416,7 +421,7 @@ bool Ledger::addTransaction (
     Serializer s (txn.getDataLength () + md.getDataLength () + 16);
     s.addVL (txn.peekData ());
     s.addVL (md.peekData ());
-    auto item = std::make_shared<SHAMapItem> (txID, s.peekData ());
+    auto item = make_shamapitem (txID, s.peekData ());
 
     if (!mTransactionMap->addGiveItem (item, true, true))
     {
@@ -432,7 +437,7 @@ bool Ledger::addTransaction (
 Transaction::pointer Ledger::getTransaction (uint256 const& transID) const
 {
     SHAMapTreeNode::TNType type;
-    std::shared_ptr<SHAMapItem> item = mTransactionMap->peekItem (transID, type);
+    SHAMapItem::pointer item = mTransactionMap->peekItem (transID, type);
 
     if (!item)
         return Transaction::pointer ();
@@ -443,14 +448,22 @@ Transaction::pointer Ledger::getTransaction (uint256 const& transID) const
         return txn;
 
     if (type == SHAMapTreeNode::tnTRANSACTION_NM)
-        txn = Transaction::sharedTransaction (item->peekData (), Validate::YES);
+        txn = Transaction::sharedTransaction (
+            Blob (item->data (), item->data () + item->size ()),
+            Validate::YES);
     else if (type == SHAMapTreeNode::tnTRANSACTION_MD)
     {
         Blob txnData;
-        int txnLength;
 
-        if (!item->peekSerializer ().getVL (txnData, 0, txnLength))
+        try
+        {
+            SerialIter sit (item->slice ());
+            txnData = sit.getVL ();
+        }
+        catch (std::exception const&)
+        {
             return Transaction::pointer ();
+        }
 
         txn = Transaction::sharedTransaction (txnData, Validate::NO);
     }
@@ -468,9 +481,9 @@ Transaction::pointer Ledger::getTransaction (uint256 const& transID) const
 }
 
 STTx::pointer Ledger::getSTransaction (
-    std::shared_ptr<SHAMapItem> const& item, SHAMapTreeNode::TNType type)
+    SHAMapItem::pointer const& item, SHAMapTreeNode::TNType type)
 {
-    SerialIter sit (item->peekSerializer ());
+    SerialIter sit (item->slice ());
 
     if (type == SHAMapTreeNode::tnTRANSACTION_NM)
         return std::make_shared<STTx> (sit);
@@ -486,10 +499,10 @@ STTx::pointer Ledger::getSTransaction (
 }
 
 STTx::pointer Ledger::getSMTransaction (
-    std::shared_ptr<SHAMapItem> const& item, SHAMapTreeNode::TNType type,
+    SHAMapItem::pointer const& item, SHAMapTreeNode::TNType type,
     TransactionMetaSet::pointer& txMeta) const
 {
-    SerialIter sit (item->peekSerializer ());
+    SerialIter sit (item->slice ());
 
     if (type == SHAMapTreeNode::tnTRANSACTION_NM)
     {
@@ -515,7 +528,7 @@ bool Ledger::getTransaction (
     TransactionMetaSet::pointer& meta) const
 {
     SHAMapTreeNode::TNType type;
-    std::shared_ptr<SHAMapItem> item = mTransactionMap->peekItem (txID, type);
+    SHAMapItem::pointer item = mTransactionMap->peekItem (txID, type);
 
     if (!item)
         return false;
@@ -529,13 +542,14 @@ bool Ledger::getTransaction (
         if (!txn)
         {
             txn = Transaction::sharedTransaction (
-                item->peekData (), Validate::YES);
+                Blob (item->data (), item->data () + item->size ()),
+                Validate::YES);
         }
     }
     else if (type == SHAMapTreeNode::tnTRANSACTION_MD)
     {
         // in tree with metadata
-        SerialIter it (item->peekSerializer ());
+        SerialIter it (item->slice ());
         txn = getApp().getMasterTransaction ().fetch (txID, false);
 
         if (!txn)
@@ -560,7 +574,7 @@ bool Ledger::getTransactionMeta (
     uint256 const& txID, TransactionMetaSet::pointer& meta) const
 {
     SHAMapTreeNode::TNType type;
-    std::shared_ptr<SHAMapItem> item = mTransactionMap->peekItem (txID, type);
+    SHAMapItem::pointer item = mTransactionMap->peekItem (txID, type);
 
     if (!item)
         return false;
@@ -568,7 +582,7 @@ bool Ledger::getTransactionMeta (
     if (type != SHAMapTreeNode::tnTRANSACTION_MD)
         return false;
 
-    SerialIter it (item->peekSerializer ());
+    SerialIter it (item->slice ());
     it.getVL (); // skip transaction
     meta = std::make_shared<TransactionMetaSet> (txID, mLedgerSeq, it.getVL ());
 
@@ -578,7 +592,7 @@ bool Ledger::getTransactionMeta (
 bool Ledger::getMetaHex (uint256 const& transID, std::string& hex) const
 {
     SHAMapTreeNode::TNType type;
-    std::shared_ptr<SHAMapItem> item = mTransactionMap->peekItem (transID, type);
+    SHAMapItem::pointer item = mTransactionMap->peekItem (transID, type);
 
     if (!item)
         return false;
@@ -586,7 +600,7 @@ bool Ledger::getMetaHex (uint256 const& transID, std::string& hex) const
     if (type != SHAMapTreeNode::tnTRANSACTION_MD)
         return false;
 
-    SerialIter it (item->peekSerializer ());
+    SerialIter it (item->slice ());
     it.getVL (); // skip transaction
     hex = strHex (it.getVL ());
     return true;
@@ -650,7 +664,7 @@ bool Ledger::saveValidatedLedger (bool current)
         s.add32 (HashPrefix::ledgerMaster);
         addRaw (s);
         getApp().getNodeStore ().store (
-            hotLEDGER, std::move (s.modData ()), mHash);
+            hotLEDGER, std::move (s.modData ()), mHash, mLedgerSeq);
     }
 
     AcceptedLedger::pointer aLedger;
@@ -1085,8 +1099,9 @@ LedgerStateParms Ledger::writeBack (LedgerStateParms parms, SLE::ref entry)
         create = true;
     }
 
-    auto item = std::make_shared<SHAMapItem> (entry->getIndex ());
-    entry->add (item->peekSerializer ());
+    Serializer s;
+    entry->add (s);
+    auto item = make_shamapitem (entry->getIndex (), s);
 
     if (create)
     {
@@ -1112,19 +1127,20 @@ LedgerStateParms Ledger::writeBack (LedgerStateParms parms, SLE::ref entry)
 
 SLE::pointer Ledger::getSLE (uint256 const& uHash) const
 {
-    std::shared_ptr<SHAMapItem> node = mAccountStateMap->peekItem (uHash);
+    SHAMapItem::pointer node = mAccountStateMap->peekItem (uHash);
 
     if (!node)
         return SLE::pointer ();
 
-    return std::make_shared<SLE> (node->peekSerializer (), node->getTag ());
+    SerialIter sit (node->slice ());
+    return std::make_shared<SLE> (sit, node->getTag ());
 }
 
 SLE::pointer Ledger::getSLEi (uint256 const& uId) const
 {
     uint256 hash;
 
-    std::shared_ptr<SHAMapItem> node = mAccountStateMap->peekItem (uId, hash);
+    SHAMapItem::pointer node = mAccountStateMap->peekItem (uId, hash);
 
     if (!node)
         return SLE::pointer ();
@@ -1133,7 +1149,8 @@ SLE::pointer Ledger::getSLEi (uint256 const& uId) const
 
     if (!ret)
     {
-        ret = std::make_shared<SLE> (node->peekSerializer (), node->getTag ());
+        SerialIter sit (node->slice ());
+        ret = std::make_shared<SLE> (sit, node->getTag ());
         ret->setImmutable ();
         getApp().getSLECache ().canonicalize (hash, ret);
     }
@@ -1176,6 +1193,39 @@ bool Ledger::visitAccountItems (
     std::uint64_t const hint,
     unsigned int limit,
     std::function <bool (SLE::ref)> func) const
+{
+    return visitAccountIndexes (accountID, startAfter, hint, limit,
+        [this, &func] (uint256 const& index)
+        {
+            return func (getSLEi (index));
+        });
+}
+
+bool Ledger::visitAccountItemViews (
+    Account const& accountID,
+    uint256 const& startAfter,
+    std::uint64_t const hint,
+    unsigned int limit,
+    std::function <bool (uint256 const&, STObjectView const&)> func) const
+{
+    return visitAccountIndexes (accountID, startAfter, hint, limit,
+        [this, &func] (uint256 const& index)
+        {
+            auto const item = mAccountStateMap->peekItem (index);
+            if (!item)
+                return false;
+
+            STObjectView const view (item->slice ());
+            return func (index, view);
+        });
+}
+
+bool Ledger::visitAccountIndexes (
+    Account const& accountID,
+    uint256 const& startAfter,
+    std::uint64_t const hint,
+    unsigned int limit,
+    std::function <bool (uint256 const&)> func) const
 {
     // Visit each item in this account's owner directory
     uint256 const rootIndex (getOwnerDirIndex (accountID));
@@ -1214,7 +1264,7 @@ bool Ledger::visitAccountItems (
                     if (node == startAfter)
                         found = true;
                 }
-                else if (func (getSLEi (node)) && limit-- <= 1)
+                else if (func (node) && limit-- <= 1)
                 {
                     return found;
                 }
@@ -1239,7 +1289,7 @@ bool Ledger::visitAccountItems (
 
             for (auto const& node : ownerDir->getFieldV256 (sfIndexes))
             {
-                if (func (getSLEi (node)) && limit-- <= 1)
+                if (func (node) && limit-- <= 1)
                     return true;
             }
 
@@ -1254,9 +1304,10 @@ bool Ledger::visitAccountItems (
 }
 
 static void visitHelper (
-    std::function<void (SLE::ref)>& function, std::shared_ptr<SHAMapItem> const& item)
+    std::function<void (SLE::ref)>& function, SHAMapItem::pointer const& item)
 {
-    function (std::make_shared<SLE> (item->peekSerializer (), item->getTag ()));
+    SerialIter sit (item->slice ());
+    function (std::make_shared<SLE> (sit, item->getTag ()));
 }
 
 void Ledger::visitStateItems (std::function<void (SLE::ref)> function) const
@@ -1283,25 +1334,28 @@ void Ledger::visitStateItems (std::function<void (SLE::ref)> function) const
 
 uint256 Ledger::getFirstLedgerIndex () const
 {
-    std::shared_ptr<SHAMapItem> node = mAccountStateMap->peekFirstItem ();
+    SHAMapItem::pointer node = mAccountStateMap->peekFirstItem ();
     return node ? node->getTag () : uint256 ();
 }
 
 uint256 Ledger::getLastLedgerIndex () const
 {
-    std::shared_ptr<SHAMapItem> node = mAccountStateMap->peekLastItem ();
+    SHAMapItem::pointer node = mAccountStateMap->peekLastItem ();
     return node ? node->getTag () : uint256 ();
 }
 
 uint256 Ledger::getNextLedgerIndex (uint256 const& uHash) const
 {
-    std::shared_ptr<SHAMapItem> node = mAccountStateMap->peekNextItem (uHash);
+    SHAMapItem::pointer node = mAccountStateMap->peekNextItem (uHash);
     return node ? node->getTag () : uint256 ();
 }
 
 uint256 Ledger::getNextLedgerIndex (uint256 const& uHash, uint256 const& uEnd) const
 {
-    std::shared_ptr<SHAMapItem> node = mAccountStateMap->peekNextItem (uHash);
+    if (mImmutable && BookIndex::isBookRange (uHash, uEnd))
+        return getBookIndex ()->getNextDirectory (uHash, uEnd);
+
+    SHAMapItem::pointer node = mAccountStateMap->peekNextItem (uHash);
 
     if ((!node) || (node->getTag () > uEnd))
         return uint256 ();
@@ -1309,15 +1363,28 @@ uint256 Ledger::getNextLedgerIndex (uint256 const& uHash, uint256 const& uEnd) c
     return node->getTag ();
 }
 
+std::shared_ptr <BookIndex> Ledger::getBookIndex () const
+{
+    if (!mImmutable)
+        return nullptr;
+
+    std::lock_guard <std::mutex> lock (mBookIndexLock);
+
+    if (!mBookIndex)
+        mBookIndex = std::make_shared <BookIndex> (*this);
+
+    return mBookIndex;
+}
+
 uint256 Ledger::getPrevLedgerIndex (uint256 const& uHash) const
 {
-    std::shared_ptr<SHAMapItem> node = mAccountStateMap->peekPrevItem (uHash);
+    SHAMapItem::pointer node = mAccountStateMap->peekPrevItem (uHash);
     return node ? node->getTag () : uint256 ();
 }
 
 uint256 Ledger::getPrevLedgerIndex (uint256 const& uHash, uint256 const& uBegin) const
 {
-    std::shared_ptr<SHAMapItem> node = mAccountStateMap->peekNextItem (uHash);
+    SHAMapItem::pointer node = mAccountStateMap->peekNextItem (uHash);
 
     if ((!node) || (node->getTag () < uBegin))
         return uint256 ();
@@ -1338,7 +1405,7 @@ SLE::pointer Ledger::getASNodeI (uint256 const& nodeID, LedgerEntryType let) con
 SLE::pointer Ledger::getASNode (
     LedgerStateParms& parms, uint256 const& nodeID, LedgerEntryType let) const
 {
-    std::shared_ptr<SHAMapItem> account = mAccountStateMap->peekItem (nodeID);
+    SHAMapItem::pointer account = mAccountStateMap->peekItem (nodeID);
 
     if (!account)
     {
@@ -1355,8 +1422,8 @@ SLE::pointer Ledger::getASNode (
         return sle;
     }
 
-    SLE::pointer sle =
-        std::make_shared<SLE> (account->peekSerializer (), nodeID);
+    SerialIter sit (account->slice ());
+    SLE::pointer sle = std::make_shared<SLE> (sit, nodeID);
 
     if (sle->getType () != let)
     {
@@ -1516,10 +1583,20 @@ std::vector<uint256> Ledger::getLedgerAmendments () const
     return amendments;
 }
 
-bool Ledger::walkLedger () const
+bool Ledger::walkLedger (std::function <bool ()> const& stop) const
 {
     std::vector <SHAMapMissingNode> missingNodes1;
     std::vector <SHAMapMissingNode> missingNodes2;
+    bool finished = true;
+
+    // Walking is mostly waiting on the node store, so use every thread
+    auto const forEach = [](std::size_t n,
+        std::function <void (std::size_t)> f)
+    {
+        parallelFor (getApp().getJobQueue (), jtWALK, "Ledger::walkLedger",
+            n, std::max (1u, std::thread::hardware_concurrency ()) - 1,
+                std::move (f));
+    };
 
     if (mAccountStateMap->getHash().isZero() &&
         ! mAccountHash.isZero() &&
@@ -1529,7 +1606,8 @@ bool Ledger::walkLedger () const
     }
     else
     {
-        mAccountStateMap->walkMap (missingNodes1, 32);
+        finished = mAccountStateMap->walkMap (
+            missingNodes1, 32, forEach, stop);
     }
 
     if (ShouldLog (lsINFO, Ledger) && !missingNodes1.empty ())
@@ -1546,9 +1624,10 @@ bool Ledger::walkLedger () const
     {
         missingNodes2.emplace_back (SHAMapType::TRANSACTION, mTransHash);
     }
-    else
+    else if (finished)
     {
-        mTransactionMap->walkMap (missingNodes2, 32);
+        finished = mTransactionMap->walkMap (
+            missingNodes2, 32, forEach, stop);
     }
 
     if (ShouldLog (lsINFO, Ledger) && !missingNodes2.empty ())
@@ -1559,7 +1638,7 @@ bool Ledger::walkLedger () const
             << "First: " << missingNodes2[0];
     }
 
-    return missingNodes1.empty () && missingNodes2.empty ();
+    return finished && missingNodes1.empty () && missingNodes2.empty ();
 }
 
 bool Ledger::assertSane () const
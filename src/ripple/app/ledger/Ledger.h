@@ -25,13 +25,16 @@
 #include <ripple/app/tx/TransactionMeta.h>
 #include <ripple/app/misc/AccountState.h>
 #include <ripple/protocol/STLedgerEntry.h>
+#include <ripple/protocol/STObjectView.h>
 #include <ripple/basics/CountedObject.h>
 #include <ripple/protocol/Serializer.h>
 #include <ripple/protocol/Book.h>
+#include <mutex>
 #include <set>
 
 namespace ripple {
 
+class BookIndex;
 class Job;
 
 enum LedgerStateParms
@@ -276,9 +279,9 @@ public:
     bool getMetaHex (uint256 const& transID, std::string & hex) const;
 
     static STTx::pointer getSTransaction (
-        std::shared_ptr<SHAMapItem> const&, SHAMapTreeNode::TNType);
+        SHAMapItem::pointer const&, SHAMapTreeNode::TNType);
     STTx::pointer getSMTransaction (
-        std::shared_ptr<SHAMapItem> const&, SHAMapTreeNode::TNType,
+        SHAMapItem::pointer const&, SHAMapTreeNode::TNType,
         TransactionMetaSet::pointer & txMeta) const;
 
     // high-level functions
@@ -297,6 +300,18 @@ public:
         std::uint64_t const hint,  // Hint which page to start at
         unsigned int limit,
         std::function <bool (SLE::ref)>) const;
+
+    /** Visit entries in an account's owner directory without parsing them.
+        Each view refers to the serialized entry and is only valid for the
+        duration of the call.
+    */
+    bool visitAccountItemViews (
+        Account const& accountID,
+        uint256 const& startAfter,
+        std::uint64_t const hint,
+        unsigned int limit,
+        std::function <bool (uint256 const&, STObjectView const&)>) const;
+
     void visitStateItems (std::function<void (SLE::ref)>) const;
 
     // database functions (low-level)
@@ -321,9 +336,13 @@ public:
     // first node >hash
     uint256 getNextLedgerIndex (uint256 const& uHash) const;
 
-    // first node >hash, <end
+    // first node >hash, <=end
+    // Within a single book of an immutable ledger this uses the book index.
     uint256 getNextLedgerIndex (uint256 const& uHash, uint256 const& uEnd) const;
 
+    /** Return the order book index, or null if the ledger is mutable. */
+    std::shared_ptr <BookIndex> getBookIndex () const;
+
     // last node <hash
     uint256 getPrevLedgerIndex (uint256 const& uHash) const;
 
@@ -420,7 +439,12 @@ public:
         return mHash;
     }
 
-    bool walkLedger () const;
+    /** Check that every node of both maps is in the node store.
+
+        The maps are walked by several jobs at once. The walk is abandoned,
+        and `false` returned, if `stop` returns `true`.
+    */
+    bool walkLedger (std::function <bool ()> const& stop = nullptr) const;
     bool assertSane () const;
 
 protected:
@@ -440,6 +464,14 @@ private:
     void initializeFees ();
     void updateFees ();
 
+    // Walk the owner directory, passing the index of each entry
+    bool visitAccountIndexes (
+        Account const& accountID,
+        uint256 const& startAfter,
+        std::uint64_t const hint,
+        unsigned int limit,
+        std::function <bool (uint256 const&)>) const;
+
     // The basic Ledger structure, can be opened, closed, or synching
     uint256       mHash;
     uint256       mParentHash;
@@ -473,6 +505,10 @@ private:
     std::shared_ptr<SHAMap> mTransactionMap;
     std::shared_ptr<SHAMap> mAccountStateMap;
 
+    // Created on first use, once the ledger is immutable
+    mutable std::shared_ptr <BookIndex> mBookIndex;
+    mutable std::mutex mBookIndexLock;
+
     typedef RippleMutex StaticLockType;
     typedef std::lock_guard <StaticLockType> StaticScopedLockType;
 
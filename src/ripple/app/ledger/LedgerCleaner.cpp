@@ -304,8 +304,11 @@ public:
             doTxns = true;
         }
 
-        if (doNodes && !nodeLedger->walkLedger())
+        if (doNodes && !nodeLedger->walkLedger (
+            [this] { return this->threadShouldExit (); }))
         {
+            if (this->threadShouldExit ())
+                return false;
             m_journal.debug << "Ledger " << ledgerIndex << " is missing nodes";
             getApp().getInboundLedgers().acquire(
                 ledgerHash, ledgerIndex, InboundLedger::fcGENERIC);
@@ -330,7 +333,11 @@ public:
         LedgerIndex const& ledgerIndex,
         Ledger::pointer& referenceLedger)
     {
-        LedgerHash ledgerHash;
+        LedgerHash ledgerHash =
+            getApp().getLedgerMaster().getLedgerHashIndex().get (ledgerIndex);
+
+        if (ledgerHash.isNonZero ())
+            return ledgerHash;
 
         if (!referenceLedger || (referenceLedger->getLedgerSeq() < ledgerIndex))
         {
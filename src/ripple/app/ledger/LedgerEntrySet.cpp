@@ -41,6 +41,7 @@ void LedgerEntrySet::init (Ledger::ref ledger, uint256 const& transactionID,
                            std::uint32_t ledgerID, TransactionEngineParams params)
 {
     mEntries.clear ();
+    mBase.reset ();
     if (mDeferredCredits)
         mDeferredCredits->clear ();
     mLedger = ledger;
@@ -52,6 +53,7 @@ void LedgerEntrySet::init (Ledger::ref ledger, uint256 const& transactionID,
 void LedgerEntrySet::clear ()
 {
     mEntries.clear ();
+    mBase.reset ();
     mSet.clear ();
     if (mDeferredCredits)
         mDeferredCredits->clear ();
@@ -59,7 +61,14 @@ void LedgerEntrySet::clear ()
 
 LedgerEntrySet LedgerEntrySet::duplicate () const
 {
-    return LedgerEntrySet (mLedger, mEntries, mSet, mSeq + 1, mDeferredCredits);
+    boost::optional<DeferredCredits> credits;
+    if (mDeferredCredits)
+        credits = mDeferredCredits->checkpoint ();
+
+    LedgerEntrySet les (mLedger, pushLayer (mEntries, mBase),
+        mSet, mSeq + 1, credits);
+    les.mReads = mReads;
+    return les;
 }
 
 void LedgerEntrySet::swapWith (LedgerEntrySet& e)
@@ -67,17 +76,196 @@ void LedgerEntrySet::swapWith (LedgerEntrySet& e)
     using std::swap;
     swap (mLedger, e.mLedger);
     mEntries.swap (e.mEntries);
+    mBase.swap (e.mBase);
     mSet.swap (e.mSet);
     swap (mParams, e.mParams);
     swap (mSeq, e.mSeq);
     swap (mDeferredCredits, e.mDeferredCredits);
+    swap (mReads, e.mReads);
+}
+
+static bool isRemoved (LedgerEntrySet::Entries::value_type const& v)
+{
+    return v.second.mAction == taaNONE;
+}
+
+std::shared_ptr<LedgerEntrySet::EntryLayer const>
+LedgerEntrySet::pushLayer (
+    Entries const& entries, std::shared_ptr<EntryLayer const> const& base)
+{
+    if (entries.empty ())
+        return base;
+
+    // Order before sharing so that lookups in the layer never copy it
+    entries.begin ();
+
+    auto layer = std::make_shared<EntryLayer> ();
+    layer->entries = entries;
+    layer->next = base;
+
+    // Fold in layers that are not much larger than the new one, so the
+    // number of layers stays logarithmic in the number of entries.
+    while (layer->next &&
+        layer->next->entries.size () <= 2 * layer->entries.size ())
+    {
+        Entries merged (layer->next->entries);
+        merged.overlay (layer->entries);
+        layer->next = layer->next->next;
+
+        if (!layer->next)
+            merged.erase_if (&isRemoved);
+
+        layer->entries.swap (merged);
+    }
+
+    return layer;
+}
+
+void LedgerEntrySet::flatten () const
+{
+    if (!mBase)
+        return;
+
+    std::vector<EntryLayer const*> layers;
+    for (auto layer = mBase.get (); layer; layer = layer->next.get ())
+        layers.push_back (layer);
+
+    Entries merged (layers.back ()->entries);
+    for (auto i = layers.size () - 1; i-- > 0;)
+        merged.overlay (layers[i]->entries);
+    merged.overlay (mEntries);
+    merged.erase_if (&isRemoved);
+
+    mEntries.swap (merged);
+    mBase.reset ();
+}
+
+LedgerEntrySet::Entries::iterator
+LedgerEntrySet::findEntry (uint256 const& index)
+{
+    auto it = mEntries.find (index);
+
+    if (it != mEntries.end ())
+        return isRemoved (*it) ? mEntries.end () : it;
+
+    for (auto layer = mBase.get (); layer; layer = layer->next.get ())
+    {
+        auto const& entries = layer->entries;
+        auto const found = entries.find (index);
+
+        if (found != entries.end ())
+        {
+            if (isRemoved (*found))
+                break;
+
+            // The copy keeps the older sequence number,
+            // so the SLE is still copied before it is changed
+            return mEntries.insert (*found).first;
+        }
+    }
+
+    return mEntries.end ();
+}
+
+LedgerEntrySetEntry const*
+LedgerEntrySet::peekEntry (uint256 const& index) const
+{
+    auto find = [&index](Entries const& entries)
+        -> Entries::value_type const*
+    {
+        auto const it = entries.find (index);
+        return (it == entries.end ()) ? nullptr : &*it;
+    };
+
+    auto found = find (mEntries);
+
+    for (auto layer = mBase.get (); !found && layer; layer = layer->next.get ())
+        found = find (layer->entries);
+
+    if (!found || isRemoved (*found))
+        return nullptr;
+
+    return &found->second;
+}
+
+void LedgerEntrySet::insertEntry (
+    uint256 const& index, LedgerEntrySetEntry const& entry)
+{
+    auto const result = mEntries.insert (std::make_pair (index, entry));
+
+    // Replaces the marker of a removed entry
+    if (!result.second)
+        result.first->second = entry;
+}
+
+void LedgerEntrySet::eraseEntry (Entries::iterator it)
+{
+    uint256 const index = it->first;
+
+    for (auto layer = mBase.get (); layer; layer = layer->next.get ())
+    {
+        if (layer->entries.count (index) != 0)
+        {
+            // A layer below still has the entry, so mark it removed
+            it->second.mEntry.reset ();
+            it->second.mAction = taaNONE;
+            return;
+        }
+    }
+
+    mEntries.erase (it);
+}
+
+bool LedgerEntrySet::nextKey (uint256& key) const
+{
+    bool found = false;
+    uint256 next;
+
+    auto check = [&](Entries const& entries)
+    {
+        auto const it = entries.upper_bound (key);
+        if (it != entries.end () && (!found || it->first < next))
+        {
+            next = it->first;
+            found = true;
+        }
+    };
+
+    check (mEntries);
+    for (auto layer = mBase.get (); layer; layer = layer->next.get ())
+        check (layer->entries);
+
+    if (found)
+        key = next;
+
+    return found;
+}
+
+SLE::pointer LedgerEntrySet::readEntry (uint256 const& index, bool immutable)
+{
+    if (mReads)
+        mReads->keys.insert (index);
+
+    return immutable ? mLedger->getSLEi (index) : mLedger->getSLE (index);
+}
+
+uint256 LedgerEntrySet::readNextIndex (uint256 const& index, uint256 const* end)
+{
+    uint256 const next = end
+        ? mLedger->getNextLedgerIndex (index, *end)
+        : mLedger->getNextLedgerIndex (index);
+
+    if (mReads)
+        mReads->ranges.emplace_back (index, (end && next.isZero ()) ? *end : next);
+
+    return next;
 }
 
 // Find an entry in the set.  If it has the wrong sequence number, copy it and update the sequence number.
 // This is basically: copy-on-read.
 SLE::pointer LedgerEntrySet::getEntry (uint256 const& index, LedgerEntryAction& action)
 {
-    auto it = mEntries.find (index);
+    auto it = findEntry (index);
 
     if (it == mEntries.end ())
     {
@@ -117,7 +305,7 @@ SLE::pointer LedgerEntrySet::entryCache (LedgerEntryType letType, uint256 const&
         if (!sleEntry)
         {
             assert (action != taaDELETE);
-            sleEntry = mImmutable ? mLedger->getSLEi (index) : mLedger->getSLE (index);
+            sleEntry = readEntry (index, mImmutable);
 
             if (sleEntry)
                 entryCache (sleEntry);
@@ -133,11 +321,11 @@ void LedgerEntrySet::entryCache (SLE::ref sle)
 {
     assert (mLedger);
     assert (sle->isMutable () || mImmutable); // Don't put an immutable SLE in a mutable LES
-    auto it = mEntries.find (sle->getIndex ());
+    auto it = findEntry (sle->getIndex ());
 
     if (it == mEntries.end ())
     {
-        mEntries.insert (std::make_pair (sle->getIndex (), LedgerEntrySetEntry (sle, taaCACHED, mSeq)));
+        insertEntry (sle->getIndex (), LedgerEntrySetEntry (sle, taaCACHED, mSeq));
         return;
     }
 
@@ -158,11 +346,11 @@ void LedgerEntrySet::entryCreate (SLE::ref sle)
 {
     assert (mLedger && !mImmutable);
     assert (sle->isMutable ());
-    auto it = mEntries.find (sle->getIndex ());
+    auto it = findEntry (sle->getIndex ());
 
     if (it == mEntries.end ())
     {
-        mEntries.insert (std::make_pair (sle->getIndex (), LedgerEntrySetEntry (sle, taaCREATE, mSeq)));
+        insertEntry (sle->getIndex (), LedgerEntrySetEntry (sle, taaCREATE, mSeq));
         return;
     }
 
@@ -196,11 +384,11 @@ void LedgerEntrySet::entryModify (SLE::ref sle)
 {
     assert (sle->isMutable () && !mImmutable);
     assert (mLedger);
-    auto it = mEntries.find (sle->getIndex ());
+    auto it = findEntry (sle->getIndex ());
 
     if (it == mEntries.end ())
     {
-        mEntries.insert (std::make_pair (sle->getIndex (), LedgerEntrySetEntry (sle, taaMODIFY, mSeq)));
+        insertEntry (sle->getIndex (), LedgerEntrySetEntry (sle, taaMODIFY, mSeq));
         return;
     }
 
@@ -232,12 +420,12 @@ void LedgerEntrySet::entryDelete (SLE::ref sle)
 {
     assert (sle->isMutable () && !mImmutable);
     assert (mLedger);
-    auto it = mEntries.find (sle->getIndex ());
+    auto it = findEntry (sle->getIndex ());
 
     if (it == mEntries.end ())
     {
         assert (false); // deleting an entry not cached?
-        mEntries.insert (std::make_pair (sle->getIndex (), LedgerEntrySetEntry (sle, taaDELETE, mSeq)));
+        insertEntry (sle->getIndex (), LedgerEntrySetEntry (sle, taaDELETE, mSeq));
         return;
     }
 
@@ -254,7 +442,7 @@ void LedgerEntrySet::entryDelete (SLE::ref sle)
         break;
 
     case taaCREATE:
-        mEntries.erase (it);
+        eraseEntry (it);
         break;
 
     case taaDELETE:
@@ -271,6 +459,8 @@ Json::Value LedgerEntrySet::getJson (int) const
 
     Json::Value nodes (Json::arrayValue);
 
+    flatten ();
+
     for (auto it = mEntries.begin (), end = mEntries.end (); it != end; ++it)
     {
         Json::Value entry (Json::objectValue);
@@ -341,7 +531,7 @@ Json::Value LedgerEntrySet::getJson (int) const
 SLE::pointer LedgerEntrySet::getForMod (uint256 const& node, Ledger::ref ledger,
                                         NodeToLedgerEntry& newMods)
 {
-    auto it = mEntries.find (node);
+    auto it = findEntry (node);
 
     if (it != mEntries.end ())
     {
@@ -371,7 +561,7 @@ SLE::pointer LedgerEntrySet::getForMod (uint256 const& node, Ledger::ref ledger,
         return me->second;
     }
 
-    SLE::pointer ret = ledger->getSLE (node);
+    SLE::pointer ret = readEntry (node, false);
 
     if (ret)
         newMods.insert (std::make_pair (node, ret));
@@ -450,6 +640,8 @@ void LedgerEntrySet::calcRawMeta (Serializer& s, TER result, std::uint32_t index
     // Entries modified only as a result of building the transaction metadata
     NodeToLedgerEntry newMod;
 
+    flatten ();
+
     for (auto& it : mEntries)
     {
         auto type = &sfGeneric;
@@ -484,7 +676,7 @@ void LedgerEntrySet::calcRawMeta (Serializer& s, TER result, std::uint32_t index
         if (type == &sfGeneric)
             continue;
 
-        SLE::pointer origNode = mLedger->getSLEi (it.first);
+        SLE::pointer origNode = readEntry (it.first, true);
         SLE::pointer curNode = it.second.mEntry;
 
         if ((type == &sfModifiedNode) && (*curNode == *origNode))
@@ -981,42 +1173,48 @@ bool LedgerEntrySet::dirNext (
 }
 
 uint256 LedgerEntrySet::getNextLedgerIndex (uint256 const& uHash)
+{
+    return nextLedgerIndex (uHash, nullptr);
+}
+
+uint256 LedgerEntrySet::getNextLedgerIndex (
+    uint256 const& uHash, uint256 const& uEnd)
+{
+    return nextLedgerIndex (uHash, &uEnd);
+}
+
+uint256 LedgerEntrySet::nextLedgerIndex (
+    uint256 const& uHash, uint256 const* uEnd)
 {
     // find next node in ledger that isn't deleted by LES
     uint256 ledgerNext = uHash;
-    std::map<uint256, LedgerEntrySetEntry>::const_iterator it;
+    LedgerEntrySetEntry const* entry;
 
     do
     {
-        ledgerNext = mLedger->getNextLedgerIndex (ledgerNext);
-        it  = mEntries.find (ledgerNext);
+        ledgerNext = readNextIndex (ledgerNext, uEnd);
+        entry = peekEntry (ledgerNext);
     }
-    while ((it != mEntries.end ()) && (it->second.mAction == taaDELETE));
+    while (entry && (entry->mAction == taaDELETE));
 
     // find next node in LES that isn't deleted
-    for (it = mEntries.upper_bound (uHash); it != mEntries.end (); ++it)
+    for (uint256 next = uHash; nextKey (next); )
     {
+        if (uEnd && next > *uEnd)
+            break;
+
+        entry = peekEntry (next);
+
         // node found in LES, node found in ledger, return earliest
-        if (it->second.mAction != taaDELETE)
-            return (ledgerNext.isNonZero () && (ledgerNext < it->first)) ?
-                    ledgerNext : it->first;
+        if (entry && (entry->mAction != taaDELETE))
+            return (ledgerNext.isNonZero () && (ledgerNext < next)) ?
+                    ledgerNext : next;
     }
 
     // nothing next in LES, return next ledger node
     return ledgerNext;
 }
 
-uint256 LedgerEntrySet::getNextLedgerIndex (
-    uint256 const& uHash, uint256 const& uEnd)
-{
-    uint256 next = getNextLedgerIndex (uHash);
-
-    if (next > uEnd)
-        return uint256 ();
-
-    return next;
-}
-
 void LedgerEntrySet::incrementOwnerCount (SLE::ref sleAccount)
 {
     assert (sleAccount);
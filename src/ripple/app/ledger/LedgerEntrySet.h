@@ -23,6 +23,7 @@
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/ledger/DeferredCredits.h>
 #include <ripple/basics/CountedObject.h>
+#include <ripple/basics/FlatMap.h>
 #include <ripple/protocol/STLedgerEntry.h>
 #include <boost/optional.hpp>
 
@@ -83,6 +84,22 @@ public:
     }
 };
 
+/** The ledger state read through a LedgerEntrySet.
+
+    This is enough to tell whether a transaction applied to a snapshot of
+    the open ledger would have had the same outcome against a later version
+    of it, given the keys that were written in between.
+*/
+struct LedgerReadSet
+{
+    // Keys looked up in the ledger, whether or not they were present
+    hash_set<uint256> keys;
+
+    // Ranges (first, second] stepped over when looking for the next key
+    // in the ledger. A zero second means the search reached the end.
+    std::vector<std::pair<uint256, uint256>> ranges;
+};
+
 /** An LES is a LedgerEntrySet.
 
     It's a view into a ledger used while a transaction is processing.
@@ -107,7 +124,12 @@ public:
     {
     }
 
-    // Make a duplicate of this set.
+    /** Make a checkpoint of this set.
+        The duplicate reads our entries through a shared, immutable layer
+        and records its own changes separately, so taking a checkpoint and
+        discarding or swapping it back in costs time proportional to the
+        entries it touches rather than to the size of this set.
+    */
     LedgerEntrySet duplicate () const;
 
     // Swap the contents of two sets
@@ -134,6 +156,12 @@ public:
         ++mSeq;
     }
 
+    /** Record reads from the ledger made through this set and its duplicates. */
+    void trackReads (std::shared_ptr<LedgerReadSet> const& reads)
+    {
+        mReads = reads;
+    }
+
     void init (Ledger::ref ledger, uint256 const& transactionID,
                std::uint32_t ledgerID, TransactionEngineParams params);
 
@@ -242,36 +270,45 @@ public:
     Json::Value getJson (int) const;
     void calcRawMeta (Serializer&, TER result, std::uint32_t index);
 
+    // Entries are iterated in key order, which the metadata requires
+    typedef FlatMap<uint256, LedgerEntrySetEntry> Entries;
+
     // iterator functions
-    typedef std::map<uint256, LedgerEntrySetEntry>::iterator iterator;
-    typedef std::map<uint256, LedgerEntrySetEntry>::const_iterator const_iterator;
+    typedef Entries::iterator iterator;
+    typedef Entries::const_iterator const_iterator;
 
+    // Iterating folds any checkpoint layers into this set first
     bool empty () const
     {
+        flatten ();
         return mEntries.empty ();
     }
     const_iterator cbegin () const
     {
+        flatten ();
         return mEntries.cbegin ();
     }
     const_iterator cend () const
     {
+        flatten ();
         return mEntries.cend ();
     }
     const_iterator begin () const
     {
-        return mEntries.cbegin ();
+        return cbegin ();
     }
     const_iterator end () const
     {
-        return mEntries.cend ();
+        return cend ();
     }
     iterator begin ()
     {
+        flatten ();
         return mEntries.begin ();
     }
     iterator end ()
     {
+        flatten ();
         return mEntries.end ();
     }
 
@@ -289,8 +326,20 @@ public:
     TER transfer_xrp (Account const& from, Account const& to, STAmount const& amount);
 
 private:
+    // Entries inherited from the set this one was duplicated from. Each
+    // layer shadows the ones below it, and is never modified once shared.
+    // An entry whose action is taaNONE marks a key that was removed.
+    struct EntryLayer
+    {
+        Entries entries;
+        std::shared_ptr<EntryLayer const> next;
+    };
+
     Ledger::pointer mLedger;
-    std::map<uint256, LedgerEntrySetEntry>  mEntries; // cannot be unordered!
+
+    // Mutable so that const iteration can fold the layers in first
+    mutable Entries mEntries;
+    mutable std::shared_ptr<EntryLayer const> mBase;
     // Defers credits made to accounts until later
     boost::optional<DeferredCredits> mDeferredCredits;
 
@@ -300,14 +349,40 @@ private:
     TransactionEngineParams mParams;
     int mSeq;
     bool mImmutable;
+    std::shared_ptr<LedgerReadSet> mReads;
 
     LedgerEntrySet (
-        Ledger::ref ledger, const std::map<uint256, LedgerEntrySetEntry>& e,
+        Ledger::ref ledger, std::shared_ptr<EntryLayer const> const& base,
         const TransactionMetaSet & s, int m, boost::optional<DeferredCredits> const& ft) :
-        mLedger (ledger), mEntries (e), mDeferredCredits (ft), mSet (s), mParams (tapNONE),
+        mLedger (ledger), mBase (base), mDeferredCredits (ft), mSet (s), mParams (tapNONE),
         mSeq (m), mImmutable (false)
     {}
 
+    static std::shared_ptr<EntryLayer const> pushLayer (
+        Entries const& entries, std::shared_ptr<EntryLayer const> const& base);
+
+    void flatten () const;
+
+    // Find an entry, bringing it in from the layers below if necessary
+    Entries::iterator findEntry (uint256 const& index);
+
+    // Find an entry without modifying the set
+    LedgerEntrySetEntry const* peekEntry (uint256 const& index) const;
+
+    void insertEntry (uint256 const& index, LedgerEntrySetEntry const& entry);
+    void eraseEntry (Entries::iterator it);
+
+    // Advance to the next key present in this set or its layers
+    bool nextKey (uint256& key) const;
+
+    // Ledger reads, recorded if tracking is enabled
+    SLE::pointer readEntry (uint256 const& index, bool immutable);
+    // With an end, the ledger only looks that far, which lets an
+    // immutable ledger answer from its book index.
+    uint256 readNextIndex (uint256 const& index, uint256 const* end);
+
+    uint256 nextLedgerIndex (uint256 const& uHash, uint256 const* uEnd);
+
     SLE::pointer getForMod (
         uint256 const& node, Ledger::ref ledger,
         NodeToLedgerEntry& newMods);
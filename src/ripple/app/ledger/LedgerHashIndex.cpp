@@ -0,0 +1,263 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerHashIndex.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace ripple {
+
+// Identifies the file format, stored in record zero
+static char const hashIndexMagic[] = "rippled ledger hash index v1";
+
+// How many records to read at a time when loading
+static std::size_t const hashIndexLoadBatch = 4096;
+
+LedgerHashIndex::LedgerHashIndex (beast::Journal journal)
+    : j_ (journal)
+{
+}
+
+LedgerHashIndex::~LedgerHashIndex ()
+{
+    close ();
+}
+
+bool
+LedgerHashIndex::open (std::string const& path)
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+
+    assert (! file_.is_open ());
+
+    try
+    {
+        char header [LedgerHash::bytes] = {};
+        std::memcpy (header, hashIndexMagic, sizeof (hashIndexMagic));
+
+        if (file_.create (beast::nudb::file_mode::write, path))
+        {
+            file_.write (0, header, sizeof (header));
+            j_.info << "Created ledger hash index " << path;
+            return true;
+        }
+
+        if (! file_.open (beast::nudb::file_mode::write, path))
+            return false;
+
+        char existing [LedgerHash::bytes];
+        file_.read (0, existing, sizeof (existing));
+        if (std::memcmp (existing, header, sizeof (header)) != 0)
+        {
+            j_.warning << "Ledger hash index " << path <<
+                " has an unknown format, rebuilding";
+            file_.trunc (0);
+            file_.write (0, header, sizeof (header));
+            return true;
+        }
+
+        return load ();
+    }
+    catch (beast::nudb::file_error const& e)
+    {
+        j_.error << "Unable to open ledger hash index " << path <<
+            ": " << e.what ();
+        if (file_.is_open ())
+            file_.close ();
+        known_ = RangeSet ();
+        return false;
+    }
+}
+
+void
+LedgerHashIndex::close ()
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+
+    try
+    {
+        if (file_.is_open ())
+            file_.close ();
+    }
+    catch (beast::nudb::file_error const& e)
+    {
+        j_.warning << "Error closing ledger hash index: " << e.what ();
+    }
+}
+
+bool
+LedgerHashIndex::isOpen () const
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+    return file_.is_open ();
+}
+
+// Called with the lock held
+bool
+LedgerHashIndex::load ()
+{
+    std::size_t const records =
+        file_.actual_size () / LedgerHash::bytes;
+
+    std::vector <LedgerHash> batch (hashIndexLoadBatch);
+
+    // Collect runs of present records rather than setting each value,
+    // so loading full history stays linear in the number of gaps.
+    LedgerIndex runStart = 0;
+    bool inRun = false;
+
+    for (std::size_t first = 1; first < records; first += batch.size ())
+    {
+        std::size_t const count =
+            std::min (batch.size (), records - first);
+
+        file_.read (offset (first), batch[0].begin (),
+            count * LedgerHash::bytes);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            LedgerIndex const seq = static_cast <LedgerIndex> (first + i);
+
+            if (batch[i].isNonZero ())
+            {
+                if (! inRun)
+                {
+                    runStart = seq;
+                    inRun = true;
+                }
+            }
+            else if (inRun)
+            {
+                known_.setRange (runStart, seq - 1);
+                inRun = false;
+            }
+        }
+    }
+
+    if (inRun)
+        known_.setRange (runStart,
+            static_cast <LedgerIndex> (records - 1));
+
+    j_.info << "Ledger hash index has " << known_.toString ();
+    return true;
+}
+
+void
+LedgerHashIndex::insert (LedgerIndex seq, LedgerHash const& hash)
+{
+    if (seq == 0 || hash.isZero ())
+        return;
+
+    std::lock_guard <std::mutex> sl (mutex_);
+
+    if (! file_.is_open ())
+        return;
+
+    try
+    {
+        file_.write (offset (seq), hash.begin (), LedgerHash::bytes);
+        known_.setValue (seq);
+    }
+    catch (beast::nudb::file_error const& e)
+    {
+        j_.warning << "Unable to store hash of ledger " << seq <<
+            ": " << e.what ();
+    }
+}
+
+void
+LedgerHashIndex::insert (
+    std::vector <std::pair <LedgerIndex, LedgerHash>> const& hashes)
+{
+    for (auto const& h : hashes)
+    {
+        if (! has (h.first))
+            insert (h.first, h.second);
+    }
+}
+
+void
+LedgerHashIndex::erase (LedgerIndex seq)
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+
+    if (! file_.is_open () || ! known_.hasValue (seq))
+        return;
+
+    try
+    {
+        LedgerHash const zero;
+        file_.write (offset (seq), zero.begin (), LedgerHash::bytes);
+        known_.clearValue (seq);
+    }
+    catch (beast::nudb::file_error const& e)
+    {
+        j_.warning << "Unable to erase hash of ledger " << seq <<
+            ": " << e.what ();
+    }
+}
+
+LedgerHash
+LedgerHashIndex::get (LedgerIndex seq) const
+{
+    LedgerHash hash;
+
+    std::lock_guard <std::mutex> sl (mutex_);
+
+    if (! file_.is_open () || ! known_.hasValue (seq))
+        return hash;
+
+    try
+    {
+        file_.read (offset (seq), hash.begin (), LedgerHash::bytes);
+    }
+    catch (beast::nudb::file_error const& e)
+    {
+        j_.warning << "Unable to read hash of ledger " << seq <<
+            ": " << e.what ();
+        hash.zero ();
+    }
+
+    return hash;
+}
+
+bool
+LedgerHashIndex::has (LedgerIndex seq) const
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+    return known_.hasValue (seq);
+}
+
+LedgerIndex
+LedgerHashIndex::prevMissing (LedgerIndex seq) const
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+    return known_.prevMissing (seq);
+}
+
+std::string
+LedgerHashIndex::getKnown () const
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+    return known_.toString ();
+}
+
+} // ripple
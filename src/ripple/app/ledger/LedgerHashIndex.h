@@ -0,0 +1,107 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_LEDGERHASHINDEX_H_INCLUDED
+#define RIPPLE_APP_LEDGER_LEDGERHASHINDEX_H_INCLUDED
+
+#include <ripple/basics/RangeSet.h>
+#include <ripple/protocol/Protocol.h>
+#include <ripple/protocol/RippleLedgerHash.h>
+#include <beast/nudb/file.h>
+#include <beast/utility/Journal.h>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+/** Persistent, dense map of validated ledger sequence numbers to hashes.
+
+    The index is a flat file of 32-byte records where the record for a
+    ledger lives at offset `seq * 32`, so a lookup is one positional read
+    that is normally satisfied from the operating system's page cache.
+    Record zero holds a small header; ledger zero never exists.
+
+    Only hashes from the fully validated chain may be inserted. An all-zero
+    record means the hash is unknown. The set of known sequences is kept in
+    memory so callers can find gaps without touching the file.
+
+    All member functions are thread safe.
+*/
+class LedgerHashIndex
+{
+public:
+    explicit
+    LedgerHashIndex (beast::Journal journal);
+
+    ~LedgerHashIndex ();
+
+    LedgerHashIndex (LedgerHashIndex const&) = delete;
+    LedgerHashIndex& operator= (LedgerHashIndex const&) = delete;
+
+    /** Open or create the index file and load the set of known sequences.
+        @return `true` if the index is usable.
+    */
+    bool open (std::string const& path);
+
+    void close ();
+
+    bool isOpen () const;
+
+    /** Record the hash of a validated ledger. */
+    void insert (LedgerIndex seq, LedgerHash const& hash);
+
+    /** Record a batch of validated hashes, such as a ledger's skip list. */
+    void insert (std::vector <std::pair <LedgerIndex, LedgerHash>> const& hashes);
+
+    /** Forget the hash of a ledger, for example after a mismatch. */
+    void erase (LedgerIndex seq);
+
+    /** Return the hash of the specified ledger, or zero if not known. */
+    LedgerHash get (LedgerIndex seq) const;
+
+    /** Return `true` if the hash of the specified ledger is known. */
+    bool has (LedgerIndex seq) const;
+
+    /** Return the largest sequence less than `seq` whose hash is not known.
+        @return RangeSet::absent if there is no such sequence.
+    */
+    LedgerIndex prevMissing (LedgerIndex seq) const;
+
+    /** Return the known sequences as a human readable range list. */
+    std::string getKnown () const;
+
+private:
+    bool load ();
+
+    static std::size_t offset (LedgerIndex seq)
+    {
+        return static_cast <std::size_t> (seq) * LedgerHash::bytes;
+    }
+
+    beast::Journal j_;
+    mutable std::mutex mutex_;
+    mutable beast::nudb::native_file file_;
+    RangeSet known_;
+};
+
+} // ripple
+
+#endif
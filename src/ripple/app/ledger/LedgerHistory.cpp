@@ -310,15 +310,15 @@ void LedgerHistory::handleMismatch (LedgerHash const& built, LedgerHash const& v
     std::vector <SHAMapItemInfo> builtTx, validTx;
     // Get built ledger hashes and metadata
     builtLedger->peekTransactionMap()->visitLeaves(
-        [&builtTx](std::shared_ptr<SHAMapItem> const& item)
+        [&builtTx](SHAMapItem::pointer const& item)
         {
-            builtTx.push_back({item->getTag(), item->peekData()});
+            builtTx.push_back({item->getTag(), Blob (item->data(), item->data() + item->size())});
         });
     // Get valid ledger hashes and metadata
     validLedger->peekTransactionMap()->visitLeaves(
-        [&validTx](std::shared_ptr<SHAMapItem> const& item)
+        [&validTx](SHAMapItem::pointer const& item)
         {
-            validTx.push_back({item->getTag(), item->peekData()});
+            validTx.push_back({item->getTag(), Blob (item->data(), item->data() + item->size())});
         });
 
     // Sort both by hash
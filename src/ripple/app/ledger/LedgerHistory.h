@@ -49,6 +49,16 @@ public:
         return m_ledgers_by_hash.getHitRate ();
     }
 
+    int getCacheSize ()
+    {
+        return m_ledgers_by_hash.getCacheSize ();
+    }
+
+    std::pair <std::uint64_t, std::uint64_t> getCacheHitsAndMisses ()
+    {
+        return m_ledgers_by_hash.getHitsAndMisses ();
+    }
+
     /** Get a ledger given its squence number
         @param ledgerIndex The sequence number of the desired ledger
     */
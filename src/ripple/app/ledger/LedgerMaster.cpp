@@ -38,9 +38,12 @@
 #include <ripple/overlay/Overlay.h>
 #include <ripple/overlay/Peer.h>
 #include <ripple/validators/Manager.h>
+#include <boost/filesystem.hpp>
 #include <algorithm>
 #include <cassert>
 #include <beast/cxx14/memory.h> // <memory>
+#include <deque>
+#include <set>
 #include <vector>
 
 namespace ripple {
@@ -48,6 +51,17 @@ namespace ripple {
 #define MIN_VALIDATION_RATIO    150     // 150/256ths of validations of previous ledger
 #define MAX_LEDGER_GAP          100     // Don't catch up more than 100 ledgers  (cannot exceed 256)
 #define MAX_LEDGER_AGE_ACQUIRE  60      // Don't acquire history if ledger is too old
+#define MAX_OPEN_WRITES         256     // Open ledger writes kept to validate speculation
+
+class LedgerMaster::Speculation
+{
+public:
+    Ledger::pointer snapshot;
+    TransactionEngine engine;
+    std::shared_ptr<LedgerReadSet> reads;
+    TER result = tesSUCCESS;
+    bool didApply = false;
+};
 
 class LedgerMasterImp
     : public LedgerMaster
@@ -77,8 +91,28 @@ public:
     LockType mCompleteLock;
     RangeSet mCompleteLedgers;
 
+    // Hashes of validated ledgers by sequence, persisted across restarts
+    LedgerHashIndex mHashIndex;
+
     std::unique_ptr <LedgerCleaner> mLedgerCleaner;
 
+    // What each transaction recently applied to the open ledger wrote,
+    // oldest first, so speculative results can be checked at commit time
+    struct OpenWrite
+    {
+        Ledger::pointer before;
+        Ledger::pointer after;
+        uint256 txID;
+        hash_set<uint256> keys;
+        std::set<uint256> created;      // Created or deleted
+    };
+
+    bool const mOptimisticApply;
+    std::deque<OpenWrite> mOpenWrites;
+
+    // What was applied to the current ledger, for reuse when it closes
+    OpenLedgerRecord::pointer mOpenRecord;
+
     int                         mMinValidations;    // The minimum validations to publish a ledger
     uint256                     mLastValidateHash;
     std::uint32_t               mLastValidateSeq;
@@ -116,8 +150,10 @@ public:
         , m_journal (journal)
         , mLedgerHistory (collector)
         , mHeldTransactions (uint256 ())
+        , mHashIndex (deprecatedLogs().journal("LedgerHashIndex"))
         , mLedgerCleaner (make_LedgerCleaner (
             *this, deprecatedLogs().journal("LedgerCleaner")))
+        , mOptimisticApply (config.OPTIMISTIC_APPLY)
         , mMinValidations (0)
         , mLastValidateSeq (0)
         , mAdvanceThread (false)
@@ -135,6 +171,13 @@ public:
         , ledger_history_ (config.LEDGER_HISTORY)
         , ledger_fetch_size_ (config.getSize (siLedgerFetch))
     {
+        // Standalone ledgers are not part of any network's history
+        auto const dbPath = config.legacy ("database_path");
+        if (! standalone_ && ! dbPath.empty ())
+        {
+            mHashIndex.open ((boost::filesystem::path (dbPath) /
+                "ledger_hashes.idx").string ());
+        }
     }
 
     ~LedgerMasterImp ()
@@ -227,6 +270,7 @@ public:
         }
 
         mValidLedger.set (l);
+        indexLedgerHashes (l);
         mValidLedgerSign = signTime;
         mValidLedgerSeq = l->getLedgerSeq();
         getApp().getOPs().updateLocalTx (l);
@@ -239,6 +283,35 @@ public:
     #endif
     }
 
+    /** Record the hashes a validated ledger vouches for
+        A validated ledger knows its own hash and its parent's. If the index
+        has a gap behind it, the ledger's skip list fills up to 256 more.
+    */
+    void indexLedgerHashes (Ledger::ref ledger)
+    {
+        std::uint32_t const seq = ledger->getLedgerSeq ();
+
+        mHashIndex.insert (seq, ledger->getHash ());
+
+        if (seq < 2 || mHashIndex.has (seq - 1))
+            return;
+
+        mHashIndex.insert (seq - 1, ledger->getParentHash ());
+
+        if (seq > 2 && ! mHashIndex.has (seq - 2))
+        {
+            try
+            {
+                mHashIndex.insert (ledger->getLedgerHashes ());
+            }
+            catch (SHAMapMissingNode const&)
+            {
+                // The skip list is not available locally, the gap will be
+                // filled as earlier ledgers are validated or acquired
+            }
+        }
+    }
+
     void setPubLedger(Ledger::ref l)
     {
         mPubLedger = l;
@@ -271,6 +344,7 @@ public:
             }
 
             mCurrentLedger.set (newLedger);
+            mOpenRecord.reset ();
         }
 
         if (standalone_)
@@ -282,7 +356,8 @@ public:
             checkAccept(newLedger);
     }
 
-    void pushLedger (Ledger::pointer newLCL, Ledger::pointer newOL)
+    void pushLedger (Ledger::pointer newLCL, Ledger::pointer newOL,
+        OpenLedgerRecord::pointer const& record)
     {
         assert (newLCL->isClosed () && newLCL->isAccepted ());
         assert (!newOL->isClosed () && !newOL->isAccepted ());
@@ -292,6 +367,11 @@ public:
             ScopedLockType ml (m_mutex);
             mClosedLedger.set (newLCL);
             mCurrentLedger.set (newOL);
+
+            // The holder may have made a copy
+            mOpenRecord = record;
+            if (mOpenRecord)
+                mOpenRecord->setOpen (mCurrentLedger.get ());
         }
 
         if (standalone_)
@@ -317,6 +397,7 @@ public:
 
             mCurrentLedger.set (current);
             mClosedLedger.set (lastClosed);
+            mOpenRecord.reset ();
 
             assert (!current->isClosed ());
         }
@@ -352,6 +433,9 @@ public:
         // Start with a mutable snapshot of the open ledger
         TransactionEngine engine (mCurrentLedger.getMutable ());
 
+        if (mOpenRecord && !mOpenRecord->describes (mCurrentLedger.get ()))
+            mOpenRecord.reset ();
+
         int recovers = 0;
 
         for (auto const& it : mHeldTransactions)
@@ -363,7 +447,9 @@ public:
                 if (getApp().getHashRouter ().addSuppressionFlags (it.first.getTXID (), SF_SIGGOOD))
                     tepFlags = static_cast<TransactionEngineParams> (tepFlags | tapNO_CHECK_SIGN);
 
-                auto ret = engine.applyTransaction (*it.second, tepFlags);
+                auto ret = mOpenRecord
+                    ? mOpenRecord->apply (engine, *it.second, tepFlags)
+                    : engine.applyTransaction (*it.second, tepFlags);
 
                 if (ret.second)
                     ++recovers;
@@ -384,6 +470,9 @@ public:
         // VFALCO TODO recreate the CanonicalTxSet object instead of resetting it
         mHeldTransactions.reset (engine.getLedger()->getHash ());
         mCurrentLedger.set (engine.getLedger ());
+
+        if (mOpenRecord)
+            mOpenRecord->setOpen (mCurrentLedger.get ());
     }
 
     LedgerIndex getBuildingLedger ()
@@ -398,27 +487,208 @@ public:
     }
 
     TER doTransaction (STTx::ref txn, TransactionEngineParams params, bool& didApply)
+    {
+        return doTransaction (txn, params, didApply, nullptr);
+    }
+
+    std::shared_ptr<Speculation> speculate (
+        STTx::ref txn, TransactionEngineParams params)
+    {
+        if (!mOptimisticApply)
+            return nullptr;
+
+        auto speculation = std::make_shared<Speculation> ();
+        speculation->snapshot = mCurrentLedger.get ();
+
+        if (!speculation->snapshot)
+            return nullptr;
+
+        speculation->reads = std::make_shared<LedgerReadSet> ();
+
+        TransactionEngine& engine = speculation->engine;
+        engine.setLedger (speculation->snapshot);
+        engine.view ().trackReads (speculation->reads);
+
+        try
+        {
+            std::tie (speculation->result, speculation->didApply) =
+                engine.calculate (*txn, params);
+        }
+        catch (...)
+        {
+            // Applying the transaction under the lock reports the error
+            return nullptr;
+        }
+
+        return speculation;
+    }
+
+    TER doTransaction (STTx::ref txn, TransactionEngineParams params,
+        bool& didApply, std::shared_ptr<Speculation> const& speculation)
     {
         Ledger::pointer ledger;
         TransactionEngine engine;
+        TransactionEngine* applied = &engine;
+        std::shared_ptr<LedgerReadSet> reads;
         TER result;
         didApply = false;
 
         {
             ScopedLockType sl (m_mutex);
-            ledger = mCurrentLedger.getMutable ();
-            engine.setLedger (ledger);
-            std::tie(result, didApply) = engine.applyTransaction (*txn, params);
+            Ledger::pointer const current = mCurrentLedger.get ();
+            if (current)
+                ledger = std::make_shared <Ledger> (*current, true);
+
+            if (speculation && speculationValid (*speculation,
+                current, txn->getTransactionID ()))
+            {
+                applied = &speculation->engine;
+                reads = speculation->reads;
+                result = speculation->result;
+                didApply = speculation->didApply;
+
+                if (didApply)
+                {
+                    applied->setLedger (ledger);
+                    applied->commit (*txn, params);
+                }
+            }
+            else
+            {
+                if (speculation)
+                {
+                    WriteLog (lsDEBUG, LedgerMaster) <<
+                        "Speculative result is stale, reapplying " <<
+                        txn->getTransactionID ();
+                }
+
+                if (mOpenRecord)
+                {
+                    reads = std::make_shared<LedgerReadSet> ();
+                    engine.view ().trackReads (reads);
+                }
+
+                engine.setLedger (ledger);
+                std::tie (result, didApply) = engine.calculate (*txn, params);
+
+                if (didApply)
+                    engine.commit (*txn, params);
+            }
+
+            if (didApply)
+            {
+                ledger->setImmutable (); // So the next line doesn't have to copy
+
+                if (mOptimisticApply)
+                    recordOpenWrite (current, ledger,
+                        txn->getTransactionID (), applied->view ());
+
+                if (mOpenRecord && reads && mOpenRecord->describes (current))
+                {
+                    mOpenRecord->insert (txn->getTransactionID (), result,
+                        applied->view (), reads);
+                    mOpenRecord->setOpen (ledger);
+                }
+                else
+                {
+                    mOpenRecord.reset ();
+                }
+
+                mCurrentLedger.set (ledger);
+            }
+
+            applied->view ().clear ();
         }
         if (didApply)
-        {
-            ledger->setImmutable (); // So the next line doesn't have to copy
-            mCurrentLedger.set (ledger);
             getApp().getOPs ().pubProposedTransaction (ledger, txn, result);
-        }
         return result;
     }
 
+    // Called with the lock held
+    void recordOpenWrite (Ledger::ref before, Ledger::ref after,
+        uint256 const& txID, LedgerEntrySet& view)
+    {
+        OpenWrite write;
+        write.before = before;
+        write.after = after;
+        write.txID = txID;
+
+        for (auto const& it : view)
+        {
+            switch (it.second.mAction)
+            {
+            case taaCREATE:
+            case taaDELETE:
+                write.created.insert (it.first);
+                // Fall through
+
+            case taaMODIFY:
+                write.keys.insert (it.first);
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        mOpenWrites.push_back (std::move (write));
+
+        if (mOpenWrites.size () > MAX_OPEN_WRITES)
+            mOpenWrites.pop_front ();
+    }
+
+    // Called with the lock held. Walks back from the current open ledger to
+    // the snapshot the speculation used. The result still holds if nothing
+    // written in between was read, which is true only if every step in
+    // between was recorded.
+    bool speculationValid (Speculation const& speculation,
+        Ledger::ref current, uint256 const& txID)
+    {
+        Ledger::pointer ledger = current;
+        auto it = mOpenWrites.rbegin ();
+
+        while (ledger != speculation.snapshot)
+        {
+            if (it == mOpenWrites.rend () || it->after != ledger)
+                return false;
+
+            if (conflicts (*it, *speculation.reads, txID))
+                return false;
+
+            ledger = it->before;
+            ++it;
+        }
+
+        return true;
+    }
+
+    static bool conflicts (OpenWrite const& write,
+        LedgerReadSet const& reads, uint256 const& txID)
+    {
+        if (write.txID == txID)
+            return true;
+
+        for (auto const& key : write.keys)
+        {
+            if (reads.keys.count (key) != 0)
+                return true;
+        }
+
+        if (write.created.empty ())
+            return false;
+
+        for (auto const& range : reads.ranges)
+        {
+            auto const next = write.created.upper_bound (range.first);
+
+            if (next != write.created.end () &&
+                    (range.second.isZero () || *next <= range.second))
+                return true;
+        }
+
+        return false;
+    }
+
     bool haveLedgerRange (std::uint32_t from, std::uint32_t to)
     {
         ScopedLockType sl (mCompleteLock);
@@ -646,6 +916,9 @@ public:
 
                 if (hash.isNonZero ())
                 {
+                    // The new ledger is authoritative for its ancestors
+                    mHashIndex.insert (lSeq, hash);
+
                     // try to close the seam
                     Ledger::pointer otherLedger = getLedgerBySeq (lSeq);
 
@@ -680,6 +953,8 @@ public:
         if (isCurrent)
             mLedgerHistory.addLedger(ledger, true);
 
+        indexLedgerHashes (ledger);
+
         ledger->pendSaveValidated (isSynchronous, isCurrent);
 
         {
@@ -958,9 +1233,9 @@ public:
     LedgerHash getLedgerHashForHistory (LedgerIndex index)
     {
         // Try to get the hash of a ledger we need to fetch for history
-        uint256 ret;
+        uint256 ret = mHashIndex.get (index);
 
-        if (mHistLedger && (mHistLedger->getLedgerSeq() >= index))
+        if (ret.isZero () && mHistLedger && (mHistLedger->getLedgerSeq() >= index))
         {
             ret = mHistLedger->getLedgerHash (index);
             if (ret.isZero())
@@ -1213,7 +1488,11 @@ public:
     {
         assert(desiredSeq < knownGoodLedger->getLedgerSeq());
 
-        uint256 hash = knownGoodLedger->getLedgerHash(desiredSeq);
+        uint256 hash = mHashIndex.get (desiredSeq);
+        if (hash.isNonZero ())
+            return hash;
+
+        hash = knownGoodLedger->getLedgerHash(desiredSeq);
 
         // Not directly in the given ledger
         if (hash.isZero ())
@@ -1348,6 +1627,12 @@ public:
         return mCurrentLedger.get ();
     }
 
+    OpenLedgerRecord::pointer getOpenRecord ()
+    {
+        ScopedLockType ml (m_mutex);
+        return mOpenRecord;
+    }
+
     // The finalized ledger is the last closed/accepted ledger
     Ledger::pointer getClosedLedger ()
     {
@@ -1385,7 +1670,12 @@ public:
 
     uint256 getHashBySeq (std::uint32_t index)
     {
-        uint256 hash = mLedgerHistory.getLedgerHash (index);
+        uint256 hash = mHashIndex.get (index);
+
+        if (hash.isNonZero ())
+            return hash;
+
+        hash = mLedgerHistory.getLedgerHash (index);
 
         if (hash.isNonZero ())
             return hash;
@@ -1417,6 +1707,11 @@ public:
         if (!referenceLedger || (referenceLedger->getLedgerSeq() < index))
             return ledgerHash; // Nothing we can do. No validated ledger.
 
+        // The index only holds hashes from the validated chain
+        ledgerHash = mHashIndex.get (index);
+        if (ledgerHash.isNonZero ())
+            return ledgerHash;
+
         // See if the hash for the ledger we need is in the reference ledger
         ledgerHash = referenceLedger->getLedgerHash (index);
         if (ledgerHash.isZero())
@@ -1441,9 +1736,18 @@ public:
                 }
             }
         }
+
+        if (ledgerHash.isNonZero () && referenceLedger->isValidated ())
+            mHashIndex.insert (index, ledgerHash);
+
         return ledgerHash;
     }
 
+    LedgerHashIndex& getLedgerHashIndex () override
+    {
+        return mHashIndex;
+    }
+
     Ledger::pointer getLedgerBySeq (std::uint32_t index)
     {
         if (index <= mValidLedgerSeq)
@@ -1529,6 +1833,16 @@ public:
         return mLedgerHistory.getCacheHitRate ();
     }
 
+    int getCacheSize ()
+    {
+        return mLedgerHistory.getCacheSize ();
+    }
+
+    std::pair <std::uint64_t, std::uint64_t> getCacheHitsAndMisses ()
+    {
+        return mLedgerHistory.getCacheHitsAndMisses ();
+    }
+
     void addValidateCallback (callback& c)
     {
         mOnValidate.push_back (c);
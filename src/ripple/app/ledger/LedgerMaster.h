@@ -21,6 +21,8 @@
 #define RIPPLE_APP_LEDGER_LEDGERMASTER_H_INCLUDED
 
 #include <ripple/app/ledger/LedgerEntrySet.h>
+#include <ripple/app/ledger/LedgerHashIndex.h>
+#include <ripple/app/ledger/OpenLedgerRecord.h>
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/protocol/RippleLedgerHash.h>
 #include <ripple/core/Config.h>
@@ -62,6 +64,9 @@ public:
     // The current ledger is the ledger we believe new transactions should go in
     virtual Ledger::pointer getCurrentLedger () = 0;
 
+    // What was applied to the current ledger, if all of it was recorded
+    virtual OpenLedgerRecord::pointer getOpenRecord () = 0;
+
     // The finalized ledger is the last closed/accepted ledger
     virtual Ledger::pointer getClosedLedger () = 0;
 
@@ -79,6 +84,26 @@ public:
         STTx::ref txn,
             TransactionEngineParams params, bool& didApply) = 0;
 
+    /** A transaction applied to a snapshot of the open ledger. */
+    class Speculation;
+
+    /** Apply a transaction to a snapshot of the open ledger, without
+        changing it and without holding any locks.
+        @return The result to pass to doTransaction, or null if
+                optimistic application is disabled.
+    */
+    virtual std::shared_ptr<Speculation> speculate (
+        STTx::ref txn, TransactionEngineParams params) = 0;
+
+    /** Apply a transaction to the open ledger, reusing the result of
+        speculate() if nothing it read has changed since. Otherwise the
+        transaction is applied again, so the outcome is always the same as
+        applying the transactions one after the other in commit order.
+    */
+    virtual TER doTransaction (
+        STTx::ref txn, TransactionEngineParams params, bool& didApply,
+            std::shared_ptr<Speculation> const& speculation) = 0;
+
     virtual int getMinValidations () = 0;
 
     virtual void setMinValidations (int v) = 0;
@@ -86,7 +111,13 @@ public:
     virtual std::uint32_t getEarliestFetch () = 0;
 
     virtual void pushLedger (Ledger::pointer newLedger) = 0;
-    virtual void pushLedger (Ledger::pointer newLCL, Ledger::pointer newOL) = 0;
+    /** Install a new last closed ledger and the open ledger built on it.
+        @param record If set, the record of what was applied to newOL.
+                      Transactions applied to the open ledger are added to
+                      it until the next close.
+    */
+    virtual void pushLedger (Ledger::pointer newLCL, Ledger::pointer newOL,
+        OpenLedgerRecord::pointer const& record) = 0;
     virtual bool storeLedger (Ledger::pointer) = 0;
     virtual void forceValid (Ledger::pointer) = 0;
 
@@ -109,6 +140,10 @@ public:
     virtual uint256 walkHashBySeq (std::uint32_t index) = 0;
     virtual uint256 walkHashBySeq (std::uint32_t index, Ledger::ref referenceLedger) = 0;
 
+    /** The persistent index of validated ledger hashes by sequence
+    */
+    virtual LedgerHashIndex& getLedgerHashIndex () = 0;
+
     virtual Ledger::pointer getLedgerBySeq (std::uint32_t index) = 0;
 
     virtual Ledger::pointer getLedgerByHash (uint256 const& hash) = 0;
@@ -129,6 +164,9 @@ public:
     virtual void tune (int size, int age) = 0;
     virtual void sweep () = 0;
     virtual float getCacheHitRate () = 0;
+    virtual int getCacheSize () = 0;
+    virtual std::pair <std::uint64_t, std::uint64_t>
+        getCacheHitsAndMisses () = 0;
     virtual void addValidateCallback (callback& c) = 0;
 
     virtual void checkAccept (Ledger::ref ledger) = 0;
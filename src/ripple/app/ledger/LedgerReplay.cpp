@@ -0,0 +1,252 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerReplay.h>
+#include <ripple/app/tx/TransactionEngine.h>
+#include <ripple/basics/CountedObject.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+void
+LedgerReplayStats::Histogram::add (std::chrono::nanoseconds elapsed)
+{
+    auto micros = std::chrono::duration_cast <
+        std::chrono::microseconds> (elapsed).count ();
+
+    // Bucket 0 holds latencies under a microsecond and bucket n those
+    // under 2^n microseconds. The last bucket holds everything longer.
+    std::size_t bucket = 0;
+    while (micros > 0 && bucket + 1 < buckets_.size ())
+    {
+        micros >>= 1;
+        ++bucket;
+    }
+
+    ++buckets_[bucket];
+    ++count_;
+    total_ += elapsed;
+}
+
+Json::Value
+LedgerReplayStats::Histogram::getJson () const
+{
+    Json::Value ret (Json::objectValue);
+
+    ret["count"] = static_cast <Json::UInt> (count_);
+
+    if (count_ != 0)
+        ret["mean_us"] = static_cast <double> (std::chrono::duration_cast <
+            std::chrono::microseconds> (total_).count ()) / count_;
+
+    Json::Value& buckets = (ret["buckets_us"] = Json::objectValue);
+
+    for (std::size_t i = 0; i < buckets_.size (); ++i)
+    {
+        if (buckets_[i] == 0)
+            continue;
+
+        std::string const bound = (i + 1 < buckets_.size ())
+            ? "<" + std::to_string (std::uint64_t (1) << i)
+            : ">=" + std::to_string (std::uint64_t (1) << (i - 1));
+
+        buckets[bound] = static_cast <Json::UInt> (buckets_[i]);
+    }
+
+    return ret;
+}
+
+Json::Value
+LedgerReplayStats::getJson () const
+{
+    using namespace std::chrono;
+
+    Json::Value ret (Json::objectValue);
+
+    ret["ledgers"] = static_cast <Json::UInt> (ledgers);
+    ret["transactions"] = static_cast <Json::UInt> (transactions);
+    ret["mismatches"] = static_cast <Json::UInt> (mismatches);
+    ret["apply_ms"] = static_cast <Json::UInt> (
+        duration_cast <milliseconds> (applyTime).count ());
+    ret["hash_ms"] = static_cast <Json::UInt> (
+        duration_cast <milliseconds> (hashTime).count ());
+
+    if (applyTime.count () != 0)
+        ret["tx_per_sec"] = transactions /
+            duration_cast <duration <double>> (applyTime).count ();
+
+    Json::Value& types = (ret["latency"] = Json::objectValue);
+
+    for (auto const& entry : latency)
+    {
+        auto const item = TxFormats::getInstance ().findByType (entry.first);
+
+        types[item ? item->getName () : std::to_string (entry.first)] =
+            entry.second.getJson ();
+    }
+
+    Json::Value& objects = (ret["allocations"] = Json::objectValue);
+
+    for (auto const& entry : allocations)
+        objects[entry.first] = static_cast <Json::UInt> (entry.second);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+
+bool
+replayLedger (Ledger::ref parent, Ledger::ref ledger,
+    LedgerReplayStats& stats, beast::Journal journal)
+{
+    using clock_type = std::chrono::steady_clock;
+
+    // Recover the order in which the transactions were applied
+    std::vector <std::pair <std::uint32_t, STTx::pointer>> txns;
+    {
+        std::shared_ptr <SHAMap> const& txMap = ledger->peekTransactionMap ();
+        SHAMapTreeNode::TNType type;
+
+        for (auto item = txMap->peekFirstItem (type); item;
+            item = txMap->peekNextItem (item->getTag (), type))
+        {
+            TransactionMetaSet::pointer meta;
+            auto txn = ledger->getSMTransaction (item, type, meta);
+
+            if (!txn || !meta)
+            {
+                journal.warning << "Ledger " << ledger->getLedgerSeq () <<
+                    " has no metadata for " << item->getTag ();
+                return false;
+            }
+
+            txns.emplace_back (meta->getIndex (), std::move (txn));
+        }
+    }
+
+    std::sort (txns.begin (), txns.end (),
+        [](std::pair <std::uint32_t, STTx::pointer> const& lhs,
+           std::pair <std::uint32_t, STTx::pointer> const& rhs)
+        {
+            return lhs.first < rhs.first;
+        });
+
+    auto const before = CountedObjects::getInstance ().getTotals ();
+
+    auto replay = std::make_shared <Ledger> (false, *parent);
+    TransactionEngine engine (replay);
+
+    for (auto const& txn : txns)
+    {
+        auto const start = clock_type::now ();
+        auto const result = engine.applyTransaction (
+            *txn.second, tapNO_CHECK_SIGN);
+        auto const elapsed = clock_type::now () - start;
+
+        stats.applyTime += elapsed;
+        stats.latency[txn.second->getTxnType ()].add (elapsed);
+
+        if (!result.second)
+            journal.warning << "Ledger " << ledger->getLedgerSeq () <<
+                " replay did not apply " << txn.second->getTransactionID () <<
+                ": " << transToken (result.first);
+    }
+
+    replay->updateSkipList ();
+
+    // The trees are hashed lazily, so this is where the hashing cost is paid
+    auto const start = clock_type::now ();
+    uint256 const accountHash = replay->peekAccountStateMap ()->getHash ();
+    uint256 const transHash = replay->peekTransactionMap ()->getHash ();
+    stats.hashTime += clock_type::now () - start;
+
+    auto const after = CountedObjects::getInstance ().getTotals ();
+
+    // Both lists are built by walking the same list of counters, and
+    // counters are only ever added at the front.
+    auto const added = after.size () - before.size ();
+    for (std::size_t i = 0; i < after.size (); ++i)
+    {
+        auto created = after[i].second;
+        if (i >= added)
+            created -= before[i - added].second;
+        if (created != 0)
+            stats.allocations[after[i].first] += created;
+    }
+
+    ++stats.ledgers;
+    stats.transactions += txns.size ();
+
+    if (accountHash != ledger->getAccountHash () ||
+        transHash != ledger->getTransHash ())
+    {
+        ++stats.mismatches;
+        journal.warning << "Ledger " << ledger->getLedgerSeq () <<
+            " replayed to a different state";
+        return false;
+    }
+
+    return true;
+}
+
+Json::Value
+replayLedgers (std::uint32_t first, std::uint32_t last,
+    beast::Journal journal)
+{
+    Json::Value ret (Json::objectValue);
+
+    if (first == 0 || last < first)
+    {
+        ret["error"] = "invalid ledger range";
+        return ret;
+    }
+
+    Ledger::pointer parent = Ledger::loadByIndex (first - 1);
+
+    if (!parent)
+    {
+        ret["error"] = "missing ledger " + std::to_string (first - 1);
+        return ret;
+    }
+
+    LedgerReplayStats stats;
+
+    for (std::uint32_t seq = first; seq <= last; ++seq)
+    {
+        Ledger::pointer ledger = Ledger::loadByIndex (seq);
+
+        if (!ledger || ledger->getParentHash () != parent->getHash ())
+        {
+            ret = stats.getJson ();
+            ret["error"] = "missing ledger " + std::to_string (seq);
+            return ret;
+        }
+
+        replayLedger (parent, ledger, stats, journal);
+        parent = std::move (ledger);
+    }
+
+    return stats.getJson ();
+}
+
+} // ripple
@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_APP_LEDGER_LEDGERREPLAY_H_INCLUDED
+#define RIPPLE_APP_LEDGER_LEDGERREPLAY_H_INCLUDED
+
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/json/json_value.h>
+#include <ripple/protocol/TxFormats.h>
+#include <beast/utility/Journal.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace ripple {
+
+/** Measurements taken while replaying closed ledgers. */
+class LedgerReplayStats
+{
+public:
+    /** Latencies counted in power of two buckets of microseconds. */
+    class Histogram
+    {
+    public:
+        void add (std::chrono::nanoseconds elapsed);
+
+        Json::Value getJson () const;
+
+    private:
+        std::array <std::uint64_t, 24> buckets_ {};
+        std::uint64_t count_ = 0;
+        std::chrono::nanoseconds total_ {0};
+    };
+
+    std::size_t ledgers = 0;
+    std::size_t transactions = 0;
+
+    // Ledgers whose replayed state did not hash the same as the original
+    std::size_t mismatches = 0;
+
+    std::chrono::nanoseconds applyTime {0};
+    std::chrono::nanoseconds hashTime {0};
+
+    std::map <TxType, Histogram> latency;
+
+    // Objects constructed while replaying, by type
+    std::map <std::string, std::uint64_t> allocations;
+
+    Json::Value getJson () const;
+};
+
+/** Re-apply a closed ledger's transactions to its parent's state.
+
+    The transactions are applied through a TransactionEngine in the order
+    their metadata records, which is the order of the final pass that built
+    the ledger. Signatures are not checked.
+
+    @return `true` if the account state and transaction trees hash the same
+            as the ledger's.
+*/
+bool replayLedger (Ledger::ref parent, Ledger::ref ledger,
+    LedgerReplayStats& stats, beast::Journal journal);
+
+/** Replay a range of ledgers from the local databases.
+
+    Each ledger is replayed on top of the stored state of its parent.
+
+    @return The measurements, or an error, as JSON.
+*/
+Json::Value replayLedgers (std::uint32_t first, std::uint32_t last,
+    beast::Journal journal);
+
+} // ripple
+
+#endif
@@ -139,11 +139,11 @@ void fillJson (Object& json, LedgerFill const& fill)
                      if (bBinary)
                     {
                         auto&& obj = appendObject (txns);
-                        obj[jss::tx_blob] = strHex (item->peekData ());
+                        obj[jss::tx_blob] = strHex (item->data (), item->size ());
                     }
                     else
                     {
-                        SerialIter sit (item->peekSerializer ());
+                        SerialIter sit (item->slice ());
                         STTx txn (sit);
                         txns.append (txn.getJson (0));
                     }
@@ -152,7 +152,7 @@ void fillJson (Object& json, LedgerFill const& fill)
                 {
                     if (bBinary)
                     {
-                        SerialIter sit (item->peekSerializer ());
+                        SerialIter sit (item->slice ());
 
                         auto&& obj = appendObject (txns);
                         obj[jss::tx_blob] = strHex (sit.getVL ());
@@ -160,7 +160,7 @@ void fillJson (Object& json, LedgerFill const& fill)
                     }
                     else
                     {
-                        SerialIter sit (item->peekSerializer ());
+                        SerialIter sit (item->slice ());
                         Serializer sTxn (sit.getVL ());
 
                         SerialIter tsit (sTxn);
@@ -198,11 +198,11 @@ void fillJson (Object& json, LedgerFill const& fill)
              if (bBinary)
              {
                  ledger.peekAccountStateMap()->visitLeaves (
-                     [&array] (std::shared_ptr<SHAMapItem> const& smi)
+                     [&array] (SHAMapItem::pointer const& smi)
                      {
                          auto&& obj = appendObject (array);
                          obj[jss::hash] = to_string(smi->getTag ());
-                         obj[jss::tx_blob] = strHex(smi->peekData ());
+                         obj[jss::tx_blob] = strHex (smi->data (), smi->size ());
                      });
              }
              else
@@ -218,7 +218,7 @@ void fillJson (Object& json, LedgerFill const& fill)
         else
         {
             accountStateMap->visitLeaves(
-                [&array, &count] (std::shared_ptr<SHAMapItem> const& smi)
+                [&array, &count] (SHAMapItem::pointer const& smi)
                 {
                     count.yield();
                     array.append (to_string(smi->getTag ()));
@@ -0,0 +1,301 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/OpenLedgerRecord.h>
+#include <ripple/basics/Log.h>
+#include <ripple/core/Config.h>
+#include <ripple/legacy/0.27/Emulate027.h>
+#include <ripple/protocol/TxFormats.h>
+#include <cassert>
+
+namespace ripple {
+
+// The most ledger entries the closed ledger may have changed for recorded
+// results to be checked against them. A bigger difference usually means
+// the server switched ledgers, and everything is applied again.
+static int const openRecordMaxClosedChanges = 16384;
+
+template <class Map>
+static
+void
+addWriter (Map& map, uint256 const& key, uint256 const& txID)
+{
+    auto const result = map.emplace (key, txID);
+
+    if (!result.second && result.first->second != txID)
+        result.first->second.zero ();
+}
+
+OpenLedgerRecord::OpenLedgerRecord (Ledger::ref base)
+    : base_ (base)
+{
+    assert (base_);
+}
+
+bool
+OpenLedgerRecord::describes (Ledger::ref open) const
+{
+    return complete_ && open && (open == open_);
+}
+
+void
+OpenLedgerRecord::setOpen (Ledger::ref open)
+{
+    open_ = open;
+}
+
+void
+OpenLedgerRecord::invalidate ()
+{
+    complete_ = false;
+    applied_.clear ();
+    writes_ = Writes ();
+}
+
+void
+OpenLedgerRecord::insert (uint256 const& txID, TER result,
+    LedgerEntrySet& view, std::shared_ptr<LedgerReadSet> const& reads)
+{
+    if (!complete_)
+        return;
+
+    Applied applied;
+    applied.result = result;
+    applied.reads = reads;
+    applied.changes = std::make_shared<LedgerEntrySet> ();
+    applied.changes->swapWith (view);
+
+    // Don't hold on to the snapshot the transaction was applied to
+    applied.changes->invalidate ();
+
+    for (auto const& it : *applied.changes)
+    {
+        switch (it.second.mAction)
+        {
+        case taaCREATE:
+        case taaDELETE:
+            addWriter (writes_.created, it.first, txID);
+            // Fall through
+
+        case taaMODIFY:
+            addWriter (writes_.keys, it.first, txID);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    applied_[txID] = std::move (applied);
+}
+
+std::pair<TER, bool>
+OpenLedgerRecord::apply (TransactionEngine& engine,
+    STTx const& txn, TransactionEngineParams params)
+{
+    auto reads = std::make_shared<LedgerReadSet> ();
+    engine.view ().trackReads (reads);
+
+    auto const result = engine.calculate (txn, params);
+
+    if (result.second)
+    {
+        engine.commit (txn, params);
+        insert (txn.getTransactionID (), result.first, engine.view (), reads);
+    }
+
+    engine.view ().clear ();
+    engine.view ().trackReads (nullptr);
+
+    return result;
+}
+
+bool
+OpenLedgerRecord::reapply (TransactionEngine& engine, STTx const& txn,
+    OpenLedgerRecord& previous)
+{
+    Applied applied = previous.take (txn, *this);
+
+    if (!applied.changes)
+        return false;
+
+    engine.view ().swapWith (*applied.changes);
+    engine.commit (txn, tapOPEN_LEDGER);
+    insert (txn.getTransactionID (), applied.result,
+        engine.view (), applied.reads);
+
+    return true;
+}
+
+bool
+OpenLedgerRecord::prepare (Ledger::ref open, Ledger::ref closed,
+    Ledger::ref next)
+{
+    ready_ = false;
+    closed_ = Writes ();
+
+    if (!describes (open) || (closed->getParentHash () != base_->getHash ()))
+        return false;
+
+    // Ledger inputs that transactions use without reading an entry
+    if ((open_->getBaseFee () != next->getBaseFee ()) ||
+        (open_->getReferenceFeeUnits () != next->getReferenceFeeUnits ()) ||
+        (open_->getReserve (0) != next->getReserve (0)) ||
+        (open_->getReserveInc () != next->getReserveInc ()) ||
+        (legacy::emulate027 (open_) != legacy::emulate027 (next)))
+    {
+        WriteLog (lsDEBUG, LedgerConsensus) <<
+            "Open ledger record not reused: ledger settings changed";
+        return false;
+    }
+
+    SHAMap::Delta delta;
+
+    if (!base_->peekAccountStateMap ()->compare (
+        closed->peekAccountStateMap (), delta, openRecordMaxClosedChanges))
+    {
+        WriteLog (lsDEBUG, LedgerConsensus) <<
+            "Open ledger record not reused: closed ledger too different";
+        return false;
+    }
+
+    // A zero writer never matches a transaction, so every key the closed
+    // ledger changed conflicts with any transaction that read it.
+    for (auto const& it : delta)
+    {
+        closed_.keys.emplace (it.first, uint256 ());
+
+        if (!it.second.first || !it.second.second)
+            closed_.created.emplace (it.first, uint256 ());
+    }
+
+    nextSeq_ = next->getLedgerSeq ();
+    nextFee_ = next->scaleFeeLoad (getConfig ().TRANSACTION_FEE_BASE, false);
+    ready_ = true;
+    return true;
+}
+
+OpenLedgerRecord::Applied
+OpenLedgerRecord::take (STTx const& txn, OpenLedgerRecord const& building)
+{
+    uint256 const& txID = txn.getTransactionID ();
+
+    if (!ready_ || !building.complete_ || building.applied_.count (txID))
+        return Applied ();
+
+    auto const it = applied_.find (txID);
+
+    if (it == applied_.end ())
+        return Applied ();
+
+    Applied applied = std::move (it->second);
+    applied_.erase (it);
+
+    if ((applied.result != tesSUCCESS) || !applied.reads ||
+        dependsOnLedger (txn) ||
+        conflicts (closed_, *applied.reads, txID) ||
+        conflicts (writes_, *applied.reads, txID) ||
+        conflicts (building.writes_, *applied.reads, txID))
+    {
+        return Applied ();
+    }
+
+    // Threading is the only place the ledger sequence appears in the changes
+    for (auto& entry : *applied.changes)
+    {
+        SLE::pointer& sle = entry.second.mEntry;
+
+        if (sle &&
+            ((entry.second.mAction == taaCREATE) ||
+                (entry.second.mAction == taaMODIFY)) &&
+            sle->isFieldPresent (sfPreviousTxnID) &&
+            (sle->getFieldH256 (sfPreviousTxnID) == txID))
+        {
+            sle = std::make_shared<SLE> (*sle);
+            sle->setFieldU32 (sfPreviousTxnLgrSeq, nextSeq_);
+        }
+    }
+
+    return applied;
+}
+
+bool
+OpenLedgerRecord::dependsOnLedger (STTx const& txn) const
+{
+    switch (txn.getTxnType ())
+    {
+    case ttPAYMENT:
+        // Only direct XRP payments; anything else may take paths
+        if (!txn.getFieldAmount (sfAmount).isNative () ||
+            txn.isFieldPresent (sfPaths) ||
+            txn.isFieldPresent (sfSendMax))
+        {
+            return true;
+        }
+        break;
+
+    case ttACCOUNT_SET:
+    case ttREGULAR_KEY_SET:
+    case ttTRUST_SET:
+    case ttOFFER_CANCEL:
+        break;
+
+    default:
+        // Offers and tickets expire based on the close time
+        return true;
+    }
+
+    if (txn.isFieldPresent (sfLastLedgerSequence) &&
+            (txn.getFieldU32 (sfLastLedgerSequence) < nextSeq_))
+        return true;
+
+    // The fee must still cover the load
+    return txn.getTransactionFee () < STAmount (nextFee_);
+}
+
+bool
+OpenLedgerRecord::conflicts (Writes const& writes,
+    LedgerReadSet const& reads, uint256 const& txID)
+{
+    for (auto const& key : reads.keys)
+    {
+        auto const it = writes.keys.find (key);
+
+        if ((it != writes.keys.end ()) && (it->second != txID))
+            return true;
+    }
+
+    for (auto const& range : reads.ranges)
+    {
+        for (auto it = writes.created.upper_bound (range.first);
+            it != writes.created.end (); ++it)
+        {
+            if (range.second.isNonZero () && (it->first > range.second))
+                break;
+
+            if (it->second != txID)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+} // ripple
@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_OPENLEDGERRECORD_H_INCLUDED
+#define RIPPLE_APP_LEDGER_OPENLEDGERRECORD_H_INCLUDED
+
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/ledger/LedgerEntrySet.h>
+#include <ripple/app/tx/TransactionEngine.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/protocol/TER.h>
+#include <map>
+#include <memory>
+#include <utility>
+
+namespace ripple {
+
+/** What each transaction did to an open ledger, and what it read to do it.
+
+    When a ledger closes, the transactions in the old open ledger that did
+    not make it into the closed ledger are applied again to build the new
+    open ledger. Most of them produce exactly the changes they made the
+    first time. A transaction's recorded changes can be committed as they
+    are if nothing it read was written by the closed ledger, by another
+    transaction in the old open ledger, or by a transaction already in the
+    new one, and if the inputs that do not come from ledger entries (the
+    sequence, fees and close time) cannot affect it.
+
+    Only successful transactions of types that do not depend on the close
+    time are reused. Everything else is applied again as usual.
+
+    Not thread safe. The ledger master lock protects the record of the
+    current open ledger.
+*/
+class OpenLedgerRecord
+{
+public:
+    using pointer = std::shared_ptr<OpenLedgerRecord>;
+
+    /** Start a record of what is applied to a new open ledger.
+        @param base The closed ledger the open ledger is built on.
+    */
+    explicit
+    OpenLedgerRecord (Ledger::ref base);
+
+    OpenLedgerRecord (OpenLedgerRecord const&) = delete;
+    OpenLedgerRecord& operator= (OpenLedgerRecord const&) = delete;
+
+    /** Returns `true` if everything applied to `open` was recorded. */
+    bool describes (Ledger::ref open) const;
+
+    /** Set the open ledger that the recorded transactions produced. */
+    void setOpen (Ledger::ref open);
+
+    /** Note that something was applied without being recorded. */
+    void invalidate ();
+
+    /** Record a transaction that was applied and committed.
+        The changes are moved out of `view`, which is left empty.
+    */
+    void insert (uint256 const& txID, TER result,
+        LedgerEntrySet& view, std::shared_ptr<LedgerReadSet> const& reads);
+
+    /** Apply a transaction with the engine, recording it if it applies. */
+    std::pair<TER, bool> apply (TransactionEngine& engine,
+        STTx const& txn, TransactionEngineParams params);
+
+    /** Apply a transaction to an open ledger by committing the changes it
+        made to the previous open ledger, if they still hold.
+        @param previous The record of the previous open ledger, on which
+                        prepare() succeeded.
+        @return `true` if the transaction was applied and recorded.
+    */
+    bool reapply (TransactionEngine& engine, STTx const& txn,
+        OpenLedgerRecord& previous);
+
+    /** Get ready to reuse recorded results in the next open ledger.
+        @param open   The open ledger being replaced.
+        @param closed The ledger that closed in its place.
+        @param next   The new open ledger, built on `closed`.
+        @return `false` if nothing can be reused.
+    */
+    bool prepare (Ledger::ref open, Ledger::ref closed, Ledger::ref next);
+
+    /** Returns the number of transactions recorded. */
+    std::size_t size () const
+    {
+        return applied_.size ();
+    }
+
+private:
+    struct Applied
+    {
+        TER result = tesSUCCESS;
+        std::shared_ptr<LedgerEntrySet> changes;
+        std::shared_ptr<LedgerReadSet> reads;
+    };
+
+    // Keys written by a group of transactions
+    struct Writes
+    {
+        // The transaction that wrote each key, zero if more than one did
+        hash_map<uint256, uint256> keys;
+
+        // Keys created or deleted, ordered so ranges can be checked
+        std::map<uint256, uint256> created;
+    };
+
+    // Take the changes a transaction made if they still hold
+    Applied take (STTx const& txn, OpenLedgerRecord const& building);
+
+    // Returns `true` if a transaction of this form could have a different
+    // outcome in the next open ledger even if its reads are unchanged.
+    bool dependsOnLedger (STTx const& txn) const;
+
+    static bool conflicts (Writes const& writes,
+        LedgerReadSet const& reads, uint256 const& txID);
+
+    Ledger::pointer base_;
+    Ledger::pointer open_;
+    bool complete_ = true;
+
+    hash_map<uint256, Applied> applied_;
+    Writes writes_;
+
+    // Set by prepare()
+    bool ready_ = false;
+    Writes closed_;
+    std::uint32_t nextSeq_ = 0;
+    std::uint64_t nextFee_ = 0;
+};
+
+} // ripple
+
+#endif
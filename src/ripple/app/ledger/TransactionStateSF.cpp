@@ -27,7 +27,8 @@
 
 namespace ripple {
 
-TransactionStateSF::TransactionStateSF()
+TransactionStateSF::TransactionStateSF (std::uint32_t ledgerSeq)
+    : ledgerSeq_ (ledgerSeq)
 {
 }
 
@@ -43,7 +44,8 @@ void TransactionStateSF::gotNode (bool fromFilter,
     getApp().getNodeStore ().store (
         (type == SHAMapTreeNode::tnTRANSACTION_NM) ? hotTRANSACTION : hotTRANSACTION_NODE,
         std::move (nodeData),
-        nodeHash);
+        nodeHash,
+        ledgerSeq_);
 }
 
 bool TransactionStateSF::haveNode (SHAMapNodeID const& id,
@@ -30,7 +30,8 @@ namespace ripple {
 class TransactionStateSF : public SHAMapSyncFilter
 {
 public:
-    TransactionStateSF();
+    explicit
+    TransactionStateSF (std::uint32_t ledgerSeq);
 
     // Note that the nodeData is overwritten by this call
     void gotNode (bool fromFilter,
@@ -42,6 +43,10 @@ public:
     bool haveNode (SHAMapNodeID const& id,
                    uint256 const& nodeHash,
                    Blob& nodeData);
+
+private:
+    // The ledger whose nodes are being acquired
+    std::uint32_t ledgerSeq_;
 };
 
 } // ripple
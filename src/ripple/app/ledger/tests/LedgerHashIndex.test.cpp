@@ -0,0 +1,100 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerHashIndex.h>
+#include <beast/module/core/diagnostic/UnitTestUtilities.h>
+#include <beast/unit_test/suite.h>
+#include <boost/filesystem.hpp>
+#include <cstring>
+
+namespace ripple {
+namespace test {
+
+class LedgerHashIndex_test : public beast::unit_test::suite
+{
+    static LedgerHash makeHash (LedgerIndex seq)
+    {
+        LedgerHash hash;
+        hash.begin ()[0] = 0x5A;
+        std::memcpy (hash.begin () + 1, &seq, sizeof (seq));
+        return hash;
+    }
+
+public:
+    void testIndex ()
+    {
+        testcase ("index");
+
+        beast::UnitTestUtilities::TempDirectory dir ("hash_index");
+        boost::filesystem::path const dirPath (
+            dir.getFullPathName ().toStdString ());
+        boost::filesystem::create_directories (dirPath);
+        std::string const path = (dirPath / "ledger_hashes.idx").string ();
+
+        beast::Journal j;
+
+        {
+            LedgerHashIndex index (j);
+            expect (index.open (path), "Should create");
+            expect (index.get (100).isZero ());
+
+            for (LedgerIndex seq = 100; seq <= 200; ++seq)
+                index.insert (seq, makeHash (seq));
+            index.insert (250, makeHash (250));
+            index.erase (150);
+
+            expect (index.get (100) == makeHash (100));
+            expect (index.get (200) == makeHash (200));
+            expect (index.get (150).isZero ());
+            expect (! index.has (150));
+            expect (index.prevMissing (200) == 150);
+            expect (index.prevMissing (250) == 249);
+        }
+
+        {
+            // Reopen and check that gaps survive the restart
+            LedgerHashIndex index (j);
+            expect (index.open (path), "Should reopen");
+            expect (index.getKnown () == "100-149,151-200,250",
+                index.getKnown ());
+            expect (index.get (199) == makeHash (199));
+            expect (index.get (250) == makeHash (250));
+            expect (index.get (251).isZero ());
+            expect (index.prevMissing (149) == 99);
+
+            std::vector <std::pair <LedgerIndex, LedgerHash>> batch;
+            batch.emplace_back (150, makeHash (150));
+            batch.emplace_back (151, LedgerHash ());
+            index.insert (batch);
+            expect (index.get (150) == makeHash (150));
+            expect (index.get (151) == makeHash (151));
+        }
+    }
+
+    void run ()
+    {
+        testIndex ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE (LedgerHashIndex, ledger, ripple);
+
+}  // test
+}  // ripple
@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <ripple/app/ledger/LedgerReplay.h>
+#include <ripple/app/tests/common_ledger.h>
+#include <ripple/basics/Log.h>
+#include <ripple/json/to_string.h>
+#include <beast/module/core/text/LexicalCast.h>
+
+namespace ripple {
+namespace test {
+
+/** Replays a generated history and reports the replay timings.
+
+    The argument is the number of ledgers of traffic to generate. To
+    measure historical ledgers from a local database instead, use the
+    --replaybench command line option.
+*/
+class LedgerReplay_test : public beast::unit_test::suite
+{
+    void
+    makeHistory (std::size_t count, std::vector <Ledger::pointer>& history)
+    {
+        std::uint64_t const xrp = std::mega::num;
+
+        auto master = createAccount ("masterpassphrase", KeyType::secp256k1);
+
+        Ledger::pointer LCL;
+        Ledger::pointer ledger;
+        std::tie (LCL, ledger) = createGenesisLedger (100000 * xrp, master);
+
+        auto gw = createAccount ("gw", KeyType::secp256k1);
+        auto alice = createAccount ("alice", KeyType::secp256k1);
+        auto bob = createAccount ("bob", KeyType::ed25519);
+        auto carol = createAccount ("carol", KeyType::secp256k1);
+
+        pay (master, gw, 10000 * xrp, ledger);
+        pay (master, alice, 10000 * xrp, ledger);
+        pay (master, bob, 10000 * xrp, ledger);
+        pay (master, carol, 10000 * xrp, ledger);
+        close_and_advance (ledger, LCL);
+
+        for (auto account : { &alice, &bob, &carol })
+        {
+            trust (*account, gw, "USD", 1000000, ledger);
+            trust (*account, gw, "EUR", 1000000, ledger);
+        }
+        close_and_advance (ledger, LCL);
+
+        for (auto account : { &alice, &bob, &carol })
+        {
+            pay (gw, *account, "USD", "10000", ledger);
+            pay (gw, *account, "EUR", "10000", ledger);
+        }
+        close_and_advance (ledger, LCL);
+        history.push_back (LCL);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            pay (alice, bob, 10 * xrp, ledger);
+            pay (bob, carol, 10 * xrp, ledger);
+            pay (carol, alice, "USD", "5", ledger);
+            pay (gw, carol, "EUR", "1", ledger);
+
+            createOffer (alice, Amount (10, "USD", gw),
+                Amount (9, "EUR", gw), ledger);
+            createOffer (bob, Amount (8, "EUR", gw),
+                Amount (10, "USD", gw), ledger);
+
+            if (i % 4 == 3)
+                cancelOffer (alice, ledger);
+
+            close_and_advance (ledger, LCL);
+            history.push_back (LCL);
+        }
+    }
+
+public:
+    void
+    run () override
+    {
+        std::size_t count = 20;
+        if (!arg ().empty ())
+            beast::lexicalCastChecked (count, arg ());
+
+        std::vector <Ledger::pointer> history;
+        makeHistory (count, history);
+
+        LedgerReplayStats stats;
+        auto const journal = deprecatedLogs().journal ("LedgerReplay");
+
+        for (std::size_t i = 1; i < history.size (); ++i)
+        {
+            expect (replayLedger (history[i - 1], history[i], stats, journal),
+                "Ledger " + std::to_string (history[i]->getLedgerSeq ()) +
+                    " replays to the same state");
+        }
+
+        expect (stats.ledgers == count);
+        expect (stats.mismatches == 0);
+
+        log << to_string (stats.getJson ());
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(LedgerReplay,ripple_app,ripple);
+
+} // test
+} // ripple
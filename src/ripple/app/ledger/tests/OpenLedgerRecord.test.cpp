@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/OpenLedgerRecord.h>
+#include <ripple/app/tests/common_ledger.h>
+
+namespace ripple {
+namespace test {
+
+class OpenLedgerRecord_test : public beast::unit_test::suite
+{
+public:
+    void
+    testReuse ()
+    {
+        std::uint64_t const xrp = std::mega::num;
+
+        auto master = createAccount ("masterpassphrase", KeyType::secp256k1);
+
+        Ledger::pointer LCL;
+        Ledger::pointer ledger;
+        std::tie (LCL, ledger) = createGenesisLedger (100000 * xrp, master);
+
+        auto alice = createAccount ("alice", KeyType::secp256k1);
+        auto bob = createAccount ("bob", KeyType::secp256k1);
+        auto carol = createAccount ("carol", KeyType::secp256k1);
+        auto dan = createAccount ("dan", KeyType::secp256k1);
+
+        pay (master, alice, 1000 * xrp, ledger);
+        pay (master, bob, 1000 * xrp, ledger);
+        pay (master, carol, 1000 * xrp, ledger);
+        pay (master, dan, 1000 * xrp, ledger);
+        close_and_advance (ledger, LCL);
+
+        auto const toBob = getPaymentTx (alice, bob, 10 * xrp);
+        auto const toDan = getPaymentTx (carol, dan, 20 * xrp);
+        auto const toMaster = getPaymentTx (bob, master, 30 * xrp);
+
+        // Record the open ledger
+        Ledger::pointer const open = std::make_shared<Ledger> (true, *LCL);
+        auto const record = std::make_shared<OpenLedgerRecord> (LCL);
+        {
+            TransactionEngine engine (open);
+            for (auto const& txn : { toBob, toDan, toMaster })
+                expect (record->apply (engine, txn, tapOPEN_LEDGER).second);
+        }
+        record->setOpen (open);
+        expect (record->describes (open));
+        expect (record->size () == 3);
+
+        // Only alice's payment makes it into the closed ledger
+        Ledger::pointer closed = LCL;
+        Ledger::pointer closing = std::make_shared<Ledger> (false, *LCL);
+        applyTransaction (closing, toBob);
+        close_and_advance (closing, closed);
+
+        Ledger::pointer const replayed = std::make_shared<Ledger> (true, *closed);
+        {
+            CanonicalTXSet retriable (open->peekTransactionMap ()->getHash ());
+            applyTransactions (open->peekTransactionMap (),
+                replayed, closed, retriable, true);
+        }
+
+        Ledger::pointer const next = std::make_shared<Ledger> (true, *closed);
+        expect (record->prepare (open, closed, next));
+
+        auto const building = std::make_shared<OpenLedgerRecord> (closed);
+        {
+            TransactionEngine engine (next);
+
+            // Nothing carol's payment read has changed
+            expect (building->reapply (engine, toDan, *record));
+
+            // Bob's account was changed by the closed ledger
+            expect (! building->reapply (engine, toMaster, *record));
+            expect (building->apply (engine, toMaster, tapOPEN_LEDGER).second);
+        }
+        expect (building->size () == 2);
+
+        expect (next->peekAccountStateMap ()->getHash () ==
+            replayed->peekAccountStateMap ()->getHash ());
+        expect (next->peekTransactionMap ()->getHash () ==
+            replayed->peekTransactionMap ()->getHash ());
+    }
+
+    void
+    testIncomplete ()
+    {
+        std::uint64_t const xrp = std::mega::num;
+
+        auto master = createAccount ("masterpassphrase", KeyType::secp256k1);
+
+        Ledger::pointer LCL;
+        Ledger::pointer ledger;
+        std::tie (LCL, ledger) = createGenesisLedger (100000 * xrp, master);
+
+        auto const record = std::make_shared<OpenLedgerRecord> (LCL);
+        record->setOpen (ledger);
+        expect (record->describes (ledger));
+
+        record->invalidate ();
+        expect (! record->describes (ledger));
+
+        Ledger::pointer const next = std::make_shared<Ledger> (true, *LCL);
+        expect (! record->prepare (ledger, LCL, next));
+    }
+
+    void
+    run ()
+    {
+        testReuse ();
+        testIncomplete ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE (OpenLedgerRecord, ledger, ripple);
+
+} // test
+} // ripple
@@ -29,6 +29,7 @@
 #include <ripple/app/ledger/OrderBookDB.h>
 #include <ripple/app/main/CollectorManager.h>
 #include <ripple/app/main/LoadManager.h>
+#include <ripple/app/main/MemoryGovernor.h>
 #include <ripple/app/main/LocalCredentials.h>
 #include <ripple/app/main/NodeStoreScheduler.h>
 #include <ripple/app/misc/AmendmentTable.h>
@@ -67,6 +68,7 @@
 #include <beast/asio/io_latency_probe.h>
 #include <beast/module/core/text/LexicalCast.h>
 #include <beast/module/core/thread/DeadlineTimer.h>
+#include <beast/utility/ci_char_traits.h>
 #include <boost/asio/signal_set.hpp>
 #include <fstream>
 
@@ -111,6 +113,7 @@ class AppFamily : public shamap::Family
 private:
     TreeNodeCache treecache_;
     FullBelowCache fullbelow_;
+    FullBelowStore fullbelowstore_;
     NodeStore::Database& db_;
 
 public:
@@ -124,10 +127,22 @@ public:
         , fullbelow_ ("full_below", get_seconds_clock(),
             collectorManager.collector(),
                 fullBelowTargetSize, fullBelowExpirationSeconds)
+        , fullbelowstore_ (deprecatedLogs().journal("FullBelowStore"))
         , db_ (db)
     {
     }
 
+    /** Open the persistent record of complete trees and warm the cache. */
+    void
+    openFullBelow (std::string const& path)
+    {
+        if (! fullbelowstore_.open (path))
+            return;
+
+        for (auto const& hash : fullbelowstore_.getRoots ())
+            fullbelow_.insert (hash);
+    }
+
     FullBelowCache&
     fullbelow() override
     {
@@ -140,6 +155,18 @@ public:
         return fullbelow_;
     }
 
+    FullBelowStore&
+    fullbelowstore() override
+    {
+        return fullbelowstore_;
+    }
+
+    FullBelowStore const&
+    fullbelowstore() const override
+    {
+        return fullbelowstore_;
+    }
+
     TreeNodeCache&
     treecache() override
     {
@@ -288,6 +315,7 @@ public:
     std::unique_ptr <LoadManager> m_loadManager;
     beast::DeadlineTimer m_sweepTimer;
     beast::DeadlineTimer m_entropyTimer;
+    std::unique_ptr <MemoryGovernor> m_memoryGovernor;
 
     std::unique_ptr <DatabaseCon> mTxnDB;
     std::unique_ptr <DatabaseCon> mLedgerDB;
@@ -783,6 +811,24 @@ public:
         family().treecache().setTargetSize (getConfig ().getSize (siTreeCacheSize));
         family().treecache().setTargetAge (getConfig ().getSize (siTreeCacheAge));
 
+        // Trees proven complete are only remembered across restarts when
+        // the node store itself persists.
+        {
+            auto const& nodeDb = getConfig ().section (
+                ConfigSection::nodeDatabase ());
+            auto const type = get <std::string> (nodeDb, "type");
+            auto const path = get <std::string> (nodeDb, "path");
+            if (! path.empty () && ! beast::ci_equal (type, "memory") &&
+                ! beast::ci_equal (type, "none"))
+            {
+                family_.openFullBelow ((boost::filesystem::path (path) /
+                    "full_below.idx").string ());
+            }
+        }
+
+        if (getConfig ().MEMORY_BUDGET != 0)
+            setupMemoryGovernor ();
+
         //----------------------------------------------------------------------
         //
         // Server
@@ -990,7 +1036,11 @@ public:
         //         have listeners register for "onSweep ()" notification.
         //
 
+        if (m_memoryGovernor)
+            m_memoryGovernor->rebalance ();
+
         family_.fullbelow().sweep ();
+        family_.fullbelowstore().sweep ();
 
         logTimedCall (m_journal.warning, "TransactionMaster::sweep", __FILE__, __LINE__, std::bind (
             &TransactionMaster::sweep, &m_txMaster));
@@ -1028,6 +1078,68 @@ public:
 
 
 private:
+    // Let the memory governor size the caches from the memory budget
+    void setupMemoryGovernor ()
+    {
+        m_memoryGovernor = std::make_unique <MemoryGovernor> (
+            getConfig ().MEMORY_BUDGET * 1024 * 1024,
+                m_collectorManager->group ("memory"),
+                    m_logs.journal ("MemoryGovernor"));
+
+        int const nodeCacheAge = getConfig ().getSize (siNodeCacheAge);
+        int const ledgerAge = getConfig ().getSize (siLedgerAge);
+
+        m_memoryGovernor->add ({"node_cache", nodeObjectBytes,
+            memoryGovernorMinimumEntries,
+            [this] { return m_nodeStore->getCacheSize (); },
+            [this] { return m_nodeStore->getCacheHitsAndMisses (); },
+            [this, nodeCacheAge] (std::size_t size)
+                { m_nodeStore->tune (static_cast <int> (size), nodeCacheAge); }},
+            getConfig ().getSize (siNodeCacheSize));
+
+        m_memoryGovernor->add ({"tree_cache", treeNodeBytes,
+            memoryGovernorMinimumEntries,
+            [this] { return family_.treecache ().getCacheSize (); },
+            [this] { return family_.treecache ().getHitsAndMisses (); },
+            [this] (std::size_t size)
+                { family_.treecache ().setTargetSize (size); }},
+            getConfig ().getSize (siTreeCacheSize));
+
+        m_memoryGovernor->add ({"sle_cache", ledgerEntryBytes,
+            memoryGovernorMinimumEntries,
+            [this] { return m_sleCache.getCacheSize (); },
+            [this] { return m_sleCache.getHitsAndMisses (); },
+            [this] (std::size_t size) { m_sleCache.setTargetSize (size); }},
+            getConfig ().getSize (siSLECacheSize));
+
+        m_memoryGovernor->add ({"ledger_history", ledgerBytes,
+            getConfig ().getSize (siLedgerSize),
+            [this] { return m_ledgerMaster->getCacheSize (); },
+            [this] { return m_ledgerMaster->getCacheHitsAndMisses (); },
+            [this, ledgerAge] (std::size_t size)
+                { m_ledgerMaster->tune (static_cast <int> (size), ledgerAge); }},
+            getConfig ().getSize (siLedgerSize));
+
+        m_memoryGovernor->add ({"transactions", transactionBytes,
+            memoryGovernorMinimumEntries,
+            [this] { return m_txMaster.getCache ().getCacheSize (); },
+            [this] { return m_txMaster.getCache ().getHitsAndMisses (); },
+            [this] (std::size_t size)
+                { m_txMaster.getCache ().setTargetSize (size); }},
+            m_txMaster.getCache ().getTargetSize ());
+
+        m_memoryGovernor->add ({"full_below", fullBelowBytes,
+            memoryGovernorMinimumEntries,
+            [this] { return family_.fullbelow ().size (); },
+            [this] { return family_.fullbelow ().getHitsAndMisses (); },
+            [this] (std::size_t size)
+                { family_.fullbelow ().setTargetSize (size); }},
+            fullBelowTargetSize);
+
+        // Apply the budget now rather than at the first sweep
+        m_memoryGovernor->rebalance ();
+    }
+
     void updateTables ();
     void startNewLedger ();
     bool loadOldLedger (
@@ -1063,7 +1175,8 @@ void ApplicationImp::startNewLedger ()
         Ledger::pointer secondLedger = std::make_shared<Ledger> (true, std::ref (*firstLedger));
         secondLedger->setClosed ();
         secondLedger->setAccepted ();
-        m_ledgerMaster->pushLedger (secondLedger, std::make_shared<Ledger> (true, std::ref (*secondLedger)));
+        m_ledgerMaster->pushLedger (secondLedger,
+            std::make_shared<Ledger> (true, std::ref (*secondLedger)), nullptr);
         assert (secondLedger->getAccountState (rootAddress));
         m_networkOPs->setLastCloseTime (secondLedger->getCloseTimeNC ());
     }
@@ -19,6 +19,7 @@
 
 #include <BeastConfig.h>
 #include <ripple/basics/Log.h>
+#include <ripple/app/ledger/LedgerReplay.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/basics/CheckLibraryVersions.h>
 #include <ripple/basics/StringUtilities.h>
@@ -34,6 +35,7 @@
 #include <ripple/server/Role.h>
 #include <ripple/protocol/BuildInfo.h>
 #include <beast/chrono/basic_seconds_clock.h>
+#include <beast/module/core/text/LexicalCast.h>
 #include <beast/unit_test.h>
 #include <beast/utility/Debug.h>
 #include <beast/streams/debug_ostream.h>
@@ -210,6 +212,38 @@ static int runUnitTests (std::string const& pattern,
     return EXIT_SUCCESS;
 }
 
+static int runReplayBenchmark (std::string const& range)
+{
+    std::uint32_t first = 0;
+    std::uint32_t last = 0;
+
+    auto const dash = range.find ('-');
+    if (dash == std::string::npos ||
+        !beast::lexicalCastChecked (first, range.substr (0, dash)) ||
+        !beast::lexicalCastChecked (last, range.substr (dash + 1)))
+    {
+        std::cerr << "Invalid ledger range: " << range << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    getConfig ().RUN_STANDALONE = true;
+
+    std::unique_ptr <Application> app (make_Application (deprecatedLogs()));
+    setupServer ();
+
+    Json::Value const result = replayLedgers (first, last,
+        deprecatedLogs().journal ("LedgerReplay"));
+    std::cout << result.toStyledString ();
+
+    // Let the server start and stop cleanly
+    app->signalStop ();
+    startServer ();
+
+    if (result.isMember ("error") || result["mismatches"].asUInt () != 0)
+        return EXIT_FAILURE;
+    return EXIT_SUCCESS;
+}
+
 //------------------------------------------------------------------------------
 
 int run (int argc, char** argv)
@@ -254,6 +288,7 @@ int run (int argc, char** argv)
     ("verbose,v", "Verbose logging.")
     ("load", "Load the current ledger from the local DB.")
     ("replay","Replay a ledger close.")
+    ("replaybench", po::value<std::string> (), "Replay the stored ledgers <first>-<last> and report timings.")
     ("ledger", po::value<std::string> (), "Load the specified ledger and start from .")
     ("ledgerfile", po::value<std::string> (), "Load the specified ledger file.")
     ("start", "Start from a fresh Ledger.")
@@ -467,6 +502,11 @@ int run (int argc, char** argv)
         return runShutdownTests ();
     }
 
+    if (vm.count ("replaybench"))
+    {
+        return runReplayBenchmark (vm["replaybench"].as<std::string> ());
+    }
+
     if (iResult == 0)
     {
         if (!vm.count ("parameters"))
@@ -0,0 +1,198 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/main/MemoryGovernor.h>
+#include <algorithm>
+
+namespace ripple {
+
+// Fraction of the budget moved between two caches in one rebalance
+static std::uint64_t const governorMoveDivider = 20;
+
+// How many times more misses per byte a cache must suffer before
+// memory is taken from another cache to grow it
+static double const governorHysteresis = 2.0;
+
+MemoryGovernor::MemoryGovernor (std::uint64_t budget,
+    beast::insight::Collector::ptr const& collector,
+        beast::Journal journal)
+    : budget_ (budget)
+    , collector_ (collector)
+    , j_ (journal)
+    , moves_ (collector->make_counter ("moves"))
+    , usedBytes_ (collector->make_gauge ("used_bytes"))
+{
+}
+
+void
+MemoryGovernor::add (Cache cache, std::size_t initialTarget)
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+
+    Entry entry;
+    entry.targetBytes = collector_->make_gauge (cache.name, "target_bytes");
+    entry.usedBytes = collector_->make_gauge (cache.name, "used_bytes");
+    entry.recentMisses = collector_->make_gauge (cache.name, "misses");
+    entry.target = std::max (initialTarget, cache.minimumEntries);
+    std::tie (entry.hits, entry.misses) = cache.counts ();
+    entry.cache = std::move (cache);
+    caches_.push_back (std::move (entry));
+    scaled_ = false;
+}
+
+// Called with the lock held
+void
+MemoryGovernor::scale ()
+{
+    std::uint64_t total = 0;
+    for (auto const& e : caches_)
+        total += static_cast <std::uint64_t> (e.target) *
+            e.cache.bytesPerEntry;
+
+    if (total == 0)
+        return;
+
+    double const factor = static_cast <double> (budget_) / total;
+
+    for (auto& e : caches_)
+    {
+        apply (e, std::max (e.cache.minimumEntries,
+            static_cast <std::size_t> (e.target * factor)));
+    }
+}
+
+// Called with the lock held
+void
+MemoryGovernor::apply (Entry& entry, std::size_t target)
+{
+    entry.target = target;
+    entry.cache.setTarget (target);
+    entry.targetBytes = static_cast <beast::insight::Gauge::value_type> (
+        target * entry.cache.bytesPerEntry);
+}
+
+void
+MemoryGovernor::rebalance ()
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+
+    if (! scaled_)
+    {
+        scale ();
+        scaled_ = true;
+    }
+
+    // Misses per byte of target since the last call, or zero for a
+    // cache which is not full and so would not gain from growing
+    std::vector <double> scores (caches_.size (), 0.0);
+    std::uint64_t used = 0;
+
+    for (std::size_t i = 0; i < caches_.size (); ++i)
+    {
+        auto& e = caches_[i];
+
+        auto const counts = e.cache.counts ();
+        // The counts restart if the cache's statistics are cleared
+        std::uint64_t const misses = (counts.second >= e.misses) ?
+            (counts.second - e.misses) : counts.second;
+        std::tie (e.hits, e.misses) = counts;
+
+        std::size_t const size = e.cache.size ();
+        std::uint64_t const bytes =
+            static_cast <std::uint64_t> (size) * e.cache.bytesPerEntry;
+        used += bytes;
+
+        e.usedBytes = static_cast <beast::insight::Gauge::value_type> (bytes);
+        e.recentMisses = static_cast <beast::insight::Gauge::value_type> (misses);
+
+        if ((size * 10) >= (e.target * 9))
+        {
+            scores[i] = static_cast <double> (misses) / std::max <std::uint64_t> (
+                1, static_cast <std::uint64_t> (e.target) * e.cache.bytesPerEntry);
+        }
+    }
+
+    usedBytes_ = static_cast <beast::insight::Gauge::value_type> (used);
+
+    if (caches_.size () < 2)
+        return;
+
+    // The cache that would gain the most from growing
+    std::size_t const receiver = std::distance (scores.begin (),
+        std::max_element (scores.begin (), scores.end ()));
+
+    if (scores[receiver] <= 0)
+        return;
+
+    // The cache that would lose the least from shrinking
+    std::size_t donor = caches_.size ();
+    for (std::size_t i = 0; i < caches_.size (); ++i)
+    {
+        if (i == receiver ||
+                caches_[i].target <= caches_[i].cache.minimumEntries)
+            continue;
+
+        if (donor == caches_.size () || scores[i] < scores[donor])
+            donor = i;
+    }
+
+    if (donor == caches_.size () ||
+            scores[receiver] < (scores[donor] * governorHysteresis))
+        return;
+
+    auto& from = caches_[donor];
+    auto& to = caches_[receiver];
+
+    std::size_t const taken = std::min <std::uint64_t> (
+        from.target - from.cache.minimumEntries,
+        (budget_ / governorMoveDivider) / from.cache.bytesPerEntry);
+    std::uint64_t const bytes =
+        static_cast <std::uint64_t> (taken) * from.cache.bytesPerEntry;
+    std::size_t const given = bytes / to.cache.bytesPerEntry;
+
+    if (given == 0)
+        return;
+
+    apply (from, from.target - taken);
+    apply (to, to.target + given);
+    ++moves_;
+
+    if (j_.info) j_.info <<
+        "Moved " << bytes << " bytes from " << from.cache.name <<
+        " (" << from.target << " entries) to " << to.cache.name <<
+        " (" << to.target << " entries)";
+}
+
+std::size_t
+MemoryGovernor::getTarget (std::string const& name) const
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+
+    for (auto const& e : caches_)
+    {
+        if (e.cache.name == name)
+            return e.target;
+    }
+
+    return 0;
+}
+
+} // ripple
@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_APP_MAIN_MEMORYGOVERNOR_H_INCLUDED
+#define RIPPLE_APP_MAIN_MEMORYGOVERNOR_H_INCLUDED
+
+#include <beast/insight/Collector.h>
+#include <beast/insight/Counter.h>
+#include <beast/insight/Gauge.h>
+#include <beast/utility/Journal.h>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+/** Divides a memory budget between the caches.
+
+    Each cache is described by callbacks which report its size and its
+    cumulative hit and miss counts, and which set its target size, along
+    with an estimate of the bytes held by one entry.
+
+    On each call to rebalance(), the governor measures the misses every
+    cache suffered since the previous call. A cache that is full and
+    missing often would benefit most from growing, so a slice of the
+    budget is moved to it from the cache whose misses per byte are
+    lowest. The targets of all caches together never exceed the budget.
+
+    Targets and moves are reported through insight.
+*/
+class MemoryGovernor
+{
+public:
+    struct Cache
+    {
+        /** Name used for logging and insight. */
+        std::string name;
+
+        /** Estimated memory held by one entry, including overhead. */
+        std::size_t bytesPerEntry;
+
+        /** The target is never made smaller than this. */
+        std::size_t minimumEntries;
+
+        /** Returns the number of entries currently held. */
+        std::function <std::size_t ()> size;
+
+        /** Returns the cumulative hits and misses. */
+        std::function <std::pair <std::uint64_t, std::uint64_t> ()> counts;
+
+        /** Sets the target number of entries. */
+        std::function <void (std::size_t)> setTarget;
+    };
+
+    MemoryGovernor (std::uint64_t budget,
+        beast::insight::Collector::ptr const& collector,
+            beast::Journal journal);
+
+    MemoryGovernor (MemoryGovernor const&) = delete;
+    MemoryGovernor& operator= (MemoryGovernor const&) = delete;
+
+    /** Add a cache to the governor.
+        On the first call to rebalance(), the initial targets of all the
+        caches are scaled together so that they fill the budget.
+        @param initialTarget The number of entries the cache would have
+                             without a governor.
+    */
+    void add (Cache cache, std::size_t initialTarget);
+
+    /** Adjust the targets based on the activity since the last call.
+        This is called periodically, such as from the sweep timer.
+    */
+    void rebalance ();
+
+    /** Return the target number of entries for the named cache. */
+    std::size_t getTarget (std::string const& name) const;
+
+private:
+    struct Entry
+    {
+        Cache cache;
+        std::size_t target;
+        std::uint64_t hits;
+        std::uint64_t misses;
+        beast::insight::Gauge targetBytes;
+        beast::insight::Gauge usedBytes;
+        beast::insight::Gauge recentMisses;
+    };
+
+    void scale ();
+    void apply (Entry& entry, std::size_t target);
+
+    std::uint64_t const budget_;
+    beast::insight::Collector::ptr collector_;
+    beast::Journal j_;
+    mutable std::mutex mutex_;
+    std::vector <Entry> caches_;
+    bool scaled_ = false;
+    beast::insight::Counter moves_;
+    beast::insight::Gauge usedBytes_;
+};
+
+} // ripple
+
+#endif
@@ -28,6 +28,24 @@ enum
     ,fullBelowExpirationSeconds = 600
 };
 
+// Estimated memory held by one entry of each cache under the memory
+// governor, including the object, its payload and the cache overhead.
+enum
+{
+     nodeObjectBytes = 320
+    ,treeNodeBytes = 640
+    ,ledgerEntryBytes = 480
+    ,ledgerBytes = 4096
+    ,transactionBytes = 1024
+    ,fullBelowBytes = 96
+};
+
+// Smallest number of entries the memory governor leaves in a cache
+enum
+{
+    memoryGovernorMinimumEntries = 256
+};
+
 }
 
 #endif
@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/main/MemoryGovernor.h>
+#include <beast/insight/NullCollector.h>
+#include <beast/unit_test/suite.h>
+
+namespace ripple {
+namespace test {
+
+class MemoryGovernor_test : public beast::unit_test::suite
+{
+    struct FakeCache
+    {
+        std::size_t size = 0;
+        std::size_t target = 0;
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+    };
+
+    static MemoryGovernor::Cache makeCache (std::string const& name,
+        FakeCache& c, std::size_t bytesPerEntry, std::size_t minimum)
+    {
+        return { name, bytesPerEntry, minimum,
+            [&c] { return c.size; },
+            [&c] { return std::make_pair (c.hits, c.misses); },
+            [&c] (std::size_t target) { c.target = target; } };
+    }
+
+public:
+    void testRebalance ()
+    {
+        testcase ("rebalance");
+
+        std::uint64_t const budget = 1000000;
+
+        FakeCache a, b, c;
+        MemoryGovernor g (budget, beast::insight::NullCollector::New (),
+            beast::Journal ());
+        g.add (makeCache ("a", a, 100, 10), 1000);
+        g.add (makeCache ("b", b, 50, 10), 1000);
+        g.add (makeCache ("c", c, 10, 10), 5000);
+
+        auto const total = [&]
+        {
+            return a.target * 100 + b.target * 50 + c.target * 10;
+        };
+
+        // The initial targets are scaled to fill the budget
+        g.rebalance ();
+        expect (a.target == 5000, "a scaled");
+        expect (b.target == 5000, "b scaled");
+        expect (c.target == 25000, "c scaled");
+        expect (total () <= budget);
+
+        // a is full and missing often, b is full and rarely missing,
+        // and c is not using its memory so it gives first
+        a.size = a.target;
+        b.size = b.target;
+        a.misses += 10000;
+        b.misses += 10;
+        g.rebalance ();
+        expect (a.target == 5500, "a grows");
+        expect (b.target == 5000, "b untouched");
+        expect (c.target == 20000, "c shrinks");
+        expect (g.getTarget ("a") == a.target);
+        expect (total () <= budget);
+
+        // A cache that is not full does not grow, however much it misses
+        b.size = 0;
+        b.misses += 1000000;
+        g.rebalance ();
+        expect (a.target == 5500 && b.target == 5000 &&
+            c.target == 20000, "no change");
+
+        // Shrinking stops at the minimum
+        for (int i = 0; i < 100; ++i)
+        {
+            a.size = a.target;
+            b.size = b.target;
+            b.misses += 1000000;
+            g.rebalance ();
+        }
+        expect (a.target == 10, "a at minimum");
+        expect (c.target == 10, "c at minimum");
+        expect (total () <= budget);
+    }
+
+    void run ()
+    {
+        testRebalance ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE (MemoryGovernor, app, ripple);
+
+}  // test
+}  // ripple
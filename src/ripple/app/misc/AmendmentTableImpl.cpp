@@ -568,7 +568,7 @@ AmendmentTableImpl<AppApiFacade>::doVoting (Ledger::ref lastClosedLedger,
         Serializer s;
         trans.add (s, true);
 #if RIPPLE_PROPOSE_AMENDMENTS
-        auto tItem = std::make_shared<SHAMapItem> (txID, s.peekData ());
+        auto tItem = make_shamapitem (txID, s.peekData ());
         if (!initialPosition->addGiveItem (tItem, true, false))
         {
             if (m_journal.warning) m_journal.warning <<
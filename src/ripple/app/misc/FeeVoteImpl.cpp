@@ -228,7 +228,7 @@ FeeVoteImpl::doVoting (Ledger::ref lastClosedLedger,
         Serializer s;
         trans.add (s, true);
 
-        auto tItem = std::make_shared<SHAMapItem> (txID, s.peekData ());
+        auto tItem = make_shamapitem (txID, s.peekData ());
 
         if (!initialPosition->addGiveItem (tItem, true, false))
         {
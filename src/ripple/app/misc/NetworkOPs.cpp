@@ -36,6 +36,7 @@
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/misc/Validations.h>
 #include <ripple/app/misc/impl/AccountTxPaging.h>
+#include <ripple/app/misc/impl/FetchPackCache.h>
 #include <ripple/app/peers/ClusterNodeStatus.h>
 #include <ripple/app/peers/UniqueNodeList.h>
 #include <ripple/app/tx/TransactionMaster.h>
@@ -107,6 +108,7 @@ public:
         , mLastValidationTime (0)
         , mFetchPack ("FetchPack", 65536, 45, clock,
             deprecatedLogs().journal("TaggedCache"))
+        , mFetchPackParts (getConfig ().FETCH_PACK_CACHE * 1024 * 1024)
         , mFetchSeq (0)
         , mLastLoadBase (256)
         , mLastLoadFactor (256)
@@ -584,6 +586,7 @@ private:
     SubMapType mSubRTTransactions;     // all proposed and accepted transactions
 
     TaggedCache<uint256, Blob>  mFetchPack;
+    FetchPackCache mFetchPackParts;
     std::uint32_t mFetchSeq;
 
     std::uint32_t mLastLoadBase;
@@ -1004,14 +1007,20 @@ Transaction::pointer NetworkOPsImp::processTransactionCb (
         getApp().getHashRouter ().setFlag (trans->getID (), SF_SIGGOOD);
     }
 
+    auto const params = bAdmin
+        ? (tapOPEN_LEDGER | tapNO_CHECK_SIGN | tapADMIN)
+        : (tapOPEN_LEDGER | tapNO_CHECK_SIGN);
+
+    // If enabled, do most of the work before taking the lock
+    auto const speculation = m_ledgerMaster.speculate (
+        trans->getSTransaction (), params);
+
     {
         auto lock = beast::make_lock(getApp().getMasterMutex());
 
         bool didApply;
         TER r = m_ledgerMaster.doTransaction (
-            trans->getSTransaction (),
-            bAdmin ? (tapOPEN_LEDGER | tapNO_CHECK_SIGN | tapADMIN)
-            : (tapOPEN_LEDGER | tapNO_CHECK_SIGN), didApply);
+            trans->getSTransaction (), params, didApply, speculation);
         trans->setResult (r);
 
         if (isTemMalformed (r)) // malformed, cache bad
@@ -2392,11 +2401,9 @@ Json::Value NetworkOPsImp::transJson(
 void NetworkOPsImp::pubValidatedTransaction (
     Ledger::ref alAccepted, const AcceptedLedgerTx& alTx)
 {
-    Json::Value jvObj = transJson (
-        *alTx.getTxn (), alTx.getResult (), true, alAccepted);
-    jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
-
-    std::string sObj = to_string (jvObj);
+    // Rendered when the accepted ledger was built
+    Json::Value const& jvObj = alTx.getPublishJson ();
+    std::string const& sObj = alTx.getPublishString ();
 
     {
         ScopedLockType sl (mSubLock);
@@ -2500,7 +2507,18 @@ void NetworkOPsImp::pubAccountTransaction (
         " iProposed=" << iProposed <<
         " iAccepted=" << iAccepted;
 
-    if (!notify.empty ())
+    if (notify.empty ())
+        return;
+
+    if (bAccepted && alTx.isApplied ())
+    {
+        for (InfoSub::ref isrListener : notify)
+        {
+            isrListener->send (
+                alTx.getPublishJson (), alTx.getPublishString (), true);
+        }
+    }
+    else
     {
         Json::Value jvObj = transJson (
             *alTx.getTxn (), alTx.getResult (), bAccepted, lpCurrent);
@@ -3145,6 +3163,40 @@ static void fpAppender (
     newObj.set_data (&blob[0], blob.size ());
 }
 
+// Build the part of a fetch pack which leads from haveLedger back to its
+// parent, wantLedger: the header of wantLedger and the nodes it does not
+// share with haveLedger.
+static FetchPackCache::pointer buildFetchPackPart (
+    Ledger::ref haveLedger, Ledger::ref wantLedger)
+{
+    std::uint32_t lSeq = wantLedger->getLedgerSeq ();
+    protocol::TMGetObjectByHash objects;
+
+    protocol::TMIndexedObject& newObj = *objects.add_objects ();
+    newObj.set_hash (wantLedger->getHash ().begin (), 256 / 8);
+    Serializer s (256);
+    s.add32 (HashPrefix::ledgerMaster);
+    wantLedger->addRaw (s);
+    newObj.set_data (s.getDataPtr (), s.getLength ());
+    newObj.set_ledgerseq (lSeq);
+
+    wantLedger->peekAccountStateMap ()->getFetchPack
+        (haveLedger->peekAccountStateMap ().get (), true, 16384,
+            std::bind (fpAppender, &objects, lSeq, std::placeholders::_1,
+                       std::placeholders::_2));
+
+    if (wantLedger->getTransHash ().isNonZero ())
+        wantLedger->peekTransactionMap ()->getFetchPack (
+            nullptr, true, 512,
+            std::bind (fpAppender, &objects, lSeq, std::placeholders::_1,
+                       std::placeholders::_2));
+
+    auto part = std::make_shared <FetchPackCache::Part> ();
+    part->objects = objects.objects_size ();
+    objects.AppendPartialToString (&part->data);
+    return part;
+}
+
 void NetworkOPsImp::makeFetchPack (
     Job&, std::weak_ptr<Peer> wPeer,
     std::shared_ptr<protocol::TMGetObjectByHash> request,
@@ -3226,30 +3278,25 @@ void NetworkOPsImp::makeFetchPack (
         //     256 entries then stop.
         //  5. If not very much time has elapsed, then loop back and repeat
         //     the same process adding the previous ledger to the FetchPack.
+        //
+        // Steps 1 to 3 only depend on the ledger the peer has, so the
+        // resulting part is cached and reused for other peers.
+        std::vector <FetchPackCache::pointer> parts;
+        std::size_t objects = 0;
         do
         {
-            std::uint32_t lSeq = wantLedger->getLedgerSeq ();
-
-            protocol::TMIndexedObject& newObj = *reply.add_objects ();
-            newObj.set_hash (wantLedger->getHash ().begin (), 256 / 8);
-            Serializer s (256);
-            s.add32 (HashPrefix::ledgerMaster);
-            wantLedger->addRaw (s);
-            newObj.set_data (s.getDataPtr (), s.getLength ());
-            newObj.set_ledgerseq (lSeq);
-
-            wantLedger->peekAccountStateMap ()->getFetchPack
-                (haveLedger->peekAccountStateMap ().get (), true, 16384,
-                    std::bind (fpAppender, &reply, lSeq, std::placeholders::_1,
-                               std::placeholders::_2));
-
-            if (wantLedger->getTransHash ().isNonZero ())
-                wantLedger->peekTransactionMap ()->getFetchPack (
-                    nullptr, true, 512,
-                    std::bind (fpAppender, &reply, lSeq, std::placeholders::_1,
-                               std::placeholders::_2));
-
-            if (reply.objects ().size () >= 512)
+            auto part = mFetchPackParts.fetch (haveLedger->getHash ());
+
+            if (!part)
+            {
+                part = buildFetchPackPart (haveLedger, wantLedger);
+                mFetchPackParts.insert (haveLedger->getHash (), part);
+            }
+
+            objects += part->objects;
+            parts.push_back (std::move (part));
+
+            if (objects >= 512)
                 break;
 
             // move may save a ref/unref
@@ -3259,9 +3306,18 @@ void NetworkOPsImp::makeFetchPack (
         while (wantLedger &&
                UptimeTimer::getInstance ().getElapsedSeconds () <= uUptime + 1);
 
+        // Repeated fields may be appended to a serialized message, so the
+        // reply is the header followed by the serialized parts.
+        std::string const header = reply.SerializeAsString ();
+        std::vector <boost::asio::const_buffer> payload;
+        payload.reserve (parts.size () + 1);
+        payload.emplace_back (header.data (), header.size ());
+        for (auto const& part : parts)
+            payload.emplace_back (part->data.data (), part->data.size ());
+
         m_journal.info
-            << "Built fetch pack with " << reply.objects ().size () << " nodes";
-        auto msg = std::make_shared<Message> (reply, protocol::mtGET_OBJECTS);
+            << "Built fetch pack with " << objects << " nodes";
+        auto msg = std::make_shared<Message> (payload, protocol::mtGET_OBJECTS);
         peer->send (msg);
     }
     catch (...)
@@ -190,6 +190,12 @@ SHAMapStoreImp::SHAMapStoreImp (Setup const& setup,
                 std::to_string (setup_.ledgerHistory) + ")");
         }
 
+        if (setup_.nodeDatabase.exists ("ledgers_per_shard"))
+        {
+            throw std::runtime_error (
+                "online_delete cannot be used with ledgers_per_shard");
+        }
+
         state_db_.init (config, dbName_);
 
         dbPaths();
@@ -266,6 +272,7 @@ SHAMapStoreImp::run()
     netOPs_ = &getApp().getOPs();
     ledgerMaster_ = &getApp().getLedgerMaster();
     fullBelowCache_ = &getApp().family().fullbelow();
+    fullBelowStore_ = &getApp().family().fullbelowstore();
     treeNodeCache_ = &getApp().family().treecache();
     transactionDb_ = &getApp().getTxnDB();
     ledgerDb_ = &getApp().getLedgerDB();
@@ -548,6 +555,7 @@ SHAMapStoreImp::clearCaches (LedgerIndex validatedSeq)
 {
     ledgerMaster_->clearLedgerCachePrior (validatedSeq);
     fullBelowCache_->clear();
+    fullBelowStore_->clear();
 }
 
 void
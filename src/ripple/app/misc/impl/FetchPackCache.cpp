@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/impl/FetchPackCache.h>
+
+namespace ripple {
+
+FetchPackCache::FetchPackCache (std::size_t maxBytes)
+    : maxBytes_ (maxBytes)
+{
+}
+
+FetchPackCache::pointer
+FetchPackCache::fetch (uint256 const& haveLedgerHash)
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+
+    auto const iter = map_.find (haveLedgerHash);
+    if (iter == map_.end ())
+        return pointer ();
+
+    list_.splice (list_.begin (), list_, iter->second);
+    return iter->second->second;
+}
+
+void
+FetchPackCache::insert (uint256 const& haveLedgerHash, pointer const& part)
+{
+    std::size_t const partBytes = part->data.size ();
+
+    if (partBytes > maxBytes_)
+        return;
+
+    std::lock_guard <std::mutex> sl (mutex_);
+
+    if (map_.find (haveLedgerHash) != map_.end ())
+        return;
+
+    list_.emplace_front (haveLedgerHash, part);
+    map_.emplace (haveLedgerHash, list_.begin ());
+    bytes_ += partBytes;
+
+    while (bytes_ > maxBytes_)
+    {
+        auto const& oldest = list_.back ();
+        bytes_ -= oldest.second->data.size ();
+        map_.erase (oldest.first);
+        list_.pop_back ();
+    }
+}
+
+std::size_t
+FetchPackCache::size () const
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+    return map_.size ();
+}
+
+std::size_t
+FetchPackCache::bytes () const
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+    return bytes_;
+}
+
+} // ripple
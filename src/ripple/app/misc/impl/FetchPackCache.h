@@ -0,0 +1,98 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_APP_MISC_FETCHPACKCACHE_H_INCLUDED
+#define RIPPLE_APP_MISC_FETCHPACKCACHE_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace ripple {
+
+/** Parts of fetch packs already built for peers.
+
+    A fetch pack is made of one part for each ledger, holding the header
+    and the nodes which differ from the child ledger the peer has. A part
+    depends only on the hash of that child, so when several peers fall
+    behind on the same ledgers the parts are built once and shared.
+
+    Parts are kept already serialized, so a reply is assembled by copying
+    the bytes rather than by encoding the nodes again. The least recently
+    used parts are discarded to stay within a limit on the total size.
+*/
+class FetchPackCache
+{
+public:
+    struct Part
+    {
+        /** A TMGetObjectByHash holding only the objects of the part.
+            It lacks the required fields, so it is only valid when
+            appended to a serialized message which has them.
+        */
+        std::string data;
+
+        /** The number of objects in the part. */
+        std::size_t objects = 0;
+    };
+
+    using pointer = std::shared_ptr <Part const>;
+
+    /** Create the cache.
+        @param maxBytes The most serialized data to hold, or zero to
+                        hold nothing.
+    */
+    explicit
+    FetchPackCache (std::size_t maxBytes);
+
+    FetchPackCache (FetchPackCache const&) = delete;
+    FetchPackCache& operator= (FetchPackCache const&) = delete;
+
+    /** Return the part leading back from the specified ledger, if any. */
+    pointer fetch (uint256 const& haveLedgerHash);
+
+    /** Remember the part leading back from the specified ledger. */
+    void insert (uint256 const& haveLedgerHash, pointer const& part);
+
+    /** Return the number of parts held. */
+    std::size_t size () const;
+
+    /** Return the total size of the parts held. */
+    std::size_t bytes () const;
+
+private:
+    using List = std::list <std::pair <uint256, pointer>>;
+
+    std::size_t const maxBytes_;
+    mutable std::mutex mutex_;
+
+    // Most recently used first
+    List list_;
+    hash_map <uint256, List::iterator> map_;
+    std::size_t bytes_ = 0;
+};
+
+} // ripple
+
+#endif
@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/impl/FetchPackCache.h>
+#include <beast/unit_test/suite.h>
+
+namespace ripple {
+
+class FetchPackCache_test : public beast::unit_test::suite
+{
+    static FetchPackCache::pointer makePart (std::size_t bytes)
+    {
+        auto part = std::make_shared <FetchPackCache::Part> ();
+        part->data.assign (bytes, 'x');
+        part->objects = 1;
+        return part;
+    }
+
+public:
+    void testLimit ()
+    {
+        testcase ("limit");
+
+        FetchPackCache cache (1000);
+
+        uint256 const a (1), b (2), c (3), d (4);
+        cache.insert (a, makePart (400));
+        cache.insert (b, makePart (400));
+        expect (cache.size () == 2);
+        expect (cache.bytes () == 800);
+
+        // Using a makes b the oldest
+        expect (cache.fetch (a) != nullptr);
+        cache.insert (c, makePart (400));
+        expect (cache.fetch (b) == nullptr, "b discarded");
+        expect (cache.fetch (a) != nullptr);
+        expect (cache.fetch (c) != nullptr);
+        expect (cache.bytes () == 800);
+
+        // A part larger than the limit is not kept
+        cache.insert (d, makePart (1001));
+        expect (cache.fetch (d) == nullptr);
+        expect (cache.size () == 2);
+
+        FetchPackCache disabled (0);
+        disabled.insert (a, makePart (1));
+        expect (disabled.size () == 0);
+    }
+
+    void run ()
+    {
+        testLimit ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(FetchPackCache,app,ripple);
+
+} // ripple
@@ -27,6 +27,7 @@
 #include <ripple/basics/Log.h>
 #include <ripple/json/to_string.h>
 #include <ripple/core/JobQueue.h>
+#include <ripple/core/ParallelFor.h>
 #include <tuple>
 
 /*
@@ -520,17 +521,38 @@ void Pathfinder::rankPaths (
     // Ignore paths that move only very small amounts.
     auto saMinDstAmount = smallestUsefulAmount (mDstAmount, maxPaths);
 
+    struct Liquidity
+    {
+        TER result = tefEXCEPTION;
+        STAmount amount;
+        uint64_t quality = 0;
+    };
+
+    // Each candidate is evaluated in its own sandbox against the same
+    // ledger, so they can be evaluated at once.
+    std::vector <Liquidity> liquidity (paths.size ());
+
+    parallelFor (getApp ().getJobQueue (), jtUPDATE_PF, "Pathfinder::rankPaths",
+        paths.size (), std::min<std::size_t> (
+            paths.size () / PATHFINDER_PATHS_PER_HELPER,
+            PATHFINDER_MAX_HELPERS),
+        [&] (std::size_t i)
+        {
+            auto& l = liquidity[i];
+            if (! paths[i].empty ())
+                l.result = getPathLiquidity (
+                    paths[i], saMinDstAmount, l.amount, l.quality);
+        });
+
     for (int i = 0; i < paths.size (); ++i)
     {
         auto const& currentPath = paths[i];
-        STAmount liquidity;
-        uint64_t uQuality;
 
         if (currentPath.empty ())
             continue;
 
-        auto const resultCode = getPathLiquidity (
-            currentPath, saMinDstAmount, liquidity, uQuality);
+        auto const resultCode = liquidity[i].result;
+        auto const uQuality = liquidity[i].quality;
 
         if (resultCode != tesSUCCESS)
         {
@@ -544,7 +566,8 @@ void Pathfinder::rankPaths (
                 "findPaths: quality: " << uQuality <<
                 ": " << currentPath.getJson (0);
 
-            rankedPaths.push_back ({uQuality, currentPath.size (), liquidity, i});
+            rankedPaths.push_back (
+                {uQuality, currentPath.size (), liquidity[i].amount, i});
         }
     }
     std::sort (rankedPaths.begin (), rankedPaths.end (), comparePathRank);
@@ -30,6 +30,11 @@ int const PATHFINDER_MAX_PATHS = 50;
 int const PATHFINDER_MAX_COMPLETE_PATHS = 1000;
 int const PATHFINDER_MAX_PATHS_FROM_SOURCE = 10;
 
+// Candidate paths ranked by each job helping the pathfinder, and the most
+// jobs which may help one pathfinder.
+int const PATHFINDER_PATHS_PER_HELPER = 8;
+int const PATHFINDER_MAX_HELPERS = 4;
+
 } // ripple
 
 #endif
@@ -27,6 +27,7 @@
 #include <ripple/core/JobQueue.h>
 #include <ripple/protocol/RippleLedgerHash.h>
 #include <ripple/resource/Fees.h>
+#include <ripple/shamap/SHAMapNodeBatch.h>
 #include <beast/cxx14/memory.h> // <memory>
 
 namespace ripple {
@@ -157,11 +158,32 @@ public:
         }
 
         std::list<SHAMapNodeID> nodeIDs;
-        std::list< Blob > nodeData;
+        std::list<Slice> nodeData;
+
+        // Holds the nodes of a compressed batch
+        Blob unpacked;
+
+        if (packet.has_packednodes ())
+        {
+            std::vector<SHAMapNodeID> packedIDs;
+            std::vector<Slice> packedData;
+
+            if (packet.packednodes ().empty () ||
+                !unpackNodes (makeSlice (packet.packednodes ()), unpacked,
+                    packedIDs, packedData))
+            {
+                peer->charge (Resource::feeInvalidRequest);
+                return;
+            }
+
+            nodeIDs.assign (packedIDs.begin (), packedIDs.end ());
+            nodeData.assign (packedData.begin (), packedData.end ());
+        }
+
         for (auto const &node : packet.nodes())
         {
             if (!node.has_nodeid () || !node.has_nodedata () || (
-                node.nodeid ().size () != 33))
+                node.nodeid ().size () != 33) || node.nodedata ().empty ())
             {
                 peer->charge (Resource::feeInvalidRequest);
                 return;
@@ -169,8 +191,7 @@ public:
 
             nodeIDs.emplace_back (node.nodeid ().data (),
                                static_cast<int>(node.nodeid ().size ()));
-            nodeData.emplace_back (node.nodedata ().begin (),
-                node.nodedata ().end ());
+            nodeData.push_back (makeSlice (node.nodedata ()));
         }
 
         if (! ta->takeNodes (nodeIDs, nodeData, peer).isUseful ())
@@ -47,7 +47,7 @@ public:
     }
 
     SHAMapAddNode takeNodes (const std::list<SHAMapNodeID>& IDs,
-                             const std::list< Blob >& data, Peer::ptr const&);
+                             const std::list<Slice>& data, Peer::ptr const&);
 
     void init (int startPeers);
 
@@ -84,6 +84,21 @@ std::pair<TER, bool>
 TransactionEngine::applyTransaction (
     STTx const& txn,
     TransactionEngineParams params)
+{
+    auto const result = calculate (txn, params);
+
+    if (result.second)
+        commit (txn, params);
+
+    mNodes.clear ();
+
+    return result;
+}
+
+std::pair<TER, bool>
+TransactionEngine::calculate (
+    STTx const& txn,
+    TransactionEngineParams params)
 {
     assert (mLedger);
 
@@ -213,47 +228,59 @@ TransactionEngine::applyTransaction (
     {
         // Transaction succeeded fully or (retries are not allowed and the
         // transaction could claim a fee)
-        Serializer m;
-        mNodes.calcRawMeta (m, terResult, mTxnSeq++);
+        mMeta.erase ();
+        mNodes.calcRawMeta (mMeta, terResult, mTxnSeq++);
+    }
+    else
+    {
+        mNodes.clear ();
+    }
 
-        txnWrite ();
+    if (!(params & tapOPEN_LEDGER) && isTemMalformed (terResult))
+    {
+        // XXX Malformed or failed transaction in closed ledger must bow out.
+    }
 
-        Serializer s;
-        txn.add (s);
+    return { terResult, didApply };
+}
 
-        if (params & tapOPEN_LEDGER)
-        {
-            if (!mLedger->addTransaction (txID, s))
-            {
-                WriteLog (lsFATAL, TransactionEngine) <<
-                    "Duplicate transaction applied";
-                assert (false);
-                throw std::runtime_error ("Duplicate transaction applied");
-            }
-        }
-        else
-        {
-            if (!mLedger->addTransaction (txID, s, m))
-            {
-                WriteLog (lsFATAL, TransactionEngine) <<
-                    "Duplicate transaction applied to closed ledger";
-                assert (false);
-                throw std::runtime_error ("Duplicate transaction applied to closed ledger");
-            }
+void
+TransactionEngine::commit (
+    STTx const& txn,
+    TransactionEngineParams params)
+{
+    assert (mLedger);
 
-            // Charge whatever fee they specified.
-            mLedger->destroyCoins (getNValue (txn.getTransactionFee ()));
-        }
-    }
+    uint256 const& txID = txn.getTransactionID ();
 
-    mNodes.clear ();
+    txnWrite ();
 
-    if (!(params & tapOPEN_LEDGER) && isTemMalformed (terResult))
+    Serializer s;
+    txn.add (s);
+
+    if (params & tapOPEN_LEDGER)
     {
-        // XXX Malformed or failed transaction in closed ledger must bow out.
+        if (!mLedger->addTransaction (txID, s))
+        {
+            WriteLog (lsFATAL, TransactionEngine) <<
+                "Duplicate transaction applied";
+            assert (false);
+            throw std::runtime_error ("Duplicate transaction applied");
+        }
     }
+    else
+    {
+        if (!mLedger->addTransaction (txID, s, mMeta))
+        {
+            WriteLog (lsFATAL, TransactionEngine) <<
+                "Duplicate transaction applied to closed ledger";
+            assert (false);
+            throw std::runtime_error ("Duplicate transaction applied to closed ledger");
+        }
 
-    return { terResult, didApply };
+        // Charge whatever fee they specified.
+        mLedger->destroyCoins (getNValue (txn.getTransactionFee ()));
+    }
 }
 
 bool
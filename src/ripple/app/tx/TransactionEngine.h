@@ -39,6 +39,7 @@ public:
 
 private:
     LedgerEntrySet mNodes;
+    Serializer mMeta;
 
     void txnWrite ();
 
@@ -77,6 +78,20 @@ public:
     std::pair<TER, bool>
     applyTransaction (STTx const&, TransactionEngineParams);
 
+    /** Apply a transaction to view() without changing the ledger.
+        If the transaction applies, its changes stay in view() until
+        commit() writes them to the ledger or the view is cleared.
+    */
+    std::pair<TER, bool>
+    calculate (STTx const&, TransactionEngineParams);
+
+    /** Write the changes made by a successful calculate() to the ledger.
+        The ledger may be a later version of the one the changes were
+        calculated against, provided nothing the transaction read changed.
+    */
+    void
+    commit (STTx const&, TransactionEngineParams);
+
     bool
     checkInvariants (TER result, STTx const& txn, TransactionEngineParams params);
 };
@@ -23,6 +23,7 @@
 #include <beast/utility/noexcept.h>
 #include <beast/utility/static_initializer.h>
 #include <atomic>
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
@@ -40,6 +41,12 @@ public:
 
     List getCounts (int minimumThreshold) const;
 
+    typedef std::pair <std::string, std::uint64_t> Total;
+    typedef std::vector <Total> TotalList;
+
+    /** Returns the number of instances ever constructed, for each type. */
+    TotalList getTotals () const;
+
 public:
     /** Implementation for @ref CountedObject.
 
@@ -54,6 +61,7 @@ public:
 
         int increment () noexcept
         {
+            m_created.fetch_add (1, std::memory_order_relaxed);
             return ++m_count;
         }
 
@@ -67,6 +75,11 @@ public:
             return m_count.load ();
         }
 
+        std::uint64_t getCreated () const noexcept
+        {
+            return m_created.load (std::memory_order_relaxed);
+        }
+
         CounterBase* getNext () const noexcept
         {
             return m_next;
@@ -79,6 +92,7 @@ public:
 
     protected:
         std::atomic <int> m_count;
+        std::atomic <std::uint64_t> m_created;
         CounterBase* m_next;
     };
 
@@ -0,0 +1,362 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_FLATMAP_H_INCLUDED
+#define RIPPLE_BASICS_FLATMAP_H_INCLUDED
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+/** An associative container stored in one contiguous, shared array.
+
+    Elements live in a vector made of a sorted body followed by a short,
+    unsorted tail of recent insertions. Lookups binary search the body and
+    scan the tail. The tail is merged into the body when it grows past a
+    small bound, or when an ordered view is requested through begin() or
+    upper_bound(). end() never reorders, so it may be compared against the
+    result of find().
+
+    Copies share the array. The first mutating access through a copy that
+    is not the sole owner makes a private copy, so taking a checkpoint is
+    O(1) and costs a single allocation when it is finally written to.
+
+    Unlike std::map, iterators are invalidated by insertion, erasure and by
+    requesting an ordered view after an insertion. Instances must not be
+    shared between threads without external synchronization.
+*/
+template <
+    class Key,
+    class T,
+    class Compare = std::less <Key>
+>
+class FlatMap
+{
+public:
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef std::pair <Key, T> value_type;
+
+private:
+    typedef std::vector <value_type> Items;
+
+    // Tail length at which insertion merges into the sorted body
+    static std::size_t const maxUnsorted = 16;
+
+    struct Storage
+    {
+        Items items;
+        std::size_t sorted = 0;     // Length of the sorted body
+    };
+
+public:
+    typedef typename Items::iterator iterator;
+    typedef typename Items::const_iterator const_iterator;
+    typedef typename Items::size_type size_type;
+
+    FlatMap ()
+        : storage_ (std::make_shared <Storage> ())
+    {
+    }
+
+    FlatMap (FlatMap const&) = default;
+    FlatMap& operator= (FlatMap const&) = default;
+
+    FlatMap (FlatMap&& other)
+        : storage_ (std::move (other.storage_))
+    {
+        other.storage_ = std::make_shared <Storage> ();
+    }
+
+    FlatMap& operator= (FlatMap&& other)
+    {
+        storage_.swap (other.storage_);
+        return *this;
+    }
+
+    bool empty () const
+    {
+        return storage_->items.empty ();
+    }
+
+    size_type size () const
+    {
+        return storage_->items.size ();
+    }
+
+    void reserve (size_type n)
+    {
+        unshare ();
+        storage_->items.reserve (n);
+    }
+
+    void clear ()
+    {
+        if (storage_.unique ())
+        {
+            storage_->items.clear ();
+            storage_->sorted = 0;
+        }
+        else
+        {
+            storage_ = std::make_shared <Storage> ();
+        }
+    }
+
+    void swap (FlatMap& other)
+    {
+        storage_.swap (other.storage_);
+    }
+
+    /** Return `true` if this instance is the only owner of its elements. */
+    bool unique () const
+    {
+        return storage_.unique ();
+    }
+
+    //--------------------------------------------------------------------------
+
+    /** Ordered iteration. */
+    /** @{ */
+    iterator begin ()
+    {
+        order ();
+        return storage_->items.begin ();
+    }
+
+    iterator end ()
+    {
+        return storage_->items.end ();
+    }
+
+    const_iterator begin () const
+    {
+        order ();
+        return storage_->items.cbegin ();
+    }
+
+    const_iterator end () const
+    {
+        return storage_->items.cend ();
+    }
+
+    const_iterator cbegin () const
+    {
+        return begin ();
+    }
+
+    const_iterator cend () const
+    {
+        return end ();
+    }
+    /** @} */
+
+    //--------------------------------------------------------------------------
+
+    /** Find an element without reordering.
+        The non-const overload takes private ownership so that the
+        element may be modified.
+    */
+    /** @{ */
+    iterator find (key_type const& key)
+    {
+        unshare ();
+        auto& items = storage_->items;
+        return items.begin () + findIndex (key);
+    }
+
+    const_iterator find (key_type const& key) const
+    {
+        auto const& items = storage_->items;
+        return items.cbegin () + findIndex (key);
+    }
+    /** @} */
+
+    size_type count (key_type const& key) const
+    {
+        return (find (key) == storage_->items.cend ()) ? 0 : 1;
+    }
+
+    /** Return the first element whose key is greater than `key`. */
+    const_iterator upper_bound (key_type const& key) const
+    {
+        order ();
+        auto const& items = storage_->items;
+        return std::upper_bound (items.cbegin (), items.cend (), key,
+            [](key_type const& k, value_type const& v)
+            {
+                return Compare () (k, v.first);
+            });
+    }
+
+    /** Insert an element if its key is not already present.
+        @return An iterator to the element with the key, and `true` if
+                the element was inserted.
+    */
+    std::pair <iterator, bool> insert (value_type const& value)
+    {
+        unshare ();
+        auto& s = *storage_;
+
+        std::size_t const index = findIndex (value.first);
+        if (index != s.items.size ())
+            return std::make_pair (s.items.begin () + index, false);
+
+        s.items.push_back (value);
+
+        if ((s.items.size () - s.sorted) < maxUnsorted)
+            return std::make_pair (s.items.end () - 1, true);
+
+        merge (s);
+        return std::make_pair (s.items.begin () +
+            findIndex (value.first), true);
+    }
+
+    /** Remove the element at the specified position. */
+    void erase (iterator pos)
+    {
+        assert (storage_.unique ());
+        auto& s = *storage_;
+        std::size_t const index = pos - s.items.begin ();
+        s.items.erase (pos);
+        if (index < s.sorted)
+            --s.sorted;
+    }
+
+    /** Insert every element of `other`, replacing elements with equal keys.
+        This is linear in the combined size.
+    */
+    void overlay (FlatMap const& other)
+    {
+        if (other.empty ())
+            return;
+
+        order ();
+        other.order ();
+
+        auto const& lhs = storage_->items;
+        auto const& rhs = other.storage_->items;
+
+        auto merged = std::make_shared <Storage> ();
+        merged->items.reserve (lhs.size () + rhs.size ());
+
+        auto i = lhs.begin ();
+        auto j = rhs.begin ();
+        while (i != lhs.end () && j != rhs.end ())
+        {
+            if (less (*i, *j))
+            {
+                merged->items.push_back (*i++);
+            }
+            else
+            {
+                if (! less (*j, *i))
+                    ++i;
+                merged->items.push_back (*j++);
+            }
+        }
+        merged->items.insert (merged->items.end (), i, lhs.end ());
+        merged->items.insert (merged->items.end (), j, rhs.end ());
+        merged->sorted = merged->items.size ();
+
+        storage_ = std::move (merged);
+    }
+
+    /** Remove every element for which `pred` returns `true`. */
+    template <class Predicate>
+    void erase_if (Predicate pred)
+    {
+        unshare ();
+        order ();
+        auto& items = storage_->items;
+        items.erase (std::remove_if (items.begin (), items.end (), pred),
+            items.end ());
+        storage_->sorted = items.size ();
+    }
+
+private:
+    void unshare () const
+    {
+        if (! storage_.unique ())
+            storage_ = std::make_shared <Storage> (*storage_);
+    }
+
+    // Make the whole array sorted. This is logically const, but a shared
+    // array is never reordered underneath another owner.
+    void order () const
+    {
+        if (storage_->sorted == storage_->items.size ())
+            return;
+
+        unshare ();
+        merge (*storage_);
+    }
+
+    static bool less (value_type const& lhs, value_type const& rhs)
+    {
+        return Compare () (lhs.first, rhs.first);
+    }
+
+    static void merge (Storage& s)
+    {
+        auto const middle = s.items.begin () + s.sorted;
+        std::sort (middle, s.items.end (), &FlatMap::less);
+        std::inplace_merge (s.items.begin (), middle, s.items.end (),
+            &FlatMap::less);
+        s.sorted = s.items.size ();
+    }
+
+    // Returns the index of the element with the key, or size() if absent
+    std::size_t findIndex (key_type const& key) const
+    {
+        Compare const comp;
+        auto const& s = *storage_;
+        auto const body = s.items.begin () + s.sorted;
+
+        auto it = std::lower_bound (s.items.begin (), body, key,
+            [&comp](value_type const& v, key_type const& k)
+            {
+                return comp (v.first, k);
+            });
+
+        if (it != body && ! comp (key, it->first))
+            return it - s.items.begin ();
+
+        for (it = body; it != s.items.end (); ++it)
+        {
+            if (! comp (it->first, key) && ! comp (key, it->first))
+                return it - s.items.begin ();
+        }
+
+        return s.items.size ();
+    }
+
+    // Mutable so that ordering from a const member function
+    // can take private ownership first
+    mutable std::shared_ptr <Storage> storage_;
+};
+
+} // ripple
+
+#endif
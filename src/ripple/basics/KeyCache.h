@@ -26,6 +26,7 @@
 #include <beast/chrono/chrono_io.h>
 #include <beast/Insight.h>
 #include <mutex>
+#include <utility>
 
 namespace ripple {
 
@@ -156,6 +157,13 @@ public:
         m_map.clear ();
     }
 
+    /** Returns the cumulative number of hits and misses. */
+    std::pair <std::uint64_t, std::uint64_t> getHitsAndMisses () const
+    {
+        lock_guard lock (m_mutex);
+        return std::make_pair (m_stats.hits, m_stats.misses);
+    }
+
     void setTargetSize (size_type s)
     {
         lock_guard lock (m_mutex);
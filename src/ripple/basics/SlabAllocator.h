@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_BASICS_SLABALLOCATOR_H_INCLUDED
+#define RIPPLE_BASICS_SLABALLOCATOR_H_INCLUDED
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+/** Hands out blocks of one size carved from larger slabs.
+
+    Freed blocks are kept on a list for reuse and slabs are only released
+    when the allocator is destroyed, so allocating and freeing many small
+    objects of similar size costs neither a call into the general purpose
+    allocator nor its per-block overhead.
+
+    All member functions are thread safe.
+*/
+class SlabAllocator
+{
+public:
+    /** Create an allocator.
+        @param blockSize The size of each block, in bytes.
+        @param blocksPerSlab The number of blocks to carve from each slab.
+    */
+    SlabAllocator (std::size_t blockSize, std::size_t blocksPerSlab)
+        : blockSize_ (round (blockSize))
+        , blocksPerSlab_ (blocksPerSlab)
+    {
+        assert (blocksPerSlab_ > 0);
+    }
+
+    SlabAllocator (SlabAllocator const&) = delete;
+    SlabAllocator& operator= (SlabAllocator const&) = delete;
+
+    /** Return the size of the blocks, which may be larger than requested. */
+    std::size_t size () const
+    {
+        return blockSize_;
+    }
+
+    /** Return a block, which is suitably aligned for any type. */
+    void* allocate ()
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+
+        if (free_ == nullptr)
+            grow ();
+
+        Free* const block = free_;
+        free_ = block->next;
+        return block;
+    }
+
+    /** Return a block obtained from allocate() for reuse. */
+    void deallocate (void* p)
+    {
+        assert (p != nullptr);
+        Free* const block = static_cast <Free*> (p);
+
+        std::lock_guard <std::mutex> lock (mutex_);
+        block->next = free_;
+        free_ = block;
+    }
+
+private:
+    struct Free
+    {
+        Free* next;
+    };
+
+    // Round up so that every block stays aligned
+    static std::size_t round (std::size_t size)
+    {
+        std::size_t const align = alignof (std::max_align_t);
+        if (size < sizeof (Free))
+            size = sizeof (Free);
+        return (size + align - 1) / align * align;
+    }
+
+    // Carve a new slab into free blocks. The caller holds the lock.
+    void grow ()
+    {
+        std::unique_ptr <std::uint8_t[]> slab (
+            new std::uint8_t [blockSize_ * blocksPerSlab_]);
+
+        for (std::size_t i = blocksPerSlab_; i-- > 0;)
+        {
+            Free* const block = reinterpret_cast <Free*> (
+                slab.get () + i * blockSize_);
+            block->next = free_;
+            free_ = block;
+        }
+
+        slabs_.push_back (std::move (slab));
+    }
+
+    std::size_t const blockSize_;
+    std::size_t const blocksPerSlab_;
+
+    std::mutex mutex_;
+    Free* free_ = nullptr;
+    std::vector <std::unique_ptr <std::uint8_t[]>> slabs_;
+};
+
+} // ripple
+
+#endif
@@ -24,6 +24,9 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
 
 namespace ripple {
 
@@ -96,6 +99,13 @@ operator== (Slice const& lhs, Slice const& rhs) noexcept
             lhs.data(), rhs.data(), lhs.size()) == 0;
 }
 
+inline
+bool
+operator!= (Slice const& lhs, Slice const& rhs) noexcept
+{
+    return ! (lhs == rhs);
+}
+
 inline
 bool
 operator< (Slice const& lhs, Slice const& rhs) noexcept
@@ -105,6 +115,23 @@ operator< (Slice const& lhs, Slice const& rhs) noexcept
             rhs.data(), rhs.data() + rhs.size());
 }
 
+/** Return a Slice over the contents of a non-empty container. */
+template <class T, class Alloc>
+inline
+Slice
+makeSlice (std::vector<T, Alloc> const& v)
+{
+    return Slice(v.data(), v.size() * sizeof(T));
+}
+
+template <class Traits, class Alloc>
+inline
+Slice
+makeSlice (std::basic_string<char, Traits, Alloc> const& s)
+{
+    return Slice(s.data(), s.size());
+}
+
 } // ripple
 
 #endif
@@ -27,6 +27,7 @@
 #include <beast/Insight.h>
 #include <functional>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 namespace ripple {
@@ -146,6 +147,13 @@ public:
         return m_hits * (100.0f / std::max (1.0f, total));
     }
 
+    /** Return the cumulative number of hits and misses. */
+    std::pair <std::uint64_t, std::uint64_t> getHitsAndMisses () const
+    {
+        lock_guard lock (m_mutex);
+        return std::make_pair (m_hits, m_misses);
+    }
+
     void clearStats ()
     {
         lock_guard lock (m_mutex);
@@ -69,10 +69,26 @@ CountedObjects::List CountedObjects::getCounts (int minimumThreshold) const
     return counts;
 }
 
+CountedObjects::TotalList CountedObjects::getTotals () const
+{
+    TotalList totals;
+
+    totals.reserve (m_count.load ());
+
+    for (CounterBase* counter = m_head.load ();
+        counter != nullptr; counter = counter->getNext ())
+    {
+        totals.emplace_back (counter->getName (), counter->getCreated ());
+    }
+
+    return totals;
+}
+
 //------------------------------------------------------------------------------
 
 CountedObjects::CounterBase::CounterBase ()
     : m_count (0)
+    , m_created (0)
 {
     // Insert ourselves at the front of the lock-free linked list
 
@@ -0,0 +1,166 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/basics/FlatMap.h>
+#include <beast/unit_test/suite.h>
+#include <map>
+#include <random>
+
+namespace ripple {
+
+class FlatMap_test : public beast::unit_test::suite
+{
+public:
+    typedef FlatMap <int, int> Map;
+
+    bool matches (Map const& m, std::map <int, int> const& ref)
+    {
+        if (m.size () != ref.size ())
+            return false;
+        return std::equal (m.begin (), m.end (), ref.begin (),
+            [](Map::value_type const& a, std::pair <int const, int> const& b)
+            {
+                return a.first == b.first && a.second == b.second;
+            });
+    }
+
+    void testInsertFind ()
+    {
+        testcase ("insert and find");
+
+        std::mt19937 gen (42);
+        std::uniform_int_distribution <int> dist (0, 200);
+
+        Map m;
+        std::map <int, int> ref;
+
+        for (int i = 0; i < 500; ++i)
+        {
+            int const k = dist (gen);
+            auto const result = m.insert (std::make_pair (k, i));
+            auto const expected = ref.insert (std::make_pair (k, i));
+            expect (result.second == expected.second);
+            expect (result.first->first == k);
+            expect (result.first->second == expected.first->second);
+
+            int const probe = dist (gen);
+            expect ((m.find (probe) != m.end ()) == (ref.count (probe) != 0));
+        }
+
+        expect (matches (m, ref));
+
+        for (int k = 0; k <= 200; k += 3)
+        {
+            auto it = m.find (k);
+            if (it != m.end ())
+                m.erase (it);
+            ref.erase (k);
+        }
+
+        expect (matches (m, ref));
+
+        Map const& cm = m;
+        for (int k = -1; k <= 201; ++k)
+        {
+            auto const it = cm.upper_bound (k);
+            auto const rit = ref.upper_bound (k);
+            expect ((it == cm.end ()) == (rit == ref.end ()));
+            if (it != cm.end () && rit != ref.end ())
+                expect (it->first == rit->first);
+        }
+    }
+
+    void testCopyOnWrite ()
+    {
+        testcase ("copy on write");
+
+        Map a;
+        for (int i = 10; i > 0; --i)
+            a.insert (std::make_pair (i, i));
+
+        Map b (a);
+        expect (! a.unique () && ! b.unique ());
+
+        // Reading through a const reference does not copy
+        Map const& cb = b;
+        expect (cb.find (5) != cb.end ());
+        expect (! b.unique ());
+
+        // Writing does
+        b.find (5)->second = 50;
+        expect (a.unique () && b.unique ());
+        expect (a.find (5)->second == 5);
+        expect (b.find (5)->second == 50);
+
+        Map c (a);
+        c.clear ();
+        expect (c.empty () && a.size () == 10);
+
+        a.swap (c);
+        expect (a.empty () && c.size () == 10);
+    }
+
+    void testOverlay ()
+    {
+        testcase ("overlay");
+
+        Map lower;
+        for (int i = 0; i < 40; i += 2)
+            lower.insert (std::make_pair (i, i));
+
+        Map upper;
+        for (int i = 30; i < 50; i += 3)
+            upper.insert (std::make_pair (i, -i));
+
+        std::map <int, int> ref (lower.begin (), lower.end ());
+        for (auto const& v : upper)
+            ref[v.first] = v.second;
+
+        Map merged (lower);
+        merged.overlay (upper);
+        expect (matches (merged, ref));
+        expect (lower.size () == 20);
+
+        merged.erase_if ([](Map::value_type const& v)
+            {
+                return v.second < 0;
+            });
+        for (auto it = ref.begin (); it != ref.end (); )
+        {
+            if (it->second < 0)
+                it = ref.erase (it);
+            else
+                ++it;
+        }
+        expect (matches (merged, ref));
+        expect (lower.size () == 20);
+    }
+
+    void run ()
+    {
+        testInsertFind ();
+        testCopyOnWrite ();
+        testOverlay ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(FlatMap,ripple_basics,ripple);
+
+} // ripple
@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/basics/SlabAllocator.h>
+#include <beast/unit_test/suite.h>
+#include <cstring>
+#include <set>
+#include <vector>
+
+namespace ripple {
+
+class SlabAllocator_test : public beast::unit_test::suite
+{
+public:
+    void testAllocate ()
+    {
+        testcase ("allocate");
+
+        SlabAllocator slab (100, 16);
+        expect (slab.size () >= 100);
+        expect (slab.size () % alignof (std::max_align_t) == 0);
+
+        // Span several slabs and check that blocks never overlap
+        std::vector <void*> blocks;
+        std::set <std::uint8_t*> seen;
+        for (int i = 0; i < 100; ++i)
+        {
+            void* const p = slab.allocate ();
+            expect (seen.insert (static_cast <std::uint8_t*> (p)).second);
+            std::memset (p, i, slab.size ());
+            blocks.push_back (p);
+        }
+
+        std::uint8_t* last = nullptr;
+        for (auto const p : seen)
+        {
+            if (last != nullptr)
+                expect (p - last >= static_cast <std::ptrdiff_t> (slab.size ()));
+            last = p;
+        }
+
+        for (int i = 0; i < 100; ++i)
+        {
+            auto const p = static_cast <std::uint8_t*> (blocks[i]);
+            expect (p[0] == i && p[slab.size () - 1] == i);
+        }
+
+        for (auto const p : blocks)
+            slab.deallocate (p);
+    }
+
+    void testReuse ()
+    {
+        testcase ("reuse");
+
+        SlabAllocator slab (48, 4);
+        void* const a = slab.allocate ();
+        void* const b = slab.allocate ();
+        slab.deallocate (a);
+        expect (slab.allocate () == a);
+        slab.deallocate (b);
+        expect (slab.allocate () == b);
+    }
+
+    void run ()
+    {
+        testAllocate ();
+        testReuse ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SlabAllocator,ripple_basics,ripple);
+
+} // ripple
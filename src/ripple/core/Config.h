@@ -204,6 +204,17 @@ public:
     */
     bool                        RUN_STANDALONE;
 
+    /** Apply submitted transactions to a snapshot of the open ledger before
+        taking the master lock, keeping the result if it is still valid.
+    */
+    bool                        OPTIMISTIC_APPLY;
+
+    /** Build each new open ledger from the results recorded while building
+        the previous one, applying again only transactions that could be
+        affected by the ledger that closed.
+    */
+    bool                        OPEN_LEDGER_REUSE;
+
     // Note: The following parameters do not relate to the UNL or trust at all
     std::size_t                 NETWORK_QUORUM;         // Minimum number of nodes to consider the network present
     int                         VALIDATION_QUORUM;      // Minimum validations to consider ledger authoritative
@@ -244,7 +255,10 @@ public:
     // Node storage configuration
     std::uint32_t                      LEDGER_HISTORY;
     std::uint32_t                      FETCH_DEPTH;
+    std::uint32_t                      FETCH_PACK_CACHE;       // Megabytes of fetch packs kept for peers
+    std::uint32_t                      FETCH_WINDOW;           // Ledger node requests outstanding per peer
     int                         NODE_SIZE;
+    std::uint64_t               MEMORY_BUDGET;          // Megabytes shared by the caches, 0 for fixed sizes
 
     // Client behavior
     int                         ACCOUNT_PROBE_MAX;      // How far to scan for accounts.
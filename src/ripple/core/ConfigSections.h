@@ -44,13 +44,18 @@ struct ConfigSection
 #define SECTION_FEE_ACCOUNT_RESERVE     "fee_account_reserve"
 #define SECTION_FEE_OWNER_RESERVE       "fee_owner_reserve"
 #define SECTION_FETCH_DEPTH             "fetch_depth"
+#define SECTION_FETCH_PACK_CACHE        "fetch_pack_cache"
+#define SECTION_FETCH_WINDOW            "fetch_window"
 #define SECTION_LEDGER_HISTORY          "ledger_history"
 #define SECTION_INSIGHT                 "insight"
 #define SECTION_IPS                     "ips"
 #define SECTION_IPS_FIXED               "ips_fixed"
+#define SECTION_MEMORY_BUDGET           "memory_budget"
 #define SECTION_NETWORK_QUORUM          "network_quorum"
 #define SECTION_NODE_SEED               "node_seed"
 #define SECTION_NODE_SIZE               "node_size"
+#define SECTION_OPEN_LEDGER_REUSE       "open_ledger_reuse"
+#define SECTION_OPTIMISTIC_APPLY        "optimistic_apply"
 #define SECTION_PATH_SEARCH_OLD         "path_search_old"
 #define SECTION_PATH_SEARCH             "path_search"
 #define SECTION_PATH_SEARCH_FAST        "path_search_fast"
@@ -38,6 +38,10 @@ public:
     {
         int maxLimit = std::numeric_limits <int>::max ();
 
+        // Check that a ledger's nodes are all present
+        add (jtWALK,          "walkLedger",
+            maxLimit, true,   false, 0,     0);
+
         // Make a fetch pack for a peer
         add (jtPACK,          "makeFetchPack",
             1,        true,   false, 0,     0);
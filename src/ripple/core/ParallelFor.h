@@ -0,0 +1,48 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_CORE_PARALLELFOR_H_INCLUDED
+#define RIPPLE_CORE_PARALLELFOR_H_INCLUDED
+
+#include <ripple/core/JobQueue.h>
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace ripple {
+
+/** Call `f (i)` for each `i` in [0, n), spread across the job queue.
+
+    Up to `helpers` jobs of the given type are added to share the work, and
+    the calling thread works as well. This returns once every call has
+    completed, without waiting for helpers which never got to run, so a
+    busy job queue only makes it slower. If a call throws, the remaining
+    calls are skipped and the first exception is rethrown here.
+
+    Calls are made concurrently and in no particular order, so results
+    should be stored by index.
+*/
+void parallelFor (JobQueue& jobQueue, JobType type, std::string const& name,
+    std::size_t n, std::size_t helpers,
+        std::function <void (std::size_t)> f);
+
+} // ripple
+
+#endif
@@ -217,6 +217,8 @@ Config::Config ()
 
     LEDGER_HISTORY          = 256;
     FETCH_DEPTH             = 1000000000;
+    FETCH_PACK_CACHE        = 32;
+    FETCH_WINDOW            = 4;
 
     // An explanation of these magical values would be nice.
     PATH_SEARCH_OLD         = 7;
@@ -232,6 +234,8 @@ Config::Config ()
 
     ELB_SUPPORT             = false;
     RUN_STANDALONE          = false;
+    OPTIMISTIC_APPLY        = false;
+    OPEN_LEDGER_REUSE       = false;
     doImport                = false;
     START_UP                = NORMAL;
 }
@@ -264,6 +268,7 @@ void Config::setup (std::string const& strConf, bool bQuiet)
 
     QUIET       = bQuiet;
     NODE_SIZE   = 0;
+    MEMORY_BUDGET = 0;
 
     strDbPath           = Helpers::getDatabaseDirName ();
     strConfFile         = strConf.empty () ? Helpers::getConfigFileName () : strConf;
@@ -452,6 +457,9 @@ void Config::loadFromString (std::string const& fileContents)
         }
     }
 
+    if (getSingleSection (secConfig, SECTION_MEMORY_BUDGET, strTemp))
+        MEMORY_BUDGET       = beast::lexicalCastThrow <std::uint64_t> (strTemp);
+
     if (getSingleSection (secConfig, SECTION_ELB_SUPPORT, strTemp))
         ELB_SUPPORT         = beast::lexicalCastThrow <bool> (strTemp);
 
@@ -464,6 +472,12 @@ void Config::loadFromString (std::string const& fileContents)
     if (getSingleSection (secConfig, SECTION_SSL_VERIFY, strTemp))
         SSL_VERIFY          = beast::lexicalCastThrow <bool> (strTemp);
 
+    if (getSingleSection (secConfig, SECTION_OPTIMISTIC_APPLY, strTemp))
+        OPTIMISTIC_APPLY    = beast::lexicalCastThrow <bool> (strTemp);
+
+    if (getSingleSection (secConfig, SECTION_OPEN_LEDGER_REUSE, strTemp))
+        OPEN_LEDGER_REUSE   = beast::lexicalCastThrow <bool> (strTemp);
+
     if (getSingleSection (secConfig, SECTION_VALIDATION_SEED, strTemp))
     {
         VALIDATION_SEED.setSeedGeneric (strTemp);
@@ -534,6 +548,17 @@ void Config::loadFromString (std::string const& fileContents)
             FETCH_DEPTH = 10;
     }
 
+    if (getSingleSection (secConfig, SECTION_FETCH_PACK_CACHE, strTemp))
+        FETCH_PACK_CACHE    = beast::lexicalCastThrow <std::uint32_t> (strTemp);
+
+    if (getSingleSection (secConfig, SECTION_FETCH_WINDOW, strTemp))
+    {
+        FETCH_WINDOW        = beast::lexicalCastThrow <std::uint32_t> (strTemp);
+
+        if (FETCH_WINDOW < 1)
+            FETCH_WINDOW = 1;
+    }
+
     if (getSingleSection (secConfig, SECTION_PATH_SEARCH_OLD, strTemp))
         PATH_SEARCH_OLD     = beast::lexicalCastThrow <int> (strTemp);
     if (getSingleSection (secConfig, SECTION_PATH_SEARCH, strTemp))
@@ -0,0 +1,114 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/core/ParallelFor.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+namespace ripple {
+
+namespace {
+
+// Shared with the helpers, which may run after parallelFor returns
+struct ParallelWork
+{
+    ParallelWork (std::size_t n_, std::function <void (std::size_t)> f_)
+        : f (std::move (f_))
+        , n (n_)
+        , next (0)
+        , failed (false)
+        , done (0)
+    {
+    }
+
+    // Claim calls until none are left. After a failure the remaining
+    // calls are still claimed, but skipped.
+    void run ()
+    {
+        std::size_t i;
+        while ((i = next++) < n)
+        {
+            if (! failed)
+            {
+                try
+                {
+                    f (i);
+                }
+                catch (...)
+                {
+                    std::lock_guard <std::mutex> lock (mutex);
+                    if (! error)
+                        error = std::current_exception ();
+                    failed = true;
+                }
+            }
+
+            std::lock_guard <std::mutex> lock (mutex);
+            if (++done == n)
+                cond.notify_all ();
+        }
+    }
+
+    void wait ()
+    {
+        std::unique_lock <std::mutex> lock (mutex);
+        cond.wait (lock, [this] { return done == n; });
+        if (error)
+            std::rethrow_exception (error);
+    }
+
+    std::function <void (std::size_t)> const f;
+    std::size_t const n;
+    std::atomic <std::size_t> next;
+    std::atomic <bool> failed;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::size_t done;
+    std::exception_ptr error;
+};
+
+}
+
+void parallelFor (JobQueue& jobQueue, JobType type, std::string const& name,
+    std::size_t n, std::size_t helpers,
+        std::function <void (std::size_t)> f)
+{
+    if (n == 0)
+        return;
+
+    auto work = std::make_shared <ParallelWork> (n, std::move (f));
+
+    for (std::size_t i = 0; i < std::min (helpers, n - 1); ++i)
+    {
+        jobQueue.addJob (type, name,
+            [work] (Job&) { work->run (); });
+    }
+
+    work->run ();
+    work->wait ();
+}
+
+} // ripple
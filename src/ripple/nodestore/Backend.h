@@ -21,6 +21,7 @@
 #define RIPPLE_NODESTORE_BACKEND_H_INCLUDED
 
 #include <ripple/nodestore/Types.h>
+#include <ripple/json/json_value.h>
 
 namespace ripple {
 namespace NodeStore {
@@ -105,6 +106,11 @@ public:
 
     /** Perform consistency checks on database .*/
     virtual void verify() = 0;
+
+    /** Add counters describing this backend to the object.
+        Most backends have nothing to add.
+    */
+    virtual void getCounts (Json::Value& obj) { }
 };
 
 }
@@ -71,6 +71,21 @@ public:
     */
     virtual NodeObject::pointer fetch (uint256 const& hash) = 0;
 
+    /** Fetch an object which is part of the specified ledger.
+        Databases which divide objects by ledger look in the right place
+        first. Otherwise this is the same as fetching without a ledger.
+
+        @note This can be called concurrently.
+        @param hash The key of the object to retrieve.
+        @param ledgerSeq The ledger the object is part of, or zero.
+        @return The object, or nullptr if it couldn't be retrieved.
+    */
+    virtual NodeObject::pointer fetch (uint256 const& hash,
+        std::uint32_t ledgerSeq)
+    {
+        return fetch (hash);
+    }
+
     /** Fetch an object without waiting.
         If I/O is required to determine whether or not the object is present,
         `false` is returned. Otherwise, `true` is returned and `object` is set
@@ -109,6 +124,18 @@ public:
                         Blob&& data,
                         uint256 const& hash) = 0;
 
+    /** Store an object which first appears in the specified ledger.
+        Databases which divide objects by ledger store it with the rest of
+        that ledger. Otherwise this is the same as storing without a ledger.
+    */
+    virtual void store (NodeObjectType type,
+                        Blob&& data,
+                        uint256 const& hash,
+                        std::uint32_t ledgerSeq)
+    {
+        store (type, std::move (data), hash);
+    }
+
     /** Visit every object in the database
         This is usually called during import.
 
@@ -129,6 +156,13 @@ public:
     /** Get the positive cache hits to total attempts ratio. */
     virtual float getCacheHitRate () = 0;
 
+    /** Get the number of objects in the positive cache. */
+    virtual int getCacheSize () = 0;
+
+    /** Get the cumulative positive cache hits and misses. */
+    virtual std::pair <std::uint64_t, std::uint64_t>
+    getCacheHitsAndMisses () = 0;
+
     /** Set the maximum number of entries and maximum cache age for both caches.
 
         @param size Number of cache entries (0 = ignore)
@@ -147,6 +181,9 @@ public:
     virtual std::uint32_t getFetchHitCount () const = 0;
     virtual std::uint32_t getStoreSize () const = 0;
     virtual std::uint32_t getFetchSize () const = 0;
+
+    /** Add counters reported by the backends, keyed by backend name. */
+    virtual void getBackendCounts (Json::Value& obj) = 0;
 };
 
 }
@@ -0,0 +1,150 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/nodestore/impl/BatchReader.h>
+#include <beast/threads/Thread.h>
+#include <algorithm>
+
+namespace ripple {
+namespace NodeStore {
+
+BatchReader::BatchReader (int threads)
+    : shutdown_ (false)
+{
+    for (int i = 0; i < threads; ++i)
+        threads_.emplace_back (&BatchReader::threadEntry, this);
+}
+
+BatchReader::~BatchReader ()
+{
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        shutdown_ = true;
+    }
+
+    workCond_.notify_all ();
+
+    for (auto& t : threads_)
+        t.join ();
+}
+
+void
+BatchReader::read (std::size_t n,
+    std::function <void (std::size_t)> const& read)
+{
+    if (n == 0)
+        return;
+
+    auto const batch = std::make_shared <Batch> (read, n);
+
+    if (n > 1 && ! threads_.empty ())
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        batches_.push_back (batch);
+        workCond_.notify_all ();
+    }
+
+    work (*batch);
+
+    std::unique_lock <std::mutex> lock (mutex_);
+    doneCond_.wait (lock, [&batch] { return batch->remaining == 0; });
+
+    auto const iter = std::find (batches_.begin (), batches_.end (), batch);
+    if (iter != batches_.end ())
+        batches_.erase (iter);
+
+    if (batch->error)
+        std::rethrow_exception (batch->error);
+}
+
+void
+BatchReader::work (Batch& batch)
+{
+    for (;;)
+    {
+        std::size_t const i = batch.next++;
+
+        if (i >= batch.size)
+            break;
+
+        std::exception_ptr error;
+
+        try
+        {
+            batch.read (i);
+        }
+        catch (...)
+        {
+            error = std::current_exception ();
+        }
+
+        std::lock_guard <std::mutex> lock (mutex_);
+
+        if (error)
+        {
+            if (! batch.error)
+                batch.error = error;
+
+            // Skip whatever has not been claimed yet
+            std::size_t const claimed = std::min (
+                batch.next.exchange (batch.size), batch.size);
+            batch.remaining -= batch.size - claimed;
+        }
+
+        if (--batch.remaining == 0)
+            doneCond_.notify_all ();
+    }
+}
+
+void
+BatchReader::threadEntry ()
+{
+    beast::Thread::setCurrentThreadName ("batchread");
+
+    std::unique_lock <std::mutex> lock (mutex_);
+
+    for (;;)
+    {
+        workCond_.wait (lock, [this]
+            {
+                return shutdown_ || ! batches_.empty ();
+            });
+
+        if (shutdown_)
+            break;
+
+        auto const batch = batches_.front ();
+
+        if (batch->next >= batch->size)
+        {
+            // Every read has been claimed
+            batches_.pop_front ();
+            continue;
+        }
+
+        lock.unlock ();
+        work (*batch);
+        lock.lock ();
+    }
+}
+
+}
+}
@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_NODESTORE_BATCHREADER_H_INCLUDED
+#define RIPPLE_NODESTORE_BATCHREADER_H_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+/** Batch-reading assist logic.
+
+    Runs the reads in a batch on a fixed pool of threads, so that a backend
+    whose reads block can keep many of them outstanding at once. This keeps
+    the device queue full when one thread asks for many objects, as the
+    prefetch threads do while acquiring ledgers.
+
+    The calling thread takes part in the work, so a pool with no threads
+    performs the reads one after the other.
+*/
+class BatchReader
+{
+public:
+    /** Create a batch reader with the specified number of extra threads. */
+    explicit BatchReader (int threads);
+
+    /** Destroy a batch reader.
+
+        Batches still in progress are completed by their callers.
+    */
+    ~BatchReader ();
+
+    BatchReader (BatchReader const&) = delete;
+    BatchReader& operator= (BatchReader const&) = delete;
+
+    /** Call `read (i)` for each `i` in [0, n).
+
+        Calls are made concurrently and in no particular order. This returns
+        once every call has completed. If a call throws, the remaining calls
+        are skipped and the exception is rethrown here.
+    */
+    void read (std::size_t n, std::function <void (std::size_t)> const& read);
+
+private:
+    struct Batch
+    {
+        Batch (std::function <void (std::size_t)> const& r, std::size_t n)
+            : read (r)
+            , size (n)
+            , next (0)
+            , remaining (n)
+        {
+        }
+
+        std::function <void (std::size_t)> const& read;
+        std::size_t const size;
+        std::atomic <std::size_t> next;
+        std::size_t remaining;
+        std::exception_ptr error;
+    };
+
+    void work (Batch& batch);
+    void threadEntry ();
+
+    std::mutex mutex_;
+    std::condition_variable workCond_;
+    std::condition_variable doneCond_;
+    std::deque <std::shared_ptr <Batch>> batches_;
+    bool shutdown_;
+    std::vector <std::thread> threads_;
+};
+
+}
+}
+
+#endif
@@ -33,6 +33,7 @@
 #include <condition_variable>
 #include <set>
 #include <thread>
+#include <vector>
 
 namespace ripple {
 namespace NodeStore {
@@ -172,15 +173,24 @@ public:
         return doTimedFetch (hash, false);
     }
 
+    NodeObject::Ptr fetch (uint256 const& hash,
+        std::uint32_t ledgerSeq) override
+    {
+        ScopedMetrics::incrementThreadFetches ();
+
+        return doTimedFetch (hash, false, ledgerSeq);
+    }
+
     /** Perform a fetch and report the time it took */
-    NodeObject::Ptr doTimedFetch (uint256 const& hash, bool isAsync)
+    NodeObject::Ptr doTimedFetch (uint256 const& hash, bool isAsync,
+        std::uint32_t ledgerSeq = 0)
     {
         FetchReport report;
         report.isAsync = isAsync;
         report.wentToDisk = false;
 
         auto const before = std::chrono::steady_clock::now();
-        NodeObject::Ptr ret = doFetch (hash, report);
+        NodeObject::Ptr ret = doFetch (hash, report, ledgerSeq);
         report.elapsed = std::chrono::duration_cast <std::chrono::milliseconds>
             (std::chrono::steady_clock::now() - before);
 
@@ -190,7 +200,8 @@ public:
         return ret;
     }
 
-    NodeObject::Ptr doFetch (uint256 const& hash, FetchReport &report)
+    NodeObject::Ptr doFetch (uint256 const& hash, FetchReport &report,
+        std::uint32_t ledgerSeq)
     {
         // See if the object already exists in the cache
         //
@@ -224,10 +235,97 @@ public:
         {
             // Yes so at last we will try the main database.
             //
-            obj = fetchFrom (hash);
+            obj = fetchFrom (hash, ledgerSeq);
             ++m_fetchTotalCount;
         }
 
+        return finishFetch (hash, obj, foundInFastBackend);
+    }
+
+    /** Perform a group of fetches and report the time they took
+
+        The backend may perform the reads concurrently. Each fetch is
+        reported with the time taken by the whole group.
+    */
+    void doTimedFetchBatch (std::vector <uint256> const& hashes, bool isAsync)
+    {
+        auto const before = std::chrono::steady_clock::now();
+
+        std::vector <uint256> toRead;
+        toRead.reserve (hashes.size ());
+
+        for (auto const& hash : hashes)
+        {
+            if (m_cache.fetch (hash) == nullptr &&
+                    ! m_negCache.touch_if_exists (hash))
+                toRead.push_back (hash);
+        }
+
+        std::vector <NodeObject::Ptr> objects (toRead.size ());
+        std::vector <bool> foundInFastBackend (toRead.size (), false);
+
+        if (! toRead.empty ())
+        {
+            std::vector <uint256> fromMain;
+            std::vector <std::size_t> positions;
+
+            if (m_fastBackend != nullptr)
+            {
+                objects = fetchBatchInternal (*m_fastBackend, toRead);
+
+                for (std::size_t i = 0; i < objects.size (); ++i)
+                {
+                    if (objects[i] != nullptr)
+                    {
+                        foundInFastBackend[i] = true;
+                    }
+                    else
+                    {
+                        fromMain.push_back (toRead[i]);
+                        positions.push_back (i);
+                    }
+                }
+            }
+            else
+            {
+                fromMain = toRead;
+                for (std::size_t i = 0; i < toRead.size (); ++i)
+                    positions.push_back (i);
+            }
+
+            if (! fromMain.empty ())
+            {
+                auto found = fetchBatchFrom (fromMain);
+                m_fetchTotalCount += fromMain.size ();
+
+                for (std::size_t i = 0; i < found.size (); ++i)
+                    objects[positions[i]] = std::move (found[i]);
+            }
+
+            for (std::size_t i = 0; i < toRead.size (); ++i)
+                objects[i] = finishFetch (
+                    toRead[i], objects[i], foundInFastBackend[i]);
+        }
+
+        auto const elapsed = std::chrono::duration_cast <
+            std::chrono::milliseconds> (
+                std::chrono::steady_clock::now() - before);
+
+        for (auto const& obj : objects)
+        {
+            FetchReport report;
+            report.isAsync = isAsync;
+            report.wentToDisk = true;
+            report.elapsed = elapsed;
+            report.wasFound = (obj != nullptr);
+            m_scheduler.onFetch (report);
+        }
+    }
+
+    // Cache the result of a fetch that went to the backends
+    NodeObject::Ptr finishFetch (uint256 const& hash, NodeObject::Ptr obj,
+        bool foundInFastBackend)
+    {
         if (obj == nullptr)
         {
 
@@ -273,6 +371,66 @@ public:
         return fetchInternal (*m_backend, hash);
     }
 
+    /** Fetch an object which is part of the specified ledger. */
+    virtual NodeObject::Ptr fetchFrom (uint256 const& hash,
+        std::uint32_t ledgerSeq)
+    {
+        return fetchFrom (hash);
+    }
+
+    /** Return `true` if fetchBatchFrom is faster than separate fetches. */
+    virtual bool canFetchBatchFrom ()
+    {
+        return m_backend->canFetchBatch ();
+    }
+
+    virtual std::vector <NodeObject::Ptr> fetchBatchFrom (
+        std::vector <uint256> const& hashes)
+    {
+        return fetchBatchInternal (*m_backend, hashes);
+    }
+
+    std::vector <NodeObject::Ptr> fetchBatchInternal (Backend& backend,
+        std::vector <uint256> const& hashes)
+    {
+        std::vector <NodeObject::Ptr> objects;
+
+        if (! backend.canFetchBatch ())
+        {
+            objects.reserve (hashes.size ());
+            for (auto const& hash : hashes)
+                objects.push_back (fetchInternal (backend, hash));
+            return objects;
+        }
+
+        std::vector <void const*> keys;
+        keys.reserve (hashes.size ());
+        for (auto const& hash : hashes)
+            keys.push_back (hash.begin ());
+
+        try
+        {
+            objects = backend.fetchBatch (keys.size (), keys.data ());
+        }
+        catch (std::exception const& e)
+        {
+            if (m_journal.warning) m_journal.warning <<
+                "Batch fetch failed: " << e.what ();
+            objects.assign (hashes.size (), nullptr);
+        }
+
+        for (auto const& object : objects)
+        {
+            if (object)
+            {
+                ++m_fetchHitCount;
+                m_fetchSize += object->getData().size();
+            }
+        }
+
+        return objects;
+    }
+
     NodeObject::Ptr fetchInternal (Backend& backend,
         uint256 const& hash)
     {
@@ -351,6 +509,17 @@ public:
         return m_cache.getHitRate ();
     }
 
+    int getCacheSize () override
+    {
+        return m_cache.getCacheSize ();
+    }
+
+    std::pair <std::uint64_t, std::uint64_t>
+    getCacheHitsAndMisses () override
+    {
+        return m_cache.getHitsAndMisses ();
+    }
+
     void tune (int size, int age)
     {
         m_cache.setTargetSize (size);
@@ -376,9 +545,11 @@ public:
     void threadEntry ()
     {
         beast::Thread::setCurrentThreadName ("prefetch");
+        std::vector <uint256> hashes;
+
         while (1)
         {
-            uint256 hash;
+            hashes.clear ();
 
             {
                 std::unique_lock <std::mutex> lock (m_readLock);
@@ -393,24 +564,36 @@ public:
                 if (m_readShut)
                     break;
 
-                // Read in key order to make the back end more efficient
-                std::set <uint256>::iterator it = m_readSet.lower_bound (m_readLast);
-                if (it == m_readSet.end ())
+                while (hashes.size () < asyncFetchBatchSize &&
+                    !m_readSet.empty ())
                 {
-                    it = m_readSet.begin ();
-
-                    // A generation has completed
-                    ++m_readGen;
-                    m_readGenCondVar.notify_all ();
+                    // Read in key order to make the back end more efficient
+                    std::set <uint256>::iterator it = m_readSet.lower_bound (m_readLast);
+                    if (it == m_readSet.end ())
+                    {
+                        it = m_readSet.begin ();
+
+                        // A generation has completed
+                        ++m_readGen;
+                        m_readGenCondVar.notify_all ();
+                    }
+
+                    hashes.push_back (*it);
+                    m_readSet.erase (it);
+                    m_readLast = hashes.back ();
                 }
-
-                hash = *it;
-                m_readSet.erase (it);
-                m_readLast = hash;
             }
 
-            // Perform the read
-            doTimedFetch (hash, true);
+            // Perform the reads, together if the back end allows it
+            if (hashes.size () > 1 && canFetchBatchFrom ())
+            {
+                doTimedFetchBatch (hashes, true);
+            }
+            else
+            {
+                for (auto const& hash : hashes)
+                    doTimedFetch (hash, true);
+            }
          }
      }
 
@@ -475,6 +658,12 @@ public:
         return m_fetchSize;
     }
 
+    void getBackendCounts (Json::Value& obj) override
+    {
+        if (m_backend)
+            m_backend->getCounts (obj);
+    }
+
 private:
     std::atomic <std::uint32_t> m_storeCount;
     std::atomic <std::uint32_t> m_fetchTotalCount;
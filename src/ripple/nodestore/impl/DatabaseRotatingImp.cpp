@@ -50,6 +50,43 @@ NodeObject::Ptr DatabaseRotatingImp::fetchFrom (uint256 const& hash)
 
     return object;
 }
+
+std::vector <NodeObject::Ptr> DatabaseRotatingImp::fetchBatchFrom (
+    std::vector <uint256> const& hashes)
+{
+    Backends b = getBackends();
+    std::vector <NodeObject::Ptr> objects =
+        fetchBatchInternal (*b.writableBackend, hashes);
+
+    std::vector <uint256> missing;
+    std::vector <std::size_t> positions;
+    for (std::size_t i = 0; i < objects.size (); ++i)
+    {
+        if (!objects[i])
+        {
+            missing.push_back (hashes[i]);
+            positions.push_back (i);
+        }
+    }
+
+    if (!missing.empty ())
+    {
+        std::vector <NodeObject::Ptr> archived =
+            fetchBatchInternal (*b.archiveBackend, missing);
+
+        for (std::size_t i = 0; i < archived.size (); ++i)
+        {
+            if (archived[i])
+            {
+                getWritableBackend()->store (archived[i]);
+                m_negCache.erase (missing[i]);
+                objects[positions[i]] = std::move (archived[i]);
+            }
+        }
+    }
+
+    return objects;
+}
 }
 
 }
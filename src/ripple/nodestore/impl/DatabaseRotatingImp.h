@@ -123,6 +123,22 @@ public:
     }
 
     NodeObject::Ptr fetchFrom (uint256 const& hash) override;
+
+    bool canFetchBatchFrom () override
+    {
+        return getWritableBackend()->canFetchBatch ();
+    }
+
+    std::vector <NodeObject::Ptr> fetchBatchFrom (
+        std::vector <uint256> const& hashes) override;
+
+    void getBackendCounts (Json::Value& obj) override
+    {
+        Backends b = getBackends();
+        b.writableBackend->getCounts (obj);
+        b.archiveBackend->getCounts (obj);
+    }
+
     TaggedCache <uint256, NodeObject>& getPositiveCache() override
     {
         return m_cache;
@@ -0,0 +1,287 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/nodestore/impl/DatabaseShardImp.h>
+#include <ripple/nodestore/Manager.h>
+#include <beast/module/core/text/LexicalCast.h>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+DatabaseShardImp::DatabaseShardImp (std::string const& name,
+             Scheduler& scheduler,
+             int readThreads,
+             Section const& backendParameters,
+             std::unique_ptr <Backend> fastBackend,
+             beast::Journal journal)
+    : DatabaseImp (name, scheduler, readThreads,
+            std::unique_ptr <Backend>(), std::move (fastBackend),
+            journal)
+    , parameters_ (backendParameters)
+    , path_ (get<std::string> (backendParameters, "path"))
+    , ledgersPerShard_ (get<std::uint32_t> (backendParameters,
+        "ledgers_per_shard", defaultLedgersPerShard))
+    , maxOpenShards_ (std::max <std::size_t> (2, get<std::size_t> (
+        backendParameters, "open_shards", defaultMaxOpenShards)))
+    , current_ (0)
+{
+    if (path_.empty ())
+        throw std::runtime_error (
+            "nodestore: Missing path for sharded database");
+
+    if (ledgersPerShard_ == 0)
+        throw std::runtime_error (
+            "nodestore: ledgers_per_shard must be positive");
+
+    boost::filesystem::create_directories (path_);
+
+    // Every numbered directory is a shard
+    for (boost::filesystem::directory_iterator iter (path_), end;
+        iter != end; ++iter)
+    {
+        std::uint32_t index;
+        if (boost::filesystem::is_directory (iter->status ()) &&
+            beast::lexicalCastChecked (index,
+                iter->path ().filename ().string ()))
+        {
+            shards_[index];
+            if (index > current_)
+                current_ = index;
+        }
+    }
+
+    if (m_journal.info) m_journal.info <<
+        "Found " << shards_.size () << " shards of " <<
+        ledgersPerShard_ << " ledgers in " << path_.string ();
+}
+
+void
+DatabaseShardImp::close ()
+{
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        for (auto& shard : shards_)
+        {
+            if (shard.second.backend)
+            {
+                shard.second.backend->close ();
+                shard.second.backend.reset ();
+            }
+        }
+        openShards_ = 0;
+    }
+
+    DatabaseImp::close ();
+}
+
+std::int32_t
+DatabaseShardImp::getWriteLoad () const
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    auto const iter = shards_.find (current_);
+    if (iter == shards_.end () || ! iter->second.backend)
+        return 0;
+    return iter->second.backend->getWriteLoad ();
+}
+
+void
+DatabaseShardImp::getBackendCounts (Json::Value& obj)
+{
+    std::vector <std::shared_ptr <Backend>> backends;
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        for (auto const& shard : shards_)
+            if (shard.second.backend)
+                backends.push_back (shard.second.backend);
+    }
+
+    for (auto const& backend : backends)
+        backend->getCounts (obj);
+}
+
+void
+DatabaseShardImp::for_each (std::function <void(NodeObject::Ptr)> f)
+{
+    std::vector <std::uint32_t> indexes;
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        for (auto const& shard : shards_)
+            indexes.push_back (shard.first);
+    }
+
+    for (auto index : indexes)
+        getShard (index)->for_each (f);
+}
+
+void
+DatabaseShardImp::import (Database& source)
+{
+    importInternal (source, *getShard (current_));
+}
+
+void
+DatabaseShardImp::store (NodeObjectType type,
+                         Blob&& data,
+                         uint256 const& hash)
+{
+    auto const backend = getShard (current_);
+    storeInternal (type, std::move (data), hash, *backend);
+}
+
+void
+DatabaseShardImp::store (NodeObjectType type,
+                         Blob&& data,
+                         uint256 const& hash,
+                         std::uint32_t ledgerSeq)
+{
+    if (ledgerSeq == 0)
+        return store (type, std::move (data), hash);
+
+    std::uint32_t const index = shardIndex (ledgerSeq);
+
+    std::uint32_t current = current_;
+    while (index > current && ! current_.compare_exchange_weak (
+        current, index))
+        ;
+
+    auto const backend = getShard (index);
+    storeInternal (type, std::move (data), hash, *backend);
+}
+
+NodeObject::Ptr
+DatabaseShardImp::fetchFrom (uint256 const& hash)
+{
+    std::uint32_t const current = current_;
+    auto object = fetchInternal (*getShard (current), hash);
+    if (! object)
+        object = search (hash, current);
+    return object;
+}
+
+NodeObject::Ptr
+DatabaseShardImp::fetchFrom (uint256 const& hash, std::uint32_t ledgerSeq)
+{
+    if (ledgerSeq == 0)
+        return fetchFrom (hash);
+
+    std::uint32_t const index = shardIndex (ledgerSeq);
+    auto const backend = getShard (index);
+    auto object = fetchInternal (*backend, hash);
+
+    if (! object)
+    {
+        object = search (hash, index);
+
+        // Keep the current shard complete for the ledgers it holds
+        if (object && index == current_)
+        {
+            backend->store (object);
+            m_negCache.erase (hash);
+        }
+    }
+
+    return object;
+}
+
+std::shared_ptr <Backend>
+DatabaseShardImp::getShard (std::uint32_t index)
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    Shard& shard = shards_[index];
+
+    if (! shard.backend)
+    {
+        if (openShards_ >= maxOpenShards_)
+            closeShard (lock);
+
+        Section parameters (parameters_);
+        parameters.set ("path", (path_ / std::to_string (index)).string ());
+        shard.backend = Manager::instance ().make_Backend (
+            parameters, m_scheduler, m_journal);
+        ++openShards_;
+
+        if (m_journal.debug) m_journal.debug <<
+            "Opened shard " << index;
+    }
+
+    shard.lastUse = ++useCount_;
+    return shard.backend;
+}
+
+void
+DatabaseShardImp::closeShard (std::lock_guard <std::mutex> const&)
+{
+    auto oldest = shards_.end ();
+    for (auto iter = shards_.begin (); iter != shards_.end (); ++iter)
+    {
+        if (iter->second.backend && iter->first != current_ &&
+            (oldest == shards_.end () ||
+                iter->second.lastUse < oldest->second.lastUse))
+            oldest = iter;
+    }
+
+    if (oldest != shards_.end ())
+    {
+        // A fetch or store in progress may still hold the backend,
+        // so it is closed when the last reference goes away.
+        oldest->second.backend.reset ();
+        --openShards_;
+
+        if (m_journal.debug) m_journal.debug <<
+            "Closed shard " << oldest->first;
+    }
+}
+
+NodeObject::Ptr
+DatabaseShardImp::search (uint256 const& hash, std::uint32_t skip)
+{
+    // Try the open shards before opening any others
+    std::vector <std::uint32_t> indexes;
+    std::vector <std::uint32_t> closed;
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        for (auto iter = shards_.rbegin (); iter != shards_.rend (); ++iter)
+        {
+            if (iter->first == skip)
+                continue;
+            if (iter->second.backend)
+                indexes.push_back (iter->first);
+            else
+                closed.push_back (iter->first);
+        }
+    }
+
+    indexes.insert (indexes.end (), closed.begin (), closed.end ());
+
+    for (auto index : indexes)
+    {
+        if (auto object = fetchInternal (*getShard (index), hash))
+            return object;
+    }
+
+    return nullptr;
+}
+
+}
+}
@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_NODESTORE_DATABASESHARDIMP_H_INCLUDED
+#define RIPPLE_NODESTORE_DATABASESHARDIMP_H_INCLUDED
+
+#include <ripple/nodestore/impl/DatabaseImp.h>
+#include <ripple/basics/BasicConfig.h>
+#include <boost/filesystem.hpp>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A database which keeps each fixed range of ledgers in its own backend.
+
+    Shard `n` holds the objects first stored for ledgers `n * size` through
+    `(n + 1) * size - 1` and lives in the subdirectory `n` of the configured
+    path. Objects stored without a ledger go to the current shard, which is
+    the highest one written so far.
+
+    Shards below the current one are sealed: they still accept objects for
+    their own ledgers, such as when history is acquired, but objects found
+    in them are never copied there. Instead, an object which is part of a
+    ledger in the current shard but was found in an older one is copied
+    forward, so the current shard comes to hold everything that recent
+    ledgers need and the older shards are only opened for history.
+
+    At most a bounded number of shards are open at once. The least
+    recently used shard other than the current one is closed to open
+    another.
+*/
+class DatabaseShardImp
+    : public DatabaseImp
+{
+public:
+    DatabaseShardImp (std::string const& name,
+                 Scheduler& scheduler,
+                 int readThreads,
+                 Section const& backendParameters,
+                 std::unique_ptr <Backend> fastBackend,
+                 beast::Journal journal);
+
+    std::string getName () const override
+    {
+        return path_.string ();
+    }
+
+    void close () override;
+
+    std::int32_t getWriteLoad () const override;
+
+    void for_each (std::function <void(NodeObject::Ptr)> f) override;
+
+    void import (Database& source) override;
+
+    void store (NodeObjectType type,
+                Blob&& data,
+                uint256 const& hash) override;
+
+    void store (NodeObjectType type,
+                Blob&& data,
+                uint256 const& hash,
+                std::uint32_t ledgerSeq) override;
+
+    NodeObject::Ptr fetchFrom (uint256 const& hash) override;
+
+    NodeObject::Ptr fetchFrom (uint256 const& hash,
+        std::uint32_t ledgerSeq) override;
+
+    bool canFetchBatchFrom () override
+    {
+        return false;
+    }
+
+    void getBackendCounts (Json::Value& obj) override;
+
+private:
+    struct Shard
+    {
+        // Null while the shard is closed
+        std::shared_ptr <Backend> backend;
+
+        // When the shard was last used, to choose which one to close
+        std::uint64_t lastUse = 0;
+    };
+
+    std::uint32_t shardIndex (std::uint32_t ledgerSeq) const
+    {
+        return ledgerSeq / ledgersPerShard_;
+    }
+
+    // Open the shard if needed and return its backend
+    std::shared_ptr <Backend> getShard (std::uint32_t index);
+
+    // Close the least recently used shard which is not current
+    void closeShard (std::lock_guard <std::mutex> const&);
+
+    // Look for an object in every shard other than `skip`, newest first
+    NodeObject::Ptr search (uint256 const& hash, std::uint32_t skip);
+
+    Section const parameters_;
+    boost::filesystem::path const path_;
+    std::uint32_t const ledgersPerShard_;
+    std::size_t const maxOpenShards_;
+
+    mutable std::mutex mutex_;
+    std::map <std::uint32_t, Shard> shards_;
+    std::size_t openShards_ = 0;
+    std::uint64_t useCount_ = 0;
+
+    // The highest shard written so far
+    std::atomic <std::uint32_t> current_;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,184 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/nodestore/impl/FilteredBackend.h>
+#include <ripple/nodestore/impl/Tuning.h>
+#include <boost/filesystem.hpp>
+
+namespace ripple {
+namespace NodeStore {
+
+FilteredBackend::FilteredBackend (std::unique_ptr <Backend> backend,
+        Section const& parameters, beast::Journal journal)
+    : journal_ (journal)
+    , backend_ (std::move (backend))
+    , filter_ (get<std::size_t> (parameters, "filter_keys"),
+        get<std::size_t> (parameters, "filter_bits", defaultFilterBitsPerKey))
+    , deletePath_ (false)
+    , checks_ (0)
+    , skipped_ (0)
+    , falsePositives_ (0)
+{
+    using namespace boost::filesystem;
+
+    // Backends which keep their data in a directory get a saved filter
+    auto const dir = path (get<std::string> (parameters, "path"));
+    boost::system::error_code ec;
+    if (! dir.empty () && is_directory (dir, ec))
+        file_ = (dir / "keys.filter").string ();
+
+    if (! file_.empty () && filter_.load (file_))
+    {
+        remove (file_, ec);
+        if (journal_.info) journal_.info <<
+            getName () << ": loaded key filter with " <<
+            filter_.getInsertCount () << " keys";
+        return;
+    }
+
+    if (journal_.warning) journal_.warning <<
+        getName () << ": building key filter, this may take a while";
+
+    backend_->for_each ([this](NodeObject::Ptr object)
+    {
+        filter_.insert (object->getHash ());
+    });
+
+    if (journal_.info) journal_.info <<
+        getName () << ": built key filter with " <<
+        filter_.getInsertCount () << " keys";
+}
+
+FilteredBackend::~FilteredBackend ()
+{
+    close ();
+}
+
+void FilteredBackend::close ()
+{
+    std::call_once (closed_, [this]
+    {
+        if (! file_.empty () && ! deletePath_ && ! filter_.save (file_))
+        {
+            if (journal_.warning) journal_.warning <<
+                getName () << ": unable to save key filter to " << file_;
+        }
+    });
+
+    backend_->close ();
+}
+
+void FilteredBackend::checked (Status status)
+{
+    if (status == notFound)
+        ++falsePositives_;
+}
+
+Status FilteredBackend::fetch (void const* key, NodeObject::Ptr* pObject)
+{
+    ++checks_;
+
+    if (! filter_.mayContain (uint256::fromVoid (key)))
+    {
+        ++skipped_;
+        pObject->reset ();
+        return notFound;
+    }
+
+    Status const status = backend_->fetch (key, pObject);
+    checked (status);
+    return status;
+}
+
+std::vector <std::shared_ptr <NodeObject>>
+FilteredBackend::fetchBatch (std::size_t n, void const* const* keys)
+{
+    std::vector <std::shared_ptr <NodeObject>> objects (n);
+
+    std::vector <void const*> passed;
+    std::vector <std::size_t> positions;
+    passed.reserve (n);
+    positions.reserve (n);
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (filter_.mayContain (uint256::fromVoid (keys[i])))
+        {
+            passed.push_back (keys[i]);
+            positions.push_back (i);
+        }
+    }
+
+    checks_ += n;
+    skipped_ += n - passed.size ();
+
+    if (! passed.empty ())
+    {
+        auto found = backend_->fetchBatch (passed.size (), passed.data ());
+
+        for (std::size_t i = 0; i < found.size (); ++i)
+        {
+            checked (found[i] ? ok : notFound);
+            objects[positions[i]] = std::move (found[i]);
+        }
+    }
+
+    return objects;
+}
+
+void FilteredBackend::store (NodeObject::Ptr const& object)
+{
+    // Insert first, so a fetch which can find the object also passes
+    filter_.insert (object->getHash ());
+    backend_->store (object);
+}
+
+void FilteredBackend::storeBatch (Batch const& batch)
+{
+    for (auto const& object : batch)
+        filter_.insert (object->getHash ());
+    backend_->storeBatch (batch);
+}
+
+void FilteredBackend::getCounts (Json::Value& obj)
+{
+    auto const checks = checks_.load ();
+    auto const skipped = skipped_.load ();
+    auto const falsePositives = falsePositives_.load ();
+
+    Json::Value& counts = (obj[getName ()] = Json::objectValue);
+    counts["checks"] = static_cast <Json::UInt> (checks);
+    counts["skipped"] = static_cast <Json::UInt> (skipped);
+    counts["false_positives"] =
+        static_cast <Json::UInt> (falsePositives);
+
+    // Of the lookups for keys we do not have, the share the filter missed
+    if (skipped + falsePositives > 0)
+        counts["false_positive_rate"] =
+            double (falsePositives) / (skipped + falsePositives);
+
+    counts["keys"] =
+        static_cast <Json::UInt> (filter_.getInsertCount ());
+    counts["bytes"] = static_cast <Json::UInt> (filter_.getSize ());
+}
+
+}
+}
@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_NODESTORE_FILTEREDBACKEND_H_INCLUDED
+#define RIPPLE_NODESTORE_FILTEREDBACKEND_H_INCLUDED
+
+#include <ripple/nodestore/Backend.h>
+#include <ripple/nodestore/impl/KeyFilter.h>
+#include <beast/utility/Journal.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A backend which answers lookups for missing keys from a key filter.
+
+    Every key stored through this backend is added to a KeyFilter, and a
+    fetch for a key the filter has never seen returns `notFound` without
+    reading the wrapped backend. While acquiring ledgers most lookups are
+    for nodes we do not have, and each one would otherwise cost a read of
+    the key file.
+
+    The filter is saved next to the data when the backend is closed and
+    read back when it is opened. The saved copy is removed once it is read,
+    so after a crash the filter is rebuilt by visiting the backend instead
+    of trusting a copy which may be missing recent keys.
+*/
+class FilteredBackend : public Backend
+{
+public:
+    FilteredBackend (std::unique_ptr <Backend> backend,
+        Section const& parameters, beast::Journal journal);
+
+    ~FilteredBackend ();
+
+    std::string getName () override
+    {
+        return backend_->getName ();
+    }
+
+    void close () override;
+
+    Status fetch (void const* key, NodeObject::Ptr* pObject) override;
+
+    bool canFetchBatch () override
+    {
+        return backend_->canFetchBatch ();
+    }
+
+    std::vector <std::shared_ptr <NodeObject>>
+    fetchBatch (std::size_t n, void const* const* keys) override;
+
+    void store (NodeObject::Ptr const& object) override;
+
+    void storeBatch (Batch const& batch) override;
+
+    void for_each (std::function <void (NodeObject::Ptr)> f) override
+    {
+        backend_->for_each (f);
+    }
+
+    int getWriteLoad () override
+    {
+        return backend_->getWriteLoad ();
+    }
+
+    void setDeletePath () override
+    {
+        deletePath_ = true;
+        backend_->setDeletePath ();
+    }
+
+    void verify () override
+    {
+        backend_->verify ();
+    }
+
+    void getCounts (Json::Value& obj) override;
+
+private:
+    // Called with the result of a fetch the filter let through
+    void checked (Status status);
+
+    beast::Journal journal_;
+    std::unique_ptr <Backend> backend_;
+    KeyFilter filter_;
+
+    // Where the filter is saved, or empty if it is not
+    std::string file_;
+
+    std::atomic <bool> deletePath_;
+    std::once_flag closed_;
+
+    std::atomic <std::uint64_t> checks_;
+    std::atomic <std::uint64_t> skipped_;
+    std::atomic <std::uint64_t> falsePositives_;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/nodestore/impl/KeyFilter.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+// Identifies a saved filter, and changes if the layout does
+static std::uint64_t const filterMagic = 0x52504C4B46494C31ull;
+
+static inline std::uint64_t keyWord (uint256 const& key, int i)
+{
+    std::uint64_t w;
+    std::memcpy (&w, key.begin () + i * sizeof (w), sizeof (w));
+    return w;
+}
+
+KeyFilter::KeyFilter (std::size_t keys, std::size_t bitsPerKey)
+    : blocks_ (std::max <std::size_t> (1,
+        (keys * bitsPerKey + blockBytes * 8 - 1) / (blockBytes * 8)))
+    , words_ (new std::atomic <std::uint64_t>[blocks_ * blockWords])
+    , inserts_ (0)
+{
+    for (std::size_t i = 0; i < blocks_ * blockWords; ++i)
+        words_[i].store (0, std::memory_order_relaxed);
+}
+
+void KeyFilter::insert (uint256 const& key)
+{
+    auto const block = &words_[(keyWord (key, 0) % blocks_) * blockWords];
+    std::uint64_t h = keyWord (key, 1);
+    std::uint64_t const step = keyWord (key, 2) | 1;
+
+    for (int i = 0; i < probes; ++i, h += step)
+    {
+        // The top nine bits choose one of the 512 bits in the block
+        auto const bit = h >> 55;
+        block[bit / 64].fetch_or (std::uint64_t (1) << (bit % 64),
+            std::memory_order_relaxed);
+    }
+
+    inserts_.fetch_add (1, std::memory_order_relaxed);
+}
+
+bool KeyFilter::mayContain (uint256 const& key) const
+{
+    auto const block = &words_[(keyWord (key, 0) % blocks_) * blockWords];
+    std::uint64_t h = keyWord (key, 1);
+    std::uint64_t const step = keyWord (key, 2) | 1;
+
+    for (int i = 0; i < probes; ++i, h += step)
+    {
+        auto const bit = h >> 55;
+        if ((block[bit / 64].load (std::memory_order_relaxed) &
+                (std::uint64_t (1) << (bit % 64))) == 0)
+            return false;
+    }
+
+    return true;
+}
+
+bool KeyFilter::save (std::string const& path) const
+{
+    std::ofstream out (path, std::ios::binary | std::ios::trunc);
+
+    std::uint64_t const header[3] = {
+        filterMagic, blocks_, inserts_.load () };
+    out.write (reinterpret_cast <char const*> (header), sizeof (header));
+
+    for (std::size_t i = 0; out && i < blocks_ * blockWords; ++i)
+    {
+        std::uint64_t const w = words_[i].load (std::memory_order_relaxed);
+        out.write (reinterpret_cast <char const*> (&w), sizeof (w));
+    }
+
+    out.close ();
+    return bool (out);
+}
+
+bool KeyFilter::load (std::string const& path)
+{
+    std::ifstream in (path, std::ios::binary);
+
+    std::uint64_t header[3];
+    if (! in.read (reinterpret_cast <char*> (header), sizeof (header)) ||
+            header[0] != filterMagic || header[1] != blocks_)
+        return false;
+
+    std::vector <std::uint64_t> words (blocks_ * blockWords);
+    if (! in.read (reinterpret_cast <char*> (words.data ()),
+            words.size () * sizeof (std::uint64_t)))
+        return false;
+
+    for (std::size_t i = 0; i < words.size (); ++i)
+        words_[i].store (words[i], std::memory_order_relaxed);
+    inserts_.store (header[2]);
+
+    return true;
+}
+
+}
+}
@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_NODESTORE_KEYFILTER_H_INCLUDED
+#define RIPPLE_NODESTORE_KEYFILTER_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A blocked Bloom filter over the keys stored in a backend.
+
+    A negative answer is definite, so a lookup for a key which was never
+    inserted can usually be answered without reading the backend. All the
+    bits for a key fall in a single 64 byte block, so a query touches one
+    cache line.
+
+    Keys are hashes already, so their bytes are used directly to choose the
+    block and the bits within it.
+
+    Insertions and queries may be made concurrently.
+*/
+class KeyFilter
+{
+public:
+    /** Create an empty filter.
+        @param keys The number of keys to size the filter for.
+        @param bitsPerKey Bits of filter for each of those keys.
+    */
+    KeyFilter (std::size_t keys, std::size_t bitsPerKey);
+
+    KeyFilter (KeyFilter const&) = delete;
+    KeyFilter& operator= (KeyFilter const&) = delete;
+
+    void insert (uint256 const& key);
+
+    /** Return `false` if the key was definitely never inserted. */
+    bool mayContain (uint256 const& key) const;
+
+    /** The number of insertions, including repeated keys. */
+    std::uint64_t getInsertCount () const
+    {
+        return inserts_.load (std::memory_order_relaxed);
+    }
+
+    /** The size of the filter in bytes. */
+    std::size_t getSize () const
+    {
+        return blocks_ * blockBytes;
+    }
+
+    /** Write the filter to a file.
+        @return `true` on success.
+    */
+    bool save (std::string const& path) const;
+
+    /** Read a filter written by save.
+
+        The filter must have been written with the same size.
+
+        @return `true` on success, otherwise the filter is left unchanged.
+    */
+    bool load (std::string const& path);
+
+private:
+    static std::size_t const blockBytes = 64;
+    static std::size_t const blockWords = blockBytes / 8;
+
+    // Bits set for each key
+    static int const probes = 8;
+
+    std::size_t blocks_;
+    std::unique_ptr <std::atomic <std::uint64_t>[]> words_;
+    std::atomic <std::uint64_t> inserts_;
+};
+
+}
+}
+
+#endif
@@ -21,6 +21,8 @@
 #include <ripple/nodestore/impl/ManagerImp.h>
 #include <ripple/nodestore/impl/DatabaseImp.h>
 #include <ripple/nodestore/impl/DatabaseRotatingImp.h>
+#include <ripple/nodestore/impl/DatabaseShardImp.h>
+#include <ripple/nodestore/impl/FilteredBackend.h>
 #include <ripple/basics/StringUtilities.h>
 #include <beast/utility/ci_char_traits.h>
 #include <beast/cxx14/memory.h> // <memory>
@@ -82,6 +84,10 @@ ManagerImp::make_Backend (
         missing_backend ();
     }
 
+    if (get<std::size_t> (parameters, "filter_keys") > 0)
+        backend = std::make_unique <FilteredBackend> (
+            std::move (backend), parameters, journal);
+
     return backend;
 }
 
@@ -94,14 +100,19 @@ ManagerImp::make_Database (
     Section const& backendParameters,
     Section fastBackendParameters)
 {
-    std::unique_ptr <Backend> backend (make_Backend (
-        backendParameters, scheduler, journal));
-
     std::unique_ptr <Backend> fastBackend (
         (fastBackendParameters.size () > 0)
             ? make_Backend (fastBackendParameters, scheduler, journal)
             : nullptr);
 
+    if (backendParameters.exists ("ledgers_per_shard"))
+        return std::make_unique <DatabaseShardImp> (name, scheduler,
+            readThreads, backendParameters, std::move (fastBackend),
+                journal);
+
+    std::unique_ptr <Backend> backend (make_Backend (
+        backendParameters, scheduler, journal));
+
     return std::make_unique <DatabaseImp> (name, scheduler, readThreads,
         std::move (backend), std::move (fastBackend), journal);
 }
@@ -33,6 +33,18 @@ enum
 
     // Fraction of the cache one query source can take
     ,asyncDivider = 8
+
+    // Most reads a prefetch thread hands to a back end at once
+    ,asyncFetchBatchSize = 64
+
+    // Ledgers in each shard of a sharded database
+    ,defaultLedgersPerShard = 16384
+
+    // Shards of a sharded database which may be open at once
+    ,defaultMaxOpenShards = 8
+
+    // Bits of key filter for each key it is sized for
+    ,defaultFilterBitsPerKey = 10
 };
 
 }
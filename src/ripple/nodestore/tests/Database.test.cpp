@@ -180,6 +180,77 @@ public:
 
     //--------------------------------------------------------------------------
 
+    void testShards (std::int64_t const seedValue)
+    {
+        testcase ("shards");
+
+        DummyScheduler scheduler;
+        beast::Journal j;
+
+        beast::UnitTestUtilities::TempDirectory node_db ("node_db");
+        std::string const path = node_db.getFullPathName ().toStdString ();
+        Section nodeParams;
+        nodeParams.set ("type", "nudb");
+        nodeParams.set ("path", path);
+        nodeParams.set ("ledgers_per_shard", "100");
+        nodeParams.set ("open_shards", "2");
+
+        Batch batch;
+        createPredictableBatch (batch, 300, seedValue);
+
+        // Spread the objects over ledgers in shards 0, 1 and 3
+        auto ledgerOf = [](int i) -> std::uint32_t
+        {
+            return 50 + 100 * (i % 3) + ((i % 3 == 2) ? 100 : 0);
+        };
+
+        {
+            std::unique_ptr <Database> db = Manager::instance().make_Database (
+                "test", scheduler, j, 2, nodeParams);
+
+            for (int i = 0; i < batch.size (); ++i)
+            {
+                Blob data (batch[i]->getData ());
+                db->store (batch[i]->getType (), std::move (data),
+                    batch[i]->getHash (), ledgerOf (i));
+            }
+
+            Batch copy;
+            fetchCopyOfBatch (*db, &copy, batch);
+            expect (areBatchesEqual (batch, copy), "Should be equal");
+        }
+
+        {
+            // Reopen so that nothing is cached
+            std::unique_ptr <Database> db = Manager::instance().make_Database (
+                "test", scheduler, j, 2, nodeParams);
+
+            // Objects which recent ledgers need are copied forward
+            expect (db->fetch (batch[0]->getHash (), 350) != nullptr);
+            expect (db->fetch (batch[1]->getHash ()) != nullptr);
+
+            for (int i = 0; i < batch.size (); ++i)
+            {
+                auto const object = db->fetch (batch[i]->getHash (),
+                    ledgerOf (i));
+                expect (object && object->isCloneOf (batch[i]),
+                    "Should be found in its own shard");
+            }
+        }
+
+        Section shardParams (nodeParams);
+        shardParams.set ("path", path + "/3");
+        std::unique_ptr <Backend> current = Manager::instance().make_Backend (
+            shardParams, scheduler, j);
+        NodeObject::Ptr object;
+        expect (current->fetch (batch[0]->getHash ().cbegin (), &object) == ok,
+            "Should be copied forward");
+        expect (current->fetch (batch[1]->getHash ().cbegin (), &object) ==
+            notFound, "Should not be copied forward");
+    }
+
+    //--------------------------------------------------------------------------
+
     void runBackendTests (bool useEphemeralDatabase, std::int64_t const seedValue)
     {
         testNodeStore ("nudb", useEphemeralDatabase, true, seedValue);
@@ -221,6 +292,8 @@ public:
         runBackendTests (true, seedValue);
 
         runImportTests (seedValue);
+
+        testShards (seedValue);
     }
 };
 
@@ -0,0 +1,184 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/nodestore/tests/Base.test.h>
+#include <ripple/nodestore/DummyScheduler.h>
+#include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/impl/KeyFilter.h>
+#include <boost/filesystem.hpp>
+
+namespace ripple {
+namespace NodeStore {
+
+class KeyFilter_test : public TestBase
+{
+public:
+    void testFilter (std::int64_t const seedValue)
+    {
+        testcase ("filter");
+
+        Batch batch;
+        createPredictableBatch (batch, numObjectsToTest, seedValue);
+
+        Batch missing;
+        createPredictableBatch (missing, numObjectsToTest, seedValue + 1);
+
+        KeyFilter filter (numObjectsToTest, 10);
+
+        for (auto const& object : batch)
+            expect (! filter.mayContain (object->getHash ()),
+                "Empty filter should not match");
+
+        for (auto const& object : batch)
+            filter.insert (object->getHash ());
+
+        expect (filter.getInsertCount () == batch.size ());
+
+        bool found = true;
+        for (auto const& object : batch)
+            found = found && filter.mayContain (object->getHash ());
+        expect (found, "Inserted keys should match");
+
+        int falsePositives = 0;
+        for (auto const& object : missing)
+            if (filter.mayContain (object->getHash ()))
+                ++falsePositives;
+        expect (falsePositives < missing.size () / 20,
+            "Too many false positives");
+    }
+
+    void testSave (std::int64_t const seedValue)
+    {
+        testcase ("save");
+
+        beast::UnitTestUtilities::TempDirectory dir ("key_filter");
+        auto const folder = boost::filesystem::path (
+            dir.getFullPathName ().toStdString ());
+        boost::filesystem::create_directories (folder);
+        auto const path = (folder / "keys.filter").string ();
+
+        Batch batch;
+        createPredictableBatch (batch, numObjectsToTest, seedValue);
+
+        KeyFilter filter (numObjectsToTest, 10);
+        for (auto const& object : batch)
+            filter.insert (object->getHash ());
+        expect (filter.save (path), "Should save");
+
+        KeyFilter copy (numObjectsToTest, 10);
+        expect (copy.load (path), "Should load");
+        expect (copy.getInsertCount () == filter.getInsertCount ());
+
+        bool found = true;
+        for (auto const& object : batch)
+            found = found && copy.mayContain (object->getHash ());
+        expect (found, "Loaded filter should match");
+
+        KeyFilter other (numObjectsToTest * 2, 10);
+        expect (! other.load (path), "Size mismatch should not load");
+    }
+
+    void testBackend (std::int64_t const seedValue)
+    {
+        testcase ("backend");
+
+        DummyScheduler scheduler;
+        beast::Journal j;
+
+        beast::UnitTestUtilities::TempDirectory dir ("node_db");
+        auto const path = dir.getFullPathName ().toStdString ();
+        auto const file = (boost::filesystem::path (path) /
+            "keys.filter").string ();
+
+        Section params;
+        params.set ("type", "nudb");
+        params.set ("path", path);
+        params.set ("filter_keys", std::to_string (numObjectsToTest));
+
+        Batch batch;
+        createPredictableBatch (batch, numObjectsToTest, seedValue);
+
+        Batch missing;
+        createPredictableBatch (missing, numObjectsToTest, seedValue + 1);
+
+        {
+            auto backend = Manager::instance().make_Backend (
+                params, scheduler, j);
+
+            storeBatch (*backend, batch);
+
+            Batch copy;
+            fetchCopyOfBatch (*backend, &copy, batch);
+            expect (areBatchesEqual (batch, copy), "Should be equal");
+
+            fetchMissing (*backend, missing);
+
+            Json::Value counts (Json::objectValue);
+            backend->getCounts (counts);
+            Json::Value const& c = counts[backend->getName ()];
+            expect (c["checks"].asUInt () == batch.size () + missing.size ());
+            expect (c["skipped"].asUInt () > missing.size () * 9 / 10,
+                "Most missing keys should be skipped");
+        }
+
+        expect (boost::filesystem::exists (file), "Filter should be saved");
+
+        {
+            // Reopen using the saved filter
+            auto backend = Manager::instance().make_Backend (
+                params, scheduler, j);
+            expect (! boost::filesystem::exists (file),
+                "Saved filter should be removed while open");
+
+            Batch copy;
+            fetchCopyOfBatch (*backend, &copy, batch);
+            expect (areBatchesEqual (batch, copy), "Should be equal");
+        }
+
+        boost::filesystem::remove (file);
+
+        {
+            // Reopen without a saved filter, as after a crash
+            auto backend = Manager::instance().make_Backend (
+                params, scheduler, j);
+
+            Batch copy;
+            fetchCopyOfBatch (*backend, &copy, batch);
+            std::sort (batch.begin (), batch.end (), NodeObject::LessThan ());
+            std::sort (copy.begin (), copy.end (), NodeObject::LessThan ());
+            expect (areBatchesEqual (batch, copy), "Should be equal");
+        }
+    }
+
+    void run ()
+    {
+        int const seedValue = 50;
+
+        testFilter (seedValue);
+        testSave (seedValue);
+        testBackend (seedValue);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(KeyFilter,ripple_core,ripple);
+
+}
+}
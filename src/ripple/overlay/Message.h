@@ -56,6 +56,12 @@ public:
 
     Message (::google::protobuf::Message const& message, int type);
 
+    /** Construct from a message which is already serialized in parts.
+        Serialized protocol buffers may be concatenated, so parts of a
+        message which are sent often can be encoded once and reused.
+    */
+    Message (std::vector <boost::asio::const_buffer> const& parts, int type);
+
     /** Retrieve the packed message data. */
     std::vector <uint8_t> const&
     getBuffer () const
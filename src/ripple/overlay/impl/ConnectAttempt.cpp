@@ -338,6 +338,7 @@ ConnectAttempt::makeRequest (bool crawl,
     m.headers.append ("Connection", "Upgrade");
     m.headers.append ("Connect-As", "Peer");
     m.headers.append ("Crawl", crawl ? "public" : "private");
+    m.headers.append ("Ledger-Data", "compact");
     return m;
 }
 
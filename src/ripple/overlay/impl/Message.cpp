@@ -39,6 +39,21 @@ Message::Message (::google::protobuf::Message const& message, int type)
     }
 }
 
+Message::Message (std::vector <boost::asio::const_buffer> const& parts,
+    int type)
+{
+    std::size_t const messageBytes = boost::asio::buffer_size (parts);
+
+    assert (messageBytes != 0);
+
+    mBuffer.resize (kHeaderBytes + messageBytes);
+
+    encodeHeader (static_cast <unsigned> (messageBytes), type);
+
+    boost::asio::buffer_copy (boost::asio::buffer (
+        &mBuffer [Message::kHeaderBytes], messageBytes), parts);
+}
+
 bool Message::operator== (Message const& other) const
 {
     return mBuffer == other.mBuffer;
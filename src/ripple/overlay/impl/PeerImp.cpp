@@ -34,6 +34,7 @@
 #include <ripple/json/json_reader.h>
 #include <ripple/resource/Fees.h>
 #include <ripple/server/ServerHandler.h>
+#include <ripple/shamap/SHAMapNodeBatch.h>
 #include <ripple/protocol/BuildInfo.h>
 #include <ripple/protocol/JsonFields.h>
 #include <beast/module/core/diagnostic/SemanticVersion.h>
@@ -221,6 +222,15 @@ PeerImp::crawl() const
     return beast::ci_equal(iter->second, "public");
 }
 
+bool
+PeerImp::compactLedgerData() const
+{
+    auto const iter = http_message_.headers.find("Ledger-Data");
+    if (iter == http_message_.headers.end())
+        return false;
+    return beast::ci_equal(iter->second, "compact");
+}
+
 std::string
 PeerImp::getVersion() const
 {
@@ -612,6 +622,7 @@ PeerImp::makeResponse (bool crawl,
     resp.headers.append("Connect-AS", "Peer");
     resp.headers.append("Server", BuildInfo::getFullVersionString());
     resp.headers.append ("Crawl", crawl ? "public" : "private");
+    resp.headers.append ("Ledger-Data", "compact");
     protocol::TMHello hello = buildHello(sharedValue, getApp());
     appendHello(resp, hello);
     return resp;
@@ -1025,7 +1036,7 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMLedgerData> const& m)
 {
     protocol::TMLedgerData& packet = *m;
 
-    if (m->nodes ().size () <= 0)
+    if ((m->nodes ().size () <= 0) && !m->has_packednodes ())
     {
         p_journal_.warning << "Ledger/TXset data with no nodes";
         return;
@@ -1033,10 +1044,51 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMLedgerData> const& m)
 
     if (m->has_requestcookie ())
     {
-        Peer::ptr target = overlay_.findPeerByShortID (m->requestcookie ());
+        auto const target = std::dynamic_pointer_cast<PeerImp> (
+            overlay_.findPeerByShortID (m->requestcookie ()));
         if (target)
         {
             m->clear_requestcookie ();
+
+            // The peer we relay to may not understand node batches,
+            // so send it each node in the plain wire format
+            if (m->has_packednodes () && !target->compactLedgerData ())
+            {
+                std::vector<SHAMapNodeID> nodeIDs;
+                std::vector<Slice> nodeData;
+                Blob unpacked;
+
+                try
+                {
+                    if (m->packednodes ().empty () ||
+                        !unpackNodes (makeSlice (m->packednodes ()),
+                            unpacked, nodeIDs, nodeData))
+                        throw std::runtime_error ("bad node batch");
+
+                    Serializer s;
+                    for (std::size_t i = 0; i < nodeIDs.size (); ++i)
+                    {
+                        SHAMapTreeNode treeNode (nodeData[i], 0, snfWIRE,
+                            uint256 (), false);
+                        s.erase ();
+                        treeNode.addRaw (s, snfWIRE);
+
+                        protocol::TMLedgerNode* node = packet.add_nodes ();
+                        node->set_nodeid (nodeIDs[i].getRawString ());
+                        node->set_nodedata (s.getDataPtr (), s.getLength ());
+                    }
+                }
+                catch (std::exception const&)
+                {
+                    p_journal_.warning << "Bad node batch to relay";
+                    fee_ = Resource::feeInvalidRequest;
+                    return;
+                }
+
+                m->clear_packednodes ();
+            }
+
+
             target->send (std::make_shared<Message> (
                 packet, protocol::mtLEDGER_DATA));
         }
@@ -2089,6 +2141,11 @@ PeerImp::getLedger (std::shared_ptr<protocol::TMGetLedger> const& m)
             (std::min(packet.querydepth(), 3u)) :
             (isHighLatency() ? 2 : 1);
 
+    // Peers which negotiated it get all the nodes as one batch
+    bool const packed = compactLedgerData ();
+    std::vector<SHAMapNodeID> batchIDs;
+    std::vector<Blob> batchNodes;
+
     for (int i = 0; i < packet.nodeids ().size (); ++i)
     {
         SHAMapNodeID mn (packet.nodeids (i).data (), packet.nodeids (i).size ());
@@ -2111,6 +2168,17 @@ PeerImp::getLedger (std::shared_ptr<protocol::TMGetLedger> const& m)
                 assert (nodeIDs.size () == rawNodes.size ());
                 if (p_journal_.trace) p_journal_.trace <<
                     "GetLedger: getNodeFat got " << rawNodes.size () << " nodes";
+
+                if (packed)
+                {
+                    batchIDs.insert (batchIDs.end (),
+                        nodeIDs.begin (), nodeIDs.end ());
+                    batchNodes.insert (batchNodes.end (),
+                        std::make_move_iterator (rawNodes.begin ()),
+                        std::make_move_iterator (rawNodes.end ()));
+                    continue;
+                }
+
                 std::vector<SHAMapNodeID>::iterator nodeIDIterator;
                 std::vector< Blob >::iterator rawNodeIterator;
 
@@ -2152,9 +2220,16 @@ PeerImp::getLedger (std::shared_ptr<protocol::TMGetLedger> const& m)
         }
     }
 
+    if (!batchIDs.empty ())
+    {
+        Blob const batch = packNodes (batchIDs, batchNodes);
+        reply.set_packednodes (batch.data (), batch.size ());
+    }
+
     if (p_journal_.info) p_journal_.info <<
         "Got request for " << packet.nodeids().size() << " nodes at depth " <<
-        depth << ", return " << reply.nodes().size() << " nodes";
+        depth << ", return " << (reply.nodes().size() + batchIDs.size()) <<
+            " nodes";
 
     Message::pointer oPacket = std::make_shared<Message> (
         reply, protocol::mtLEDGER_DATA);
@@ -238,6 +238,10 @@ public:
     bool
     crawl() const;
 
+    /** Returns `true` if the peer accepts node batches in ledger data. */
+    bool
+    compactLedgerData() const;
+
     bool
     cluster() const override
     {
@@ -241,6 +241,7 @@ JSS ( no_ripple );                  // out: AccountLines
 JSS ( no_ripple_peer );             // out: AccountLines
 JSS ( node );                       // in: UnlAdd, UnlDelete
                                     // out: LedgerEntrySet, LedgerEntry
+JSS ( node_backends );              // out: GetCounts
 JSS ( node_binary );                // out: LedgerEntry
 JSS ( node_hit_rate );              // out: GetCounts
 JSS ( node_read_bytes );            // out: GetCounts
@@ -81,13 +81,23 @@ public:
     /** Add an element to the template. */
     void push_back (SOElement const& r);
 
-    /** Retrieve the position of a named field. */
-    int getIndex (SField const&) const;
+    /** Retrieve the position of a named field.
+        @return The field's slot, or -1 if the template does not have it.
+    */
+    int getIndex (SField const& f) const
+    {
+        // Fields created after the table was built can't be in the template
+        int const num = f.getNum ();
+        if (num < 0 || num >= static_cast <int> (mIndex.size ()))
+            return -1;
+
+        return mIndex[num];
+    }
 
 private:
     list_type mTypes;
 
-    std::vector <int> mIndex;       // field num -> index
+    std::vector <int> mIndex;       // field num -> slot
 };
 
 } // ripple
@@ -140,7 +140,10 @@ public:
     setFName (SField const& n);
 
     SField const&
-    getFName() const;
+    getFName() const
+    {
+        return *fName;
+    }
 
     void
     addFieldID (Serializer& s) const;
@@ -27,6 +27,7 @@
 #include <ripple/protocol/SOTemplate.h>
 #include <ripple/protocol/impl/STVar.h>
 #include <boost/iterator/transform_iterator.hpp>
+#include <typeinfo>
 #include <utility>
 
 #include <beast/streams/debug_ostream.h>
@@ -278,7 +279,7 @@ public:
             rf = makeFieldPresent (field);
 
         using Bits = STBitString<160>;
-        if (auto cf = dynamic_cast<Bits*> (rf))
+        if (auto cf = downcast<Bits> (rf))
             cf->setValue (v);
         else
             throw std::runtime_error ("Wrong field type");
@@ -301,6 +302,17 @@ public:
     }
 
 private:
+    // Fields almost always hold exactly the type asked for, and comparing
+    // the type_info is much cheaper than a dynamic_cast. The cast remains
+    // for derived types, such as an STAccount read as an STBlob.
+    template <class T, class U>
+    static T* downcast (U* p)
+    {
+        if (p != nullptr && typeid (*p) == typeid (T))
+            return static_cast <T*> (p);
+        return dynamic_cast <T*> (p);
+    }
+
     // Implementation for getting (most) fields that return by value.
     //
     // The remove_cv and remove_reference are necessitated by the STBitString
@@ -321,7 +333,7 @@ private:
         if (id == STI_NOTPRESENT)
             return V (); // optional field not present
 
-        const T* cf = dynamic_cast<const T*> (rf);
+        const T* cf = downcast<const T> (rf);
 
         if (!cf)
             throw std::runtime_error ("Wrong field type");
@@ -347,7 +359,7 @@ private:
         if (id == STI_NOTPRESENT)
             return empty; // optional field not present
 
-        const T* cf = dynamic_cast<const T*> (rf);
+        const T* cf = downcast<const T> (rf);
 
         if (!cf)
             throw std::runtime_error ("Wrong field type");
@@ -369,7 +381,7 @@ private:
         if (rf->getSType () == STI_NOTPRESENT)
             rf = makeFieldPresent (field);
 
-        T* cf = dynamic_cast<T*> (rf);
+        T* cf = downcast<T> (rf);
 
         if (!cf)
             throw std::runtime_error ("Wrong field type");
@@ -389,7 +401,7 @@ private:
         if (rf->getSType () == STI_NOTPRESENT)
             rf = makeFieldPresent (field);
 
-        T* cf = dynamic_cast<T*> (rf);
+        T* cf = downcast<T> (rf);
 
         if (!cf)
             throw std::runtime_error ("Wrong field type");
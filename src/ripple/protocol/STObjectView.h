@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_PROTOCOL_STOBJECTVIEW_H_INCLUDED
+#define RIPPLE_PROTOCOL_STOBJECTVIEW_H_INCLUDED
+
+#include <ripple/basics/Blob.h>
+#include <ripple/basics/Slice.h>
+#include <ripple/protocol/SField.h>
+#include <ripple/protocol/STAmount.h>
+#include <ripple/protocol/STVector256.h>
+#include <ripple/protocol/UintTypes.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ripple {
+
+/** A read-only view of a serialized STObject.
+
+    The view refers to the serialized bytes without copying them, and
+    decodes a field only when it is asked for. The first access records
+    where each top-level field begins, so further lookups do not rescan.
+
+    The caller must keep the bytes alive for the lifetime of the view.
+
+    Fields which are not present return a default value, as STObject does
+    for optional fields. Asking for a field with the wrong accessor throws.
+*/
+class STObjectView
+{
+public:
+    explicit
+    STObjectView (Slice const& data);
+
+    STObjectView (void const* data, std::size_t size);
+
+    STObjectView (STObjectView const&) = delete;
+    STObjectView& operator= (STObjectView const&) = delete;
+
+    bool isFieldPresent (SField const& field) const;
+
+    unsigned char getFieldU8 (SField const& field) const;
+    std::uint16_t getFieldU16 (SField const& field) const;
+    std::uint32_t getFieldU32 (SField const& field) const;
+    std::uint64_t getFieldU64 (SField const& field) const;
+    uint128 getFieldH128 (SField const& field) const;
+    uint160 getFieldH160 (SField const& field) const;
+    uint256 getFieldH256 (SField const& field) const;
+    Account getFieldAccount160 (SField const& field) const;
+    Blob getFieldVL (SField const& field) const;
+    STAmount getFieldAmount (SField const& field) const;
+    STVector256 getFieldV256 (SField const& field) const;
+
+    std::uint32_t getFlags () const
+    {
+        return getFieldU32 (sfFlags);
+    }
+
+private:
+    struct Entry
+    {
+        int code;
+        std::uint32_t offset;   // first byte after the field header
+        std::uint32_t size;     // bytes in the field body
+    };
+
+    enum
+    {
+        reserveSize = 20
+    };
+
+    Entry const* find (SField const& field, SerializedTypeID type) const;
+    void index () const;
+
+    std::uint8_t const* data_;
+    std::size_t size_;
+    mutable std::vector <Entry> fields_;
+    mutable bool indexed_ = false;
+};
+
+} // ripple
+
+#endif
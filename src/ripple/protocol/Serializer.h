@@ -23,6 +23,7 @@
 #include <ripple/protocol/SField.h>
 #include <ripple/basics/base_uint.h>
 #include <ripple/basics/Buffer.h>
+#include <ripple/basics/Slice.h>
 #include <beast/utility/noexcept.h>
 #include <cassert>
 #include <cstdint>
@@ -323,6 +324,12 @@ public:
     SerialIter (void const* data,
             std::size_t size) noexcept;
 
+    explicit
+    SerialIter (Slice const& slice) noexcept
+        : SerialIter (slice.data(), slice.size())
+    {
+    }
+
     explicit
     SerialIter (std::string const& s) noexcept
         : SerialIter(s.data(), s.size())
@@ -397,6 +404,14 @@ public:
     void
     getFieldID (int& type, int& name);
 
+    /** Advance past bytes without copying them. */
+    void
+    skip (int num);
+
+    /** Consume a variable length prefix and return the data length. */
+    int
+    getVLDataLength ();
+
     // VFALCO DEPRECATED Returns a copy
     Blob
     getRaw (int size);
@@ -409,8 +424,6 @@ public:
     getVLBuffer();
 
 private:
-    int getVLDataLength ();
-
     template<class T>
     T getRawHelper (int size);
 };
@@ -132,12 +132,6 @@ STBase::setFName (SField const& n)
     assert (fName);
 }
 
-SField const&
-STBase::getFName() const
-{
-    return *fName;
-}
-
 void
 STBase::addFieldID (Serializer& s) const
 {
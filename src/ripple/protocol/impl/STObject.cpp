@@ -106,24 +106,43 @@ bool STObject::setType (const SOTemplate& type)
 {
     bool valid = true;
     mType = &type;
+
+    // Use the template's slot table to find where each field
+    // belongs, rather than searching the fields for each slot.
+    auto const& elements = type.peek();
+    std::vector<detail::STVar*> slots (elements.size(), nullptr);
+    for (auto& e : v_)
+    {
+        int const slot = type.getIndex (e->getFName());
+        if (slot != -1 && slots[slot] == nullptr)
+        {
+            slots[slot] = &e;
+        }
+        else if (! e->getFName().isDiscardable())
+        {
+            // Anything left over in the object must be discardable
+            WriteLog (lsWARNING, STObject) <<
+                "setType( " << getFName ().getName () <<
+                ") invalid leftover " << e->getFName ().getName ();
+            valid = false;
+        }
+    }
+
     decltype(v_) v;
-    v.reserve(type.peek().size());
-    for (auto const& e : type.peek())
+    v.reserve(elements.size());
+    for (std::size_t i = 0; i < elements.size(); ++i)
     {
-        auto const iter = std::find_if(
-            v_.begin(), v_.end(), [&](detail::STVar const& b)
-                { return b.get().getFName() == e->e_field; });
-        if (iter != v_.end())
+        auto const& e = elements[i];
+        if (slots[i] != nullptr)
         {
-            if ((e->flags == SOE_DEFAULT) && iter->get().isDefault())
+            if ((e->flags == SOE_DEFAULT) && slots[i]->get().isDefault())
             {
                 WriteLog (lsWARNING, STObject) <<
                     "setType( " << getFName ().getName () <<
                     ") invalid default " << e->e_field.fieldName;
                 valid = false;
             }
-            v.emplace_back(std::move(*iter));
-            v_.erase(iter);
+            v.emplace_back(std::move(*slots[i]));
         }
         else
         {
@@ -137,17 +156,7 @@ bool STObject::setType (const SOTemplate& type)
             v.emplace_back(detail::nonPresentObject, e->e_field);
         }
     }
-    for (auto const& e : v_)
-    {
-        // Anything left over in the object must be discardable
-        if (! e->getFName().isDiscardable())
-        {
-            WriteLog (lsWARNING, STObject) <<
-                "setType( " << getFName ().getName () <<
-                ") invalid leftover " << e->getFName ().getName ();
-            valid = false;
-        }
-    }
+
     // Swap the template matching data in for the old data,
     // freeing any leftover junk
     v_.swap(v);
@@ -456,7 +465,7 @@ STObject& STObject::peekFieldObject (SField const& field)
     if (rf->getSType () == STI_NOTPRESENT)
         rf = makeFieldPresent (field);
 
-    STObject* cf = dynamic_cast<STObject*> (rf);
+    STObject* cf = downcast<STObject> (rf);
 
     if (!cf)
         throw std::runtime_error ("Wrong field type");
@@ -466,7 +475,7 @@ STObject& STObject::peekFieldObject (SField const& field)
 
 bool STObject::setFlag (std::uint32_t f)
 {
-    STUInt32* t = dynamic_cast<STUInt32*> (getPField (sfFlags, true));
+    STUInt32* t = downcast<STUInt32> (getPField (sfFlags, true));
 
     if (!t)
         return false;
@@ -477,7 +486,7 @@ bool STObject::setFlag (std::uint32_t f)
 
 bool STObject::clearFlag (std::uint32_t f)
 {
-    STUInt32* t = dynamic_cast<STUInt32*> (getPField (sfFlags));
+    STUInt32* t = downcast<STUInt32> (getPField (sfFlags));
 
     if (!t)
         return false;
@@ -493,7 +502,7 @@ bool STObject::isFlag (std::uint32_t f) const
 
 std::uint32_t STObject::getFlags (void) const
 {
-    const STUInt32* t = dynamic_cast<const STUInt32*> (peekAtPField (sfFlags));
+    const STUInt32* t = downcast<const STUInt32> (peekAtPField (sfFlags));
 
     if (!t)
         return 0;
@@ -609,7 +618,7 @@ RippleAddress STObject::getFieldAccount (SField const& field) const
 
     if (id == STI_NOTPRESENT) return RippleAddress ();
 
-    const STAccount* cf = dynamic_cast<const STAccount*> (rf);
+    const STAccount* cf = downcast<const STAccount> (rf);
 
     if (!cf)
         throw std::runtime_error ("Wrong field type");
@@ -626,7 +635,7 @@ Account STObject::getFieldAccount160 (SField const& field) const
     Account account;
     if (rf->getSType () != STI_NOTPRESENT)
     {
-        const STAccount* cf = dynamic_cast<const STAccount*> (rf);
+        const STAccount* cf = downcast<const STAccount> (rf);
 
         if (!cf)
             throw std::runtime_error ("Wrong field type");
@@ -731,7 +740,7 @@ void STObject::setFieldAccount (SField const& field, Account const& v)
     if (rf->getSType () == STI_NOTPRESENT)
         rf = makeFieldPresent (field);
 
-    STAccount* cf = dynamic_cast<STAccount*> (rf);
+    STAccount* cf = downcast<STAccount> (rf);
 
     if (!cf)
         throw std::runtime_error ("Wrong field type");
@@ -0,0 +1,272 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/protocol/STObjectView.h>
+#include <ripple/protocol/STPathSet.h>
+#include <ripple/protocol/Serializer.h>
+#include <stdexcept>
+
+namespace ripple {
+
+namespace {
+
+void skipField (SerialIter& sit, int type, int depth);
+
+// Skip the fields of an inner object or array up to its end marker
+void skipContents (SerialIter& sit, int endType, int depth)
+{
+    if (depth > 10)
+        throw std::runtime_error ("Maximum nesting depth exceeded");
+
+    for (;;)
+    {
+        int type;
+        int name;
+        sit.getFieldID (type, name);
+
+        if (type == endType && name == 1)
+            return;
+
+        skipField (sit, type, depth + 1);
+    }
+}
+
+// Skip the body of a field whose header has already been consumed
+void skipField (SerialIter& sit, int type, int depth)
+{
+    switch (type)
+    {
+    case STI_UINT8:     sit.skip (1); break;
+    case STI_UINT16:    sit.skip (2); break;
+    case STI_UINT32:    sit.skip (4); break;
+    case STI_UINT64:    sit.skip (8); break;
+    case STI_HASH128:   sit.skip (16); break;
+    case STI_HASH160:   sit.skip (20); break;
+    case STI_HASH256:   sit.skip (32); break;
+
+    case STI_AMOUNT:
+        // Native amounts are eight bytes, issued amounts add the issue
+        if ((sit.get64 () & STAmount::cNotNative) != 0)
+            sit.skip (40);
+        break;
+
+    case STI_VL:
+    case STI_ACCOUNT:
+    case STI_VECTOR256:
+        sit.skip (sit.getVLDataLength ());
+        break;
+
+    case STI_PATHSET:
+        for (;;)
+        {
+            int const iType = sit.get8 ();
+
+            if (iType == STPathElement::typeNone)
+                break;
+
+            if (iType == STPathElement::typeBoundary)
+                continue;
+
+            if (iType & STPathElement::typeAccount)
+                sit.skip (20);
+            if (iType & STPathElement::typeCurrency)
+                sit.skip (20);
+            if (iType & STPathElement::typeIssuer)
+                sit.skip (20);
+        }
+        break;
+
+    case STI_OBJECT:
+        skipContents (sit, STI_OBJECT, depth);
+        break;
+
+    case STI_ARRAY:
+        skipContents (sit, STI_ARRAY, depth);
+        break;
+
+    default:
+        throw std::runtime_error ("Unknown object type");
+    }
+}
+
+}
+
+STObjectView::STObjectView (Slice const& data)
+    : STObjectView (data.data (), data.size ())
+{
+}
+
+STObjectView::STObjectView (void const* data, std::size_t size)
+    : data_ (reinterpret_cast <std::uint8_t const*> (data))
+    , size_ (size)
+{
+}
+
+void STObjectView::index () const
+{
+    fields_.reserve (reserveSize);
+
+    SerialIter sit (data_, size_);
+    while (!sit.empty ())
+    {
+        int type;
+        int name;
+        sit.getFieldID (type, name);
+
+        if ((type == STI_OBJECT || type == STI_ARRAY) && name == 1)
+            throw std::runtime_error ("Illegal terminator in object");
+
+        Entry e;
+        e.code = field_code (type, name);
+        e.offset = static_cast <std::uint32_t> (size_ - sit.getBytesLeft ());
+        skipField (sit, type, 0);
+        e.size = static_cast <std::uint32_t> (
+            size_ - sit.getBytesLeft () - e.offset);
+        fields_.push_back (e);
+    }
+
+    indexed_ = true;
+}
+
+STObjectView::Entry const*
+STObjectView::find (SField const& field, SerializedTypeID type) const
+{
+    if (field.fieldType != type)
+        throw std::runtime_error ("Wrong field type");
+
+    if (!indexed_)
+        index ();
+
+    for (auto const& e : fields_)
+    {
+        if (e.code == field.fieldCode)
+            return &e;
+    }
+
+    return nullptr;
+}
+
+bool STObjectView::isFieldPresent (SField const& field) const
+{
+    return find (field, field.fieldType) != nullptr;
+}
+
+unsigned char STObjectView::getFieldU8 (SField const& field) const
+{
+    auto const e = find (field, STI_UINT8);
+    return e ? data_[e->offset] : 0;
+}
+
+std::uint16_t STObjectView::getFieldU16 (SField const& field) const
+{
+    auto const e = find (field, STI_UINT16);
+    if (!e)
+        return 0;
+    SerialIter sit (data_ + e->offset, e->size);
+    return sit.get16 ();
+}
+
+std::uint32_t STObjectView::getFieldU32 (SField const& field) const
+{
+    auto const e = find (field, STI_UINT32);
+    if (!e)
+        return 0;
+    SerialIter sit (data_ + e->offset, e->size);
+    return sit.get32 ();
+}
+
+std::uint64_t STObjectView::getFieldU64 (SField const& field) const
+{
+    auto const e = find (field, STI_UINT64);
+    if (!e)
+        return 0;
+    SerialIter sit (data_ + e->offset, e->size);
+    return sit.get64 ();
+}
+
+uint128 STObjectView::getFieldH128 (SField const& field) const
+{
+    auto const e = find (field, STI_HASH128);
+    if (!e)
+        return uint128 ();
+    SerialIter sit (data_ + e->offset, e->size);
+    return sit.get128 ();
+}
+
+uint160 STObjectView::getFieldH160 (SField const& field) const
+{
+    auto const e = find (field, STI_HASH160);
+    if (!e)
+        return uint160 ();
+    SerialIter sit (data_ + e->offset, e->size);
+    return sit.get160 ();
+}
+
+uint256 STObjectView::getFieldH256 (SField const& field) const
+{
+    auto const e = find (field, STI_HASH256);
+    if (!e)
+        return uint256 ();
+    SerialIter sit (data_ + e->offset, e->size);
+    return sit.get256 ();
+}
+
+Account STObjectView::getFieldAccount160 (SField const& field) const
+{
+    Account account;
+    auto const e = find (field, STI_ACCOUNT);
+    if (e)
+    {
+        SerialIter sit (data_ + e->offset, e->size);
+        if (sit.getVLDataLength () == (160 / 8))
+            account = sit.getBitString <160, detail::AccountTag> ();
+    }
+    return account;
+}
+
+Blob STObjectView::getFieldVL (SField const& field) const
+{
+    auto const e = find (field, STI_VL);
+    if (!e)
+        return Blob ();
+    SerialIter sit (data_ + e->offset, e->size);
+    return sit.getVL ();
+}
+
+STAmount STObjectView::getFieldAmount (SField const& field) const
+{
+    auto const e = find (field, STI_AMOUNT);
+    if (!e)
+        return STAmount ();
+    SerialIter sit (data_ + e->offset, e->size);
+    return STAmount (sit, field);
+}
+
+STVector256 STObjectView::getFieldV256 (SField const& field) const
+{
+    auto const e = find (field, STI_VECTOR256);
+    if (!e)
+        return STVector256 ();
+    SerialIter sit (data_ + e->offset, e->size);
+    return STVector256 (sit, field);
+}
+
+} // ripple
@@ -640,6 +640,17 @@ SerialIter::getFieldID (int& type, int& name)
     }
 }
 
+void
+SerialIter::skip (int num)
+{
+    if (num < 0 || remain_ < num)
+        throw std::runtime_error(
+            "invalid SerialIter skip");
+    p_ += num;
+    used_ += num;
+    remain_ -= num;
+}
+
 // getRaw for blob or buffer
 template<class T>
 T SerialIter::getRawHelper (int size)
@@ -39,6 +39,7 @@ public:
         testSerialization();
         testParseJSONArray();
         testParseJSONArrayWithInvalidChildrenObjects();
+        testSetType();
     }
 
     bool parseJSONString (std::string const& json, Json::Value& to)
@@ -192,6 +193,43 @@ public:
             unexpected (object3.getFieldVL (sfTestVL) != j, "STObject error");
         }
     }
+
+    void testSetType ()
+    {
+        testcase ("set type");
+
+        SOTemplate elements;
+        elements.push_back (SOElement (sfFlags, SOE_REQUIRED));
+        elements.push_back (SOElement (sfSequence, SOE_REQUIRED));
+        elements.push_back (SOElement (sfExpiration, SOE_OPTIONAL));
+        elements.push_back (SOElement (sfOwnerNode, SOE_REQUIRED));
+
+        STObject object (sfGeneric);
+        object.setFieldU64 (sfOwnerNode, 3);
+        object.setFieldU32 (sfSequence, 2);
+        object.setFieldU32 (sfFlags, 1);
+
+        expect (object.setType (elements), "valid");
+        expect (object.getCount () == 4, "count");
+        expect (object.isValidForType (), "order");
+        expect (! object.isFieldPresent (sfExpiration), "optional");
+        expect (object.getFieldU32 (sfSequence) == 2, "sequence");
+        expect (object.getFieldU64 (sfOwnerNode) == 3, "owner node");
+        expect (object.getFlags () == 1, "flags");
+
+        STObject invalid (sfGeneric);
+        invalid.setFieldU32 (sfFlags, 1);
+        invalid.setFieldU32 (sfSourceTag, 7);
+
+        expect (! invalid.setType (elements), "invalid");
+        expect (invalid.getCount () == 4, "invalid count");
+        expect (! invalid.isFieldPresent (sfSourceTag), "leftover");
+
+        // Reading a derived field type through its base still works
+        STObject account (sfGeneric);
+        account.setFieldAccount (sfAccount, Account (5));
+        expect (account.getFieldVL (sfAccount).size () == 20, "account");
+    }
 };
 
 BEAST_DEFINE_TESTSUITE(SerializedObject,ripple_data,ripple);
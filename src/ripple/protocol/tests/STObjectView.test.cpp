@@ -0,0 +1,148 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/protocol/STArray.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <ripple/protocol/STObject.h>
+#include <ripple/protocol/STObjectView.h>
+#include <ripple/protocol/STPathSet.h>
+#include <beast/unit_test/suite.h>
+
+namespace ripple {
+
+class STObjectView_test : public beast::unit_test::suite
+{
+public:
+    static Account makeAccount (int n)
+    {
+        Account a;
+        a.begin ()[0] = static_cast <unsigned char> (n);
+        a.begin ()[19] = 1;
+        return a;
+    }
+
+    void testOffer ()
+    {
+        testcase ("offer");
+
+        uint256 index;
+        index.begin ()[0] = 7;
+        uint256 book;
+        book.begin ()[5] = 3;
+
+        Issue const usd (to_currency ("USD"), makeAccount (2));
+
+        STLedgerEntry sle (ltOFFER, index);
+        sle.setFieldAccount (sfAccount, makeAccount (1));
+        sle.setFieldU32 (sfSequence, 42);
+        sle.setFieldU32 (sfFlags, 0x00020000);
+        sle.setFieldAmount (sfTakerPays, STAmount (usd, 1234, -2));
+        sle.setFieldAmount (sfTakerGets, STAmount (5000000));
+        sle.setFieldH256 (sfBookDirectory, book);
+        sle.setFieldU64 (sfBookNode, 0);
+        sle.setFieldU64 (sfOwnerNode, 0x0102030405060708ull);
+
+        Serializer s;
+        sle.add (s);
+        STObjectView const view (s.peekData ().data (), s.getDataLength ());
+
+        expect (view.getFieldU16 (sfLedgerEntryType) == ltOFFER);
+        expect (view.getFieldAccount160 (sfAccount) == makeAccount (1));
+        expect (view.getFieldU32 (sfSequence) == 42);
+        expect (view.getFlags () == 0x00020000);
+        expect (view.getFieldAmount (sfTakerPays) ==
+            sle.getFieldAmount (sfTakerPays));
+        expect (view.getFieldAmount (sfTakerPays).issue () == usd);
+        expect (view.getFieldAmount (sfTakerGets) ==
+            sle.getFieldAmount (sfTakerGets));
+        expect (view.getFieldH256 (sfBookDirectory) == book);
+        expect (view.getFieldU64 (sfOwnerNode) == 0x0102030405060708ull);
+
+        // Absent fields behave like absent optional fields
+        expect (! view.isFieldPresent (sfExpiration));
+        expect (view.getFieldU32 (sfExpiration) == 0);
+        expect (view.getFieldAmount (sfBalance) == zero);
+
+        try
+        {
+            view.getFieldU64 (sfSequence);
+            fail ("wrong field type accepted");
+        }
+        catch (std::runtime_error const&)
+        {
+            pass ();
+        }
+    }
+
+    void testSkip ()
+    {
+        testcase ("skip nested fields");
+
+        STPath path;
+        path.push_back (STPathElement (makeAccount (3), noCurrency (),
+            noAccount ()));
+        path.push_back (STPathElement (STPathElement::typeCurrency |
+            STPathElement::typeIssuer, noAccount (), to_currency ("EUR"),
+            makeAccount (4)));
+        STPathSet paths (sfPaths);
+        paths.push_back (path);
+        paths.push_back (path);
+
+        STObject memo (sfMemo);
+        memo.setFieldVL (sfMemoData, Blob (300, 0xAB));
+        STArray memos (sfMemos);
+        memos.push_back (memo);
+        memos.push_back (memo);
+
+        std::vector <uint256> hashes (3);
+        hashes[1].begin ()[0] = 9;
+
+        STObject obj (sfGeneric);
+        obj.setFieldU8 (sfCloseResolution, 5);
+        obj.setFieldPathSet (sfPaths, paths);
+        obj.setFieldArray (sfMemos, memos);
+        obj.setFieldV256 (sfIndexes, STVector256 (hashes));
+        obj.setFieldH160 (sfTakerPaysCurrency, uint160 (7));
+        obj.setFieldU32 (sfFlags, 99);
+
+        Serializer s;
+        obj.add (s);
+        STObjectView const view (s.peekData ().data (), s.getDataLength ());
+
+        expect (view.getFieldU8 (sfCloseResolution) == 5);
+        expect (view.isFieldPresent (sfPaths));
+        expect (view.isFieldPresent (sfMemos));
+        expect (view.getFieldV256 (sfIndexes).size () == 3);
+        expect (view.getFieldV256 (sfIndexes)[1] == hashes[1]);
+        expect (view.getFieldH160 (sfTakerPaysCurrency) == uint160 (7));
+        expect (view.getFlags () == 99);
+    }
+
+    void run ()
+    {
+        testOffer ();
+        testSkip ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(STObjectView,ripple_data,ripple);
+
+} // ripple
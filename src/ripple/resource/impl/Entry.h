@@ -25,6 +25,7 @@
 #include <ripple/resource/impl/Tuning.h>
 #include <beast/chrono/abstract_clock.h>
 #include <beast/intrusive/List.h>
+#include <atomic>
 
 namespace ripple {
 namespace Resource {
@@ -92,8 +93,9 @@ struct Entry
     // Exponentially decaying balance of resource consumption
     DecayingSample <decayWindowSeconds, clock_type> local_balance;
 
-    // Normalized balance contribution from imports
-    int remote_balance;
+    // Normalized balance contribution from imports. This is changed under
+    // the table lock but read when charging, under the entry's shard lock.
+    std::atomic <int> remote_balance;
 
     // Time of the last warning
     clock_type::rep lastWarningTime;
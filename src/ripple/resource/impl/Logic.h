@@ -30,10 +30,26 @@
 #include <beast/Insight.h>
 #include <beast/threads/SharedData.h>
 #include <beast/utility/PropertyStream.h>
+#include <array>
+#include <cstdint>
+#include <mutex>
 
 namespace ripple {
 namespace Resource {
 
+/** Tracks the resource consumption of every consumer.
+
+    The table of entries, the lists of active and inactive entries and the
+    imported gossip are guarded by a single lock, which is only taken when
+    consumers come and go, for reporting and for periodic grooming.
+
+    Charges are made for every message and request, so the balance of an
+    entry is instead guarded by one of a fixed set of shard locks chosen by
+    the entry's address. Charging different consumers rarely contends, and
+    warn and drop decisions are always made on the exact balance.
+
+    When both are needed, the table lock is taken before a shard lock.
+*/
 class Logic
 {
 private:
@@ -81,7 +97,10 @@ private:
         beast::insight::Meter drop;
     };
 
+    typedef std::lock_guard <std::mutex> ShardLock;
+
     SharedState m_state;
+    std::array <std::mutex, chargeShards> m_shards;
     Stats m_stats;
     beast::abstract_clock <std::chrono::steady_clock>& m_clock;
     beast::Journal m_journal;
@@ -250,36 +269,36 @@ public:
 
         for (auto& inboundEntry : state->inbound)
         {
-            int localBalance = inboundEntry.local_balance.value (now);
+            int localBalance = this->localBalance (inboundEntry, now);
             if ((localBalance + inboundEntry.remote_balance) >= threshold)
             {
                 Json::Value& entry = (ret[inboundEntry.to_string()] = Json::objectValue);
                 entry[jss::local] = localBalance;
-                entry[jss::remote] = inboundEntry.remote_balance;
+                entry[jss::remote] = inboundEntry.remote_balance.load ();
                 entry[jss::type] = "outbound";
             }
 
         }
         for (auto& outboundEntry : state->outbound)
         {
-            int localBalance = outboundEntry.local_balance.value (now);
+            int localBalance = this->localBalance (outboundEntry, now);
             if ((localBalance + outboundEntry.remote_balance) >= threshold)
             {
                 Json::Value& entry = (ret[outboundEntry.to_string()] = Json::objectValue);
                 entry[jss::local] = localBalance;
-                entry[jss::remote] = outboundEntry.remote_balance;
+                entry[jss::remote] = outboundEntry.remote_balance.load ();
                 entry[jss::type] = "outbound";
             }
 
         }
         for (auto& adminEntry : state->admin)
         {
-            int localBalance = adminEntry.local_balance.value (now);
+            int localBalance = this->localBalance (adminEntry, now);
             if ((localBalance + adminEntry.remote_balance) >= threshold)
             {
                 Json::Value& entry = (ret[adminEntry.to_string()] = Json::objectValue);
                 entry[jss::local] = localBalance;
-                entry[jss::remote] = adminEntry.remote_balance;
+                entry[jss::remote] = adminEntry.remote_balance.load ();
                 entry[jss::type] = "admin";
             }
 
@@ -300,7 +319,7 @@ public:
         for (auto& inboundEntry : state->inbound)
         {
             Gossip::Item item;
-            item.balance = inboundEntry.local_balance.value (now);
+            item.balance = localBalance (inboundEntry, now);
             if (item.balance >= minimumGossipBalance)
             {
                 item.address = inboundEntry.key->address;
@@ -434,6 +453,19 @@ public:
         return Disposition::ok;
     }
 
+    // Returns the lock which guards the balance of an entry
+    std::mutex& shard (Entry const& entry)
+    {
+        return m_shards [(reinterpret_cast <std::uintptr_t> (&entry) /
+            sizeof (Entry)) % chargeShards];
+    }
+
+    int localBalance (Entry& entry, clock_type::time_point const now)
+    {
+        ShardLock lock (shard (entry));
+        return entry.local_balance.value (now);
+    }
+
     void acquire (Entry& entry, SharedState::Access& state)
     {
         ++entry.refcount;
@@ -478,7 +510,7 @@ public:
         state->table.erase (iter);
     }
 
-    Disposition charge (Entry& entry, Charge const& fee, SharedState::Access& state)
+    Disposition charge (Entry& entry, Charge const& fee, ShardLock const&)
     {
         clock_type::time_point const now (m_clock.now());
         int const balance (entry.add (fee.cost(), now));
@@ -487,14 +519,14 @@ public:
         return disposition (balance);
     }
 
-    bool warn (Entry& entry, SharedState::Access& state)
+    bool warn (Entry& entry, ShardLock const& lock)
     {
         bool notify (false);
         clock_type::rep const elapsed (m_clock.elapsed());
         if (entry.balance (m_clock.now()) >= warningThreshold &&
             elapsed != entry.lastWarningTime)
         {
-            charge (entry, feeWarning, state);
+            charge (entry, feeWarning, lock);
             notify = true;
             entry.lastWarningTime = elapsed;
         }
@@ -509,7 +541,7 @@ public:
         return notify;
     }
 
-    bool disconnect (Entry& entry, SharedState::Access& state)
+    bool disconnect (Entry& entry, ShardLock const& lock)
     {
         bool drop (false);
         clock_type::time_point const now (m_clock.now());
@@ -524,14 +556,14 @@ public:
             // Adding feeDrop at this point keeps the dropped connection
             // from re-connecting for at least a little while after it is
             // dropped.
-            charge (entry, feeDrop, state);
+            charge (entry, feeDrop, lock);
             ++m_stats.drop;
             drop = true;
         }
         return drop;
     }
 
-    int balance (Entry& entry, SharedState::Access& state)
+    int balance (Entry& entry, ShardLock const&)
     {
         return entry.balance (m_clock.now());
     }
@@ -552,8 +584,8 @@ public:
 
     Disposition charge (Entry& entry, Charge const& fee)
     {
-        SharedState::Access state (m_state);
-        return charge (entry, fee, state);
+        ShardLock lock (shard (entry));
+        return charge (entry, fee, lock);
     }
 
     bool warn (Entry& entry)
@@ -561,8 +593,8 @@ public:
         if (entry.admin())
             return false;
 
-        SharedState::Access state (m_state);
-        return warn (entry, state);
+        ShardLock lock (shard (entry));
+        return warn (entry, lock);
     }
 
     bool disconnect (Entry& entry)
@@ -570,14 +602,14 @@ public:
         if (entry.admin())
             return false;
 
-        SharedState::Access state (m_state);
-        return disconnect (entry, state);
+        ShardLock lock (shard (entry));
+        return disconnect (entry, lock);
     }
 
     int balance (Entry& entry)
     {
-        SharedState::Access state (m_state);
-        return balance (entry, state);
+        ShardLock lock (shard (entry));
+        return balance (entry, lock);
     }
 
     //--------------------------------------------------------------------------
@@ -593,9 +625,10 @@ public:
             if (entry.refcount != 0)
                 item ["count"] = entry.refcount;
             item ["name"] = entry.to_string();
-            item ["balance"] = entry.balance(now);
-            if (entry.remote_balance != 0)
-                item ["remote_balance"] = entry.remote_balance;
+            int const remoteBalance = entry.remote_balance;
+            item ["balance"] = localBalance (entry, now) + remoteBalance;
+            if (remoteBalance != 0)
+                item ["remote_balance"] = remoteBalance;
         }
     }
 
@@ -44,6 +44,9 @@ enum
 
     // Number of seconds until imported gossip expires
     ,gossipExpirationSeconds    = 30
+
+    // Number of locks guarding the balances of entries
+    ,chargeShards               = 64
 };
 
 }
@@ -23,6 +23,8 @@
 #include <beast/chrono/manual_clock.h>
 #include <beast/module/core/maths/Random.h>
 #include <boost/utility/base_from_member.hpp>
+#include <thread>
+#include <vector>
 
 namespace ripple {
 namespace Resource {
@@ -241,12 +243,51 @@ public:
         pass();
     }
 
+    void testConcurrentCharges (beast::Journal j)
+    {
+        testcase ("Concurrent charges");
+
+        TestLogic logic (j);
+
+        int const threads = 4;
+        int const charges = 1000;
+
+        std::vector <Consumer> consumers;
+        for (int i = 0; i < threads; ++i)
+            consumers.push_back (logic.newInboundEndpoint (
+                beast::IP::Endpoint (beast::IP::AddressV4 (207, 127, 82, 10 + i))));
+        Consumer shared (logic.newInboundEndpoint (
+            beast::IP::Endpoint::from_string ("207.127.82.1")));
+
+        // The clock does not move, so no charge decays
+        std::vector <std::thread> workers;
+        for (int i = 0; i < threads; ++i)
+        {
+            workers.emplace_back ([&, i]()
+            {
+                for (int n = 0; n < charges; ++n)
+                {
+                    consumers[i].charge (Charge (decayWindowSeconds));
+                    shared.charge (Charge (decayWindowSeconds));
+                }
+            });
+        }
+        for (auto& worker : workers)
+            worker.join ();
+
+        for (auto& c : consumers)
+            expect (c.balance () == charges, "Wrong balance");
+        expect (shared.balance () == threads * charges, "Wrong shared balance");
+        expect (shared.disposition () == drop);
+    }
+
     void run()
     {
         beast::Journal j;
 
         testDrop (j);
         testCharges (j);
+        testConcurrentCharges (j);
         testImports (j);
         testImport (j);
     }
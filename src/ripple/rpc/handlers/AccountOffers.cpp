@@ -88,7 +88,6 @@ Json::Value doAccountOffers (RPC::Context& context)
 
     Account const& raAccount (rippleAddress.getAccountID ());
     Json::Value& jsonOffers (result[jss::offers] = Json::arrayValue);
-    std::vector <SLE::pointer> offers;
     unsigned int reserve (limit);
     uint256 startAfter;
     std::uint64_t startHint;
@@ -120,48 +119,41 @@ Json::Value doAccountOffers (RPC::Context& context)
         sleOffer->getFieldAmount (sfTakerGets).setJson (obj[jss::taker_gets]);
         obj[jss::seq] = sleOffer->getFieldU32 (sfSequence);
         obj[jss::flags] = sleOffer->getFieldU32 (sfFlags);
-
-        offers.reserve (reserve);
     }
     else
     {
         startHint = 0;
         // We have no start point, limit should be one higher than requested.
-        offers.reserve (++reserve);
+        ++reserve;
     }
 
-    if (! ledger->visitAccountItems (raAccount, startAfter, startHint, reserve,
-        [&offers](SLE::ref offer)
+    // Offers are read straight from their serialized form, the last one
+    // visited only supplies the marker.
+    unsigned int count (0);
+    if (! ledger->visitAccountItemViews (raAccount, startAfter, startHint,
+        reserve, [&](uint256 const& index, STObjectView const& offer)
         {
-            if (offer->getType () == ltOFFER)
+            if (offer.getFieldU16 (sfLedgerEntryType) != ltOFFER)
+                return false;
+
+            if (++count == reserve)
             {
-                offers.emplace_back (offer);
+                result[jss::limit] = limit;
+                result[jss::marker] = to_string (index);
                 return true;
             }
 
-            return false;
+            Json::Value& obj (jsonOffers.append (Json::objectValue));
+            offer.getFieldAmount (sfTakerPays).setJson (obj[jss::taker_pays]);
+            offer.getFieldAmount (sfTakerGets).setJson (obj[jss::taker_gets]);
+            obj[jss::seq] = offer.getFieldU32 (sfSequence);
+            obj[jss::flags] = offer.getFlags ();
+            return true;
         }))
     {
         return rpcError (rpcINVALID_PARAMS);
     }
 
-    if (offers.size () == reserve)
-    {
-        result[jss::limit] = limit;
-
-        result[jss::marker] = to_string (offers.back ()->getIndex ());
-        offers.pop_back ();
-    }
-
-    for (auto const& offer : offers)
-    {
-        Json::Value& obj (jsonOffers.append (Json::objectValue));
-        offer->getFieldAmount (sfTakerPays).setJson (obj[jss::taker_pays]);
-        offer->getFieldAmount (sfTakerGets).setJson (obj[jss::taker_gets]);
-        obj[jss::seq] = offer->getFieldU32 (sfSequence);
-        obj[jss::flags] = offer->getFieldU32 (sfFlags);
-    }
-
     context.loadType = Resource::feeMediumBurdenRPC;
     return result;
 }
@@ -96,6 +96,11 @@ Json::Value doGetCounts (RPC::Context& context)
     ret[jss::node_written_bytes] = app.getNodeStore().getStoreSize();
     ret[jss::node_read_bytes] = app.getNodeStore().getFetchSize();
 
+    Json::Value backends (Json::objectValue);
+    app.getNodeStore().getBackendCounts (backends);
+    if (backends.size () > 0)
+        ret[jss::node_backends] = backends;
+
     return ret;
 }
 
@@ -79,7 +79,7 @@ Json::Value doLedgerData (RPC::Context& context)
 
     for (;;)
     {
-       std::shared_ptr<SHAMapItem> item = map.peekNextItem (resumePoint);
+       SHAMapItem::pointer item = map.peekNextItem (resumePoint);
        if (!item)
            break;
        resumePoint = item->getTag();
@@ -94,13 +94,13 @@ Json::Value doLedgerData (RPC::Context& context)
        if (isBinary)
        {
            Json::Value& entry = nodes.append (Json::objectValue);
-           entry[jss::data] = strHex (
-               item->peekData().begin(), item->peekData().size());
+           entry[jss::data] = strHex (item->data (), item->size ());
            entry[jss::index] = to_string (item->getTag ());
        }
        else
        {
-           SLE sle (item->peekSerializer(), item->getTag ());
+           SerialIter sit (item->slice ());
+           SLE sle (sit, item->getTag ());
            Json::Value& entry = nodes.append (sle.getJson (0));
            entry[jss::index] = to_string (item->getTag ());
        }
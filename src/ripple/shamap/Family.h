@@ -21,6 +21,7 @@
 #define RIPPLE_SHAMAP_FAMILY_H_INCLUDED
 
 #include <ripple/shamap/FullBelowCache.h>
+#include <ripple/shamap/FullBelowStore.h>
 #include <ripple/shamap/TreeNodeCache.h>
 #include <ripple/nodestore/Database.h>
 #include <cstdint>
@@ -41,6 +42,14 @@ public:
     FullBelowCache const&
     fullbelow() const = 0;
 
+    virtual
+    FullBelowStore&
+    fullbelowstore() = 0;
+
+    virtual
+    FullBelowStore const&
+    fullbelowstore() const = 0;
+
     virtual
     TreeNodeCache&
     treecache() = 0;
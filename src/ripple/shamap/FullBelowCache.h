@@ -83,6 +83,18 @@ public:
         return m_cache.size ();
     }
 
+    /** Set the number of items the cache tries to hold. */
+    void setTargetSize (size_type s)
+    {
+        m_cache.setTargetSize (s);
+    }
+
+    /** Return the cumulative number of hits and misses. */
+    std::pair <std::uint64_t, std::uint64_t> getHitsAndMisses () const
+    {
+        return m_cache.getHitsAndMisses ();
+    }
+
     /** Remove expired cache items.
         Thread safety:
             Safe to call from any thread.
@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_SHAMAP_FULLBELOWSTORE_H_INCLUDED
+#define RIPPLE_SHAMAP_FULLBELOWSTORE_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <beast/nudb/file.h>
+#include <beast/utility/Journal.h>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+/** Persistent record of trees known to be complete in the node store.
+
+    The FullBelowCache forgets everything on restart, so a server that has
+    already verified a ledger walks every node of it again the next time
+    the ledger is acquired or checked. This record keeps the root hashes of
+    trees that were proven complete, so that the walk can be skipped.
+
+    The record is a flat file of 32-byte root hashes following a header
+    record, kept inside the node store directory so that removing the node
+    store also removes the record. New hashes are only written out by
+    sweep (), which gives the node store time to commit the nodes first.
+    When the file reaches its limit, the older half is discarded.
+
+    The record must be cleared whenever nodes are deleted from the node
+    store, for example when online delete rotates the backends.
+
+    All member functions are thread safe.
+*/
+class FullBelowStore
+{
+public:
+    enum
+    {
+        defaultMaxRecords = 131072
+    };
+
+    explicit
+    FullBelowStore (beast::Journal journal,
+        std::size_t maxRecords = defaultMaxRecords);
+
+    ~FullBelowStore ();
+
+    FullBelowStore (FullBelowStore const&) = delete;
+    FullBelowStore& operator= (FullBelowStore const&) = delete;
+
+    /** Open or create the record file and load the known roots.
+        @return `true` if the record is usable.
+    */
+    bool open (std::string const& path);
+
+    /** Close the file. Roots not yet written out are forgotten. */
+    void close ();
+
+    bool isOpen () const;
+
+    /** Return `true` if the tree with this root is known to be complete. */
+    bool contains (uint256 const& hash) const;
+
+    /** Remember that the tree with this root is complete. */
+    void insert (uint256 const& hash);
+
+    /** Forget every known root, in memory and on disk. */
+    void clear ();
+
+    /** Write out roots inserted since the last sweep. */
+    void sweep ();
+
+    /** Return the number of known roots. */
+    std::size_t size () const;
+
+    /** Return the known roots, oldest first. */
+    std::vector <uint256> getRoots () const;
+
+private:
+    bool load ();
+    void write (std::vector <uint256> const& hashes);
+    void compact ();
+
+    static std::size_t offset (std::size_t record)
+    {
+        return record * uint256::bytes;
+    }
+
+    beast::Journal j_;
+    std::size_t const maxRecords_;
+    mutable std::mutex mutex_;
+    mutable beast::nudb::native_file file_;
+    hash_set <uint256> known_;
+    std::vector <uint256> pending_;
+    std::size_t records_ = 0;
+};
+
+} // ripple
+
+#endif
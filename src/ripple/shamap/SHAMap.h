@@ -36,6 +36,7 @@
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/shared_lock_guard.hpp>
 #include <boost/thread/shared_mutex.hpp>
+#include <functional>
 #include <stack>
 
 namespace ripple {
@@ -89,8 +90,7 @@ private:
     bool                            backed_ = true; // Map is backed by the database
 
 public:
-    using DeltaItem = std::pair<std::shared_ptr<SHAMapItem>,
-                                std::shared_ptr<SHAMapItem>>;
+    using DeltaItem = std::pair<SHAMapItem::pointer, SHAMapItem::pointer>;
     using Delta     = std::map<uint256, DeltaItem>;
 
     ~SHAMap ();
@@ -124,24 +124,24 @@ public:
     uint256 getHash () const;
 
     // save a copy if you have a temporary anyway
-    bool updateGiveItem (std::shared_ptr<SHAMapItem> const&, bool isTransaction, bool hasMeta);
-    bool addGiveItem (std::shared_ptr<SHAMapItem> const&, bool isTransaction, bool hasMeta);
+    bool updateGiveItem (SHAMapItem::pointer const&, bool isTransaction, bool hasMeta);
+    bool addGiveItem (SHAMapItem::pointer const&, bool isTransaction, bool hasMeta);
 
     // save a copy if you only need a temporary
-    std::shared_ptr<SHAMapItem> peekItem (uint256 const& id) const;
-    std::shared_ptr<SHAMapItem> peekItem (uint256 const& id, uint256 & hash) const;
-    std::shared_ptr<SHAMapItem> peekItem (uint256 const& id, SHAMapTreeNode::TNType & type) const;
+    SHAMapItem::pointer peekItem (uint256 const& id) const;
+    SHAMapItem::pointer peekItem (uint256 const& id, uint256 & hash) const;
+    SHAMapItem::pointer peekItem (uint256 const& id, SHAMapTreeNode::TNType & type) const;
 
     // traverse functions
-    std::shared_ptr<SHAMapItem> peekFirstItem () const;
-    std::shared_ptr<SHAMapItem> peekFirstItem (SHAMapTreeNode::TNType & type) const;
-    std::shared_ptr<SHAMapItem> peekLastItem () const;
-    std::shared_ptr<SHAMapItem> peekNextItem (uint256 const& ) const;
-    std::shared_ptr<SHAMapItem> peekNextItem (uint256 const& , SHAMapTreeNode::TNType & type) const;
-    std::shared_ptr<SHAMapItem> peekPrevItem (uint256 const& ) const;
+    SHAMapItem::pointer peekFirstItem () const;
+    SHAMapItem::pointer peekFirstItem (SHAMapTreeNode::TNType & type) const;
+    SHAMapItem::pointer peekLastItem () const;
+    SHAMapItem::pointer peekNextItem (uint256 const& ) const;
+    SHAMapItem::pointer peekNextItem (uint256 const& , SHAMapTreeNode::TNType & type) const;
+    SHAMapItem::pointer peekPrevItem (uint256 const& ) const;
 
     void visitNodes (std::function<bool (SHAMapTreeNode&)> const&) const;
-    void visitLeaves(std::function<void (std::shared_ptr<SHAMapItem> const&)> const&) const;
+    void visitLeaves(std::function<void (SHAMapItem::pointer const&)> const&) const;
 
     // comparison/sync functions
     void getMissingNodes (std::vector<SHAMapNodeID>& nodeIDs, std::vector<uint256>& hashes, int max,
@@ -154,11 +154,13 @@ public:
     
     bool getRootNode (Serializer & s, SHANodeFormat format) const;
     std::vector<uint256> getNeededHashes (int max, SHAMapSyncFilter * filter);
-    SHAMapAddNode addRootNode (uint256 const& hash, Blob const& rootNode, SHANodeFormat format,
+
+    // Raw node data is parsed in place, it need only outlive the call
+    SHAMapAddNode addRootNode (uint256 const& hash, Slice const& rootNode, SHANodeFormat format,
                                SHAMapSyncFilter * filter);
-    SHAMapAddNode addRootNode (Blob const& rootNode, SHANodeFormat format,
+    SHAMapAddNode addRootNode (Slice const& rootNode, SHANodeFormat format,
                                SHAMapSyncFilter * filter);
-    SHAMapAddNode addKnownNode (SHAMapNodeID const& nodeID, Blob const& rawNode,
+    SHAMapAddNode addKnownNode (SHAMapNodeID const& nodeID, Slice const& rawNode,
                                 SHAMapSyncFilter * filter);
 
     // status functions
@@ -175,6 +177,25 @@ public:
 
     int flushDirty (NodeObjectType t, std::uint32_t seq);
     void walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissing) const;
+
+    /** Runs `f (i)` for each `i` in [0, n), possibly concurrently. */
+    using ForEach = std::function <void (std::size_t n,
+        std::function <void (std::size_t)> f)>;
+
+    /** Walk the map like walkMap, splitting the work across subtrees.
+
+        The top levels are walked on the calling thread and the subtrees
+        below them are handed to `forEach`, which may walk them at once.
+        The children of each inner node are prefetched from the node store
+        before they are needed. The walk ends early when `maxMissing`
+        nodes have been found or when `stop`, which must be thread safe,
+        returns `true`.
+
+        @return `false` if the walk was stopped before it finished.
+    */
+    bool walkMap (std::vector<SHAMapMissingNode>& missingNodes,
+        int maxMissing, ForEach const& forEach,
+            std::function <bool ()> const& stop) const;
     bool deepCompare (SHAMap & other) const;
 
     typedef std::pair <uint256, Blob> fetchPackEntry_t;
@@ -191,8 +212,8 @@ public:
 private:
     using SharedPtrNodeStack =
         std::stack<std::pair<std::shared_ptr<SHAMapTreeNode>, SHAMapNodeID>>;
-    using DeltaRef = std::pair<std::shared_ptr<SHAMapItem> const&,
-                               std::shared_ptr<SHAMapItem> const&> ;
+    using DeltaRef = std::pair<SHAMapItem::pointer const&,
+                               SHAMapItem::pointer const&> ;
 
     int unshare ();
 
@@ -250,18 +271,21 @@ private:
         descend (SHAMapTreeNode* parent, SHAMapNodeID const& parentID,
         int branch, SHAMapSyncFilter* filter) const;
 
+    // Queue reads for the children of an inner node that are not in memory
+    void prefetchChildren (SHAMapTreeNode& node) const;
+
     // Non-storing
     // Does not hook the returned node to its parent
     std::shared_ptr<SHAMapTreeNode> descendNoStore (std::shared_ptr<SHAMapTreeNode> const&, int branch) const;
 
     /** If there is only one leaf below this node, get its contents */
-    std::shared_ptr<SHAMapItem> onlyBelow (SHAMapTreeNode*) const;
+    SHAMapItem::pointer onlyBelow (SHAMapTreeNode*) const;
 
     bool hasInnerNode (SHAMapNodeID const& nodeID, uint256 const& hash) const;
     bool hasLeafNode (uint256 const& tag, uint256 const& hash) const;
 
     bool walkBranch (SHAMapTreeNode* node,
-                     std::shared_ptr<SHAMapItem> const& otherMapItem, bool isFirstMap,
+                     SHAMapItem::pointer const& otherMapItem, bool isFirstMap,
                      Delta & differences, int & maxCount) const;
     int walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq);
 };
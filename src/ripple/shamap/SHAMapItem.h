@@ -17,63 +17,75 @@
 */
 //==============================================================================
 
+
 #ifndef RIPPLE_SHAMAP_SHAMAPITEM_H_INCLUDED
 #define RIPPLE_SHAMAP_SHAMAPITEM_H_INCLUDED
 
-#include <ripple/protocol/Serializer.h>
 #include <ripple/basics/base_uint.h>
+#include <ripple/basics/Blob.h>
+#include <ripple/basics/Slice.h>
+#include <beast/smart_ptr/SharedObject.h>
+#include <beast/smart_ptr/SharedPtr.h>
 #include <beast/utility/Journal.h>
 
 #include <cstddef>
+#include <cstdint>
 
 namespace ripple {
 
-// an item stored in a SHAMap
-class SHAMapItem
-{
-private:
-    uint256 mTag;
-    Serializer mData;
+class Serializer;
+
+/** An item stored in a SHAMap.
 
+    The tag, the reference count and the payload share one allocation:
+    the payload bytes follow the object directly in memory. Items are
+    immutable once created and may only be obtained through
+    make_shamapitem, which carves them from size-class slabs.
+*/
+class SHAMapItem : public beast::SharedObject
+{
 public:
-    explicit SHAMapItem (uint256 const& tag);
-    SHAMapItem (uint256 const& tag, Blob const & data);
-    SHAMapItem (uint256 const& tag, Serializer const& s);
+    using pointer = beast::SharedPtr <SHAMapItem>;
+
+    SHAMapItem (SHAMapItem const&) = delete;
+    SHAMapItem& operator= (SHAMapItem const&) = delete;
 
     uint256 const& getTag() const;
-    Blob const& peekData() const;
-    Serializer& peekSerializer();
 
-public:  // public only to SHAMapTreeNode
+    /** Return a pointer to the first byte of the payload. */
+    std::uint8_t const* data() const;
+
+    /** Return the number of bytes in the payload. */
     std::size_t size() const;
 
-private:
-    explicit SHAMapItem (Blob const& data);
+    /** Return a view of the payload, which must not be empty. */
+    Slice slice() const;
 
-    void const* data() const;
     void addRaw (Blob& s) const;
-    void dump (beast::Journal journal);
+    void dump (beast::Journal journal) const;
+
+private:
+    SHAMapItem (uint256 const& tag, std::size_t size);
+
+    void destroy () const override;
+
+    friend
+    pointer
+    make_shamapitem (uint256 const& tag, void const* data, std::size_t size);
+
+    uint256 mTag;
+    std::uint32_t mSize;
 };
 
-inline
-SHAMapItem::SHAMapItem (uint256 const& tag)
-    : mTag (tag)
-{
-}
+/** Create an item holding a copy of the given payload. */
+SHAMapItem::pointer
+make_shamapitem (uint256 const& tag, void const* data, std::size_t size);
 
-inline
-std::size_t
-SHAMapItem::size() const
-{
-    return mData.peekData().size();
-}
+SHAMapItem::pointer
+make_shamapitem (uint256 const& tag, Blob const& data);
 
-inline
-void const*
-SHAMapItem::data() const
-{
-    return mData.peekData().data();
-}
+SHAMapItem::pointer
+make_shamapitem (uint256 const& tag, Serializer const& s);
 
 inline
 uint256 const&
@@ -83,24 +95,31 @@ SHAMapItem::getTag() const
 }
 
 inline
-Blob const&
-SHAMapItem::peekData() const
+std::uint8_t const*
+SHAMapItem::data() const
+{
+    return reinterpret_cast <std::uint8_t const*> (this + 1);
+}
+
+inline
+std::size_t
+SHAMapItem::size() const
 {
-    return mData.peekData();
+    return mSize;
 }
 
 inline
-Serializer& 
-SHAMapItem::peekSerializer()
+Slice
+SHAMapItem::slice() const
 {
-    return mData;
+    return Slice (data (), size ());
 }
 
 inline
 void
 SHAMapItem::addRaw (Blob& s) const
 {
-    s.insert (s.end (), mData.begin (), mData.end ());
+    s.insert (s.end (), data (), data () + size ());
 }
 
 } // ripple
@@ -0,0 +1,71 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_SHAMAP_SHAMAPNODEBATCH_H_INCLUDED
+#define RIPPLE_SHAMAP_SHAMAPNODEBATCH_H_INCLUDED
+
+#include <ripple/shamap/SHAMapNodeID.h>
+#include <ripple/basics/Blob.h>
+#include <ripple/basics/Slice.h>
+#include <vector>
+
+namespace ripple {
+
+/** Compact encoding of a batch of SHAMap nodes for peers.
+
+    Ledger data replies to peers which negotiated compact ledger data
+    carry their nodes as one batch instead of one protocol message per
+    node. The batch starts with a format byte:
+
+        0   The records follow
+        1   A varint holding the size of the records, then the records
+            compressed with LZ4
+
+    Each record is one node:
+
+        1 byte      depth of the node
+        n bytes     the first (depth + 1) / 2 bytes of the node ID
+        varint      size of the node data
+        n bytes     the node in wire format
+
+    Inner nodes with empty branches are sent as a branch mask followed
+    by the hashes of the branches which are present, using the wire
+    type snfWIRE nodes reserve for it.
+*/
+
+/** Pack nodes in wire format, as returned by getNodeFat, into a batch. */
+Blob
+packNodes (std::vector<SHAMapNodeID> const& nodeIDs,
+    std::vector<Blob> const& rawNodes);
+
+/** Unpack a batch.
+
+    The node data refers to packed, or to buffer if the batch was
+    compressed, so both must outlive it.
+
+    @return false if the batch is malformed.
+*/
+bool
+unpackNodes (Slice const& packed, Blob& buffer,
+    std::vector<SHAMapNodeID>& nodeIDs, std::vector<Slice>& rawNodes);
+
+} // ripple
+
+#endif
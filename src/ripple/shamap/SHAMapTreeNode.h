@@ -22,6 +22,7 @@
 
 #include <ripple/shamap/SHAMapItem.h>
 #include <ripple/shamap/SHAMapNodeID.h>
+#include <ripple/basics/Slice.h>
 #include <ripple/basics/TaggedCache.h>
 #include <beast/utility/Journal.h>
 
@@ -55,7 +56,7 @@ private:
     uint256                         mHash;
     uint256                         mHashes[16];
     std::shared_ptr<SHAMapTreeNode> mChildren[16];
-    std::shared_ptr<SHAMapItem>     mItem;
+    SHAMapItem::pointer     mItem;
     std::uint32_t                   mSeq;
     TNType                          mType;
     int                             mIsBranch;
@@ -69,8 +70,8 @@ public:
 
     SHAMapTreeNode (std::uint32_t seq); // empty node
     SHAMapTreeNode (const SHAMapTreeNode & node, std::uint32_t seq); // copy node from older tree
-    SHAMapTreeNode (std::shared_ptr<SHAMapItem> const& item, TNType type, std::uint32_t seq);
-    SHAMapTreeNode (Blob const & data, std::uint32_t seq,
+    SHAMapTreeNode (SHAMapItem::pointer const& item, TNType type, std::uint32_t seq);
+    SHAMapTreeNode (Slice const& data, std::uint32_t seq,
                     SHANodeFormat format, uint256 const& hash, bool hashValid);
 
     void addRaw (Serializer&, SHANodeFormat format);
@@ -101,8 +102,8 @@ public:  // public only to SHAMap
 
     // item node function
     bool hasItem () const;
-    std::shared_ptr<SHAMapItem> const& peekItem () const;
-    bool setItem (std::shared_ptr<SHAMapItem> const& i, TNType type);
+    SHAMapItem::pointer const& peekItem () const;
+    bool setItem (SHAMapItem::pointer const& i, TNType type);
 
     // sync functions
     bool isFullBelow (std::uint32_t generation) const;
@@ -235,7 +236,7 @@ SHAMapTreeNode::hasItem () const
 }
 
 inline
-std::shared_ptr<SHAMapItem> const&
+SHAMapItem::pointer const&
 SHAMapTreeNode::peekItem () const
 {
     return mItem;
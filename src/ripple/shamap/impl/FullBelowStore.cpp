@@ -0,0 +1,289 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/shamap/FullBelowStore.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace ripple {
+
+// Identifies the file format, stored in record zero
+static char const fullBelowMagic[] = "rippled full below roots v1";
+
+FullBelowStore::FullBelowStore (beast::Journal journal,
+        std::size_t maxRecords)
+    : j_ (journal)
+    , maxRecords_ (std::max <std::size_t> (maxRecords, 2))
+{
+}
+
+FullBelowStore::~FullBelowStore ()
+{
+    close ();
+}
+
+bool
+FullBelowStore::open (std::string const& path)
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+
+    assert (! file_.is_open ());
+
+    try
+    {
+        char header [uint256::bytes] = {};
+        std::memcpy (header, fullBelowMagic, sizeof (fullBelowMagic));
+
+        if (file_.create (beast::nudb::file_mode::write, path))
+        {
+            file_.write (0, header, sizeof (header));
+            j_.info << "Created full below record " << path;
+            return true;
+        }
+
+        if (! file_.open (beast::nudb::file_mode::write, path))
+            return false;
+
+        char existing [uint256::bytes] = {};
+        if (file_.actual_size () >= sizeof (existing))
+            file_.read (0, existing, sizeof (existing));
+
+        if (std::memcmp (existing, header, sizeof (header)) != 0)
+        {
+            j_.warning << "Full below record " << path <<
+                " has an unknown format, discarding";
+            file_.trunc (0);
+            file_.write (0, header, sizeof (header));
+            return true;
+        }
+
+        return load ();
+    }
+    catch (beast::nudb::file_error const& e)
+    {
+        j_.error << "Unable to open full below record " << path <<
+            ": " << e.what ();
+        if (file_.is_open ())
+            file_.close ();
+        known_.clear ();
+        records_ = 0;
+        return false;
+    }
+}
+
+void
+FullBelowStore::close ()
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+
+    // Unwritten roots are dropped rather than flushed, the node store
+    // may not have committed their nodes yet.
+    pending_.clear ();
+
+    try
+    {
+        if (file_.is_open ())
+            file_.close ();
+    }
+    catch (beast::nudb::file_error const& e)
+    {
+        j_.warning << "Error closing full below record: " << e.what ();
+    }
+}
+
+bool
+FullBelowStore::isOpen () const
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+    return file_.is_open ();
+}
+
+// Called with the lock held
+bool
+FullBelowStore::load ()
+{
+    // A partial record left by a crash is ignored and later overwritten
+    std::size_t const count =
+        file_.actual_size () / uint256::bytes;
+    records_ = (count > 0) ? (count - 1) : 0;
+
+    if (records_ == 0)
+        return true;
+
+    std::vector <uint256> hashes (records_);
+    file_.read (offset (1), hashes[0].begin (),
+        records_ * uint256::bytes);
+
+    known_.reserve (records_);
+    for (auto const& hash : hashes)
+    {
+        if (hash.isNonZero ())
+            known_.insert (hash);
+    }
+
+    j_.info << "Full below record has " << known_.size () << " roots";
+    return true;
+}
+
+// Called with the lock held
+void
+FullBelowStore::write (std::vector <uint256> const& hashes)
+{
+    if (hashes.empty ())
+        return;
+
+    file_.write (offset (records_ + 1), hashes[0].begin (),
+        hashes.size () * uint256::bytes);
+    records_ += hashes.size ();
+}
+
+// Called with the lock held
+void
+FullBelowStore::compact ()
+{
+    std::size_t const keep = maxRecords_ / 2;
+
+    std::vector <uint256> hashes (std::min (keep, records_));
+    if (! hashes.empty ())
+        file_.read (offset (records_ + 1 - hashes.size ()),
+            hashes[0].begin (), hashes.size () * uint256::bytes);
+
+    file_.trunc (offset (1));
+    records_ = 0;
+    write (hashes);
+
+    known_.clear ();
+    known_.insert (hashes.begin (), hashes.end ());
+
+    j_.debug << "Full below record compacted to " << known_.size () <<
+        " roots";
+}
+
+bool
+FullBelowStore::contains (uint256 const& hash) const
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+    return known_.count (hash) != 0;
+}
+
+void
+FullBelowStore::insert (uint256 const& hash)
+{
+    if (hash.isZero ())
+        return;
+
+    std::lock_guard <std::mutex> sl (mutex_);
+
+    if (! file_.is_open ())
+        return;
+
+    if (known_.insert (hash).second)
+        pending_.push_back (hash);
+}
+
+void
+FullBelowStore::clear ()
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+
+    known_.clear ();
+    pending_.clear ();
+
+    if (! file_.is_open ())
+        return;
+
+    try
+    {
+        file_.trunc (offset (1));
+        records_ = 0;
+    }
+    catch (beast::nudb::file_error const& e)
+    {
+        // Never leave stale roots behind that could be loaded again
+        j_.error << "Unable to clear full below record: " << e.what ();
+        file_.close ();
+    }
+}
+
+void
+FullBelowStore::sweep ()
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+
+    if (! file_.is_open () || pending_.empty ())
+        return;
+
+    try
+    {
+        if (records_ + pending_.size () > maxRecords_)
+        {
+            // Roots not yet written out are still in known_ and must
+            // survive the compaction, so write them out afterwards.
+            compact ();
+            known_.insert (pending_.begin (), pending_.end ());
+        }
+
+        write (pending_);
+    }
+    catch (beast::nudb::file_error const& e)
+    {
+        j_.warning << "Unable to write full below record: " << e.what ();
+    }
+
+    pending_.clear ();
+}
+
+std::size_t
+FullBelowStore::size () const
+{
+    std::lock_guard <std::mutex> sl (mutex_);
+    return known_.size ();
+}
+
+std::vector <uint256>
+FullBelowStore::getRoots () const
+{
+    std::vector <uint256> hashes;
+
+    std::lock_guard <std::mutex> sl (mutex_);
+
+    if (! file_.is_open () || records_ == 0)
+        return hashes;
+
+    try
+    {
+        hashes.resize (records_);
+        file_.read (offset (1), hashes[0].begin (),
+            records_ * uint256::bytes);
+    }
+    catch (beast::nudb::file_error const& e)
+    {
+        j_.warning << "Unable to read full below record: " << e.what ();
+        hashes.clear ();
+    }
+
+    hashes.erase (std::remove_if (hashes.begin (), hashes.end (),
+        [](uint256 const& h) { return h.isZero (); }), hashes.end ());
+    hashes.insert (hashes.end (), pending_.begin (), pending_.end ());
+    return hashes;
+}
+
+} // ripple
@@ -174,13 +174,13 @@ SHAMap::fetchNodeFromDB (uint256 const& hash) const
 
     if (backed_)
     {
-        NodeObject::pointer obj = f_.db().fetch (hash);
+        NodeObject::pointer obj = f_.db().fetch (hash, ledgerSeq_);
         if (obj)
         {
             try
             {
-                node = std::make_shared <SHAMapTreeNode> (obj->getData(),
-                    0, snfPREFIX, hash, true);
+                node = std::make_shared <SHAMapTreeNode> (
+                    makeSlice (obj->getData()), 0, snfPREFIX, hash, true);
                 canonicalize (hash, node);
             }
             catch (...)
@@ -212,7 +212,7 @@ std::shared_ptr<SHAMapTreeNode> SHAMap::checkFilter (
     if (filter->haveNode (id, hash, nodeData))
     {
         node = std::make_shared <SHAMapTreeNode> (
-            nodeData, 0, snfPREFIX, hash, true);
+            makeSlice (nodeData), 0, snfPREFIX, hash, true);
 
        filter->gotNode (true, id, hash, nodeData, node->getType ());
 
@@ -386,7 +386,8 @@ SHAMapTreeNode* SHAMap::descendAsync (SHAMapTreeNode* parent, int branch,
             if (!obj)
                 return nullptr;
 
-            ptr = std::make_shared <SHAMapTreeNode> (obj->getData(), 0, snfPREFIX, hash, true);
+            ptr = std::make_shared <SHAMapTreeNode> (
+                makeSlice (obj->getData()), 0, snfPREFIX, hash, true);
 
             if (backed_)
                 canonicalize (hash, ptr);
@@ -472,7 +473,7 @@ SHAMap::lastBelow (SHAMapTreeNode* node) const
     while (true);
 }
 
-std::shared_ptr<SHAMapItem>
+SHAMapItem::pointer
 SHAMap::onlyBelow (SHAMapTreeNode* node) const
 {
     // If there is only one item below this node, return it
@@ -485,7 +486,7 @@ SHAMap::onlyBelow (SHAMapTreeNode* node) const
             if (!node->isEmptyBranch (i))
             {
                 if (nextNode)
-                    return std::shared_ptr<SHAMapItem> ();
+                    return SHAMapItem::pointer ();
 
                 nextNode = descendThrow (node, i);
             }
@@ -494,7 +495,7 @@ SHAMap::onlyBelow (SHAMapTreeNode* node) const
         if (!nextNode)
         {
             assert (false);
-            return std::shared_ptr<SHAMapItem> ();
+            return SHAMapItem::pointer ();
         }
 
         node = nextNode;
@@ -507,9 +508,9 @@ SHAMap::onlyBelow (SHAMapTreeNode* node) const
     return node->peekItem ();
 }
 
-static const std::shared_ptr<SHAMapItem> no_item;
+static const SHAMapItem::pointer no_item;
 
-std::shared_ptr<SHAMapItem> SHAMap::peekFirstItem () const
+SHAMapItem::pointer SHAMap::peekFirstItem () const
 {
     SHAMapTreeNode* node = firstBelow (root_.get ());
 
@@ -519,7 +520,7 @@ std::shared_ptr<SHAMapItem> SHAMap::peekFirstItem () const
     return node->peekItem ();
 }
 
-std::shared_ptr<SHAMapItem> SHAMap::peekFirstItem (SHAMapTreeNode::TNType& type) const
+SHAMapItem::pointer SHAMap::peekFirstItem (SHAMapTreeNode::TNType& type) const
 {
     SHAMapTreeNode* node = firstBelow (root_.get ());
 
@@ -530,7 +531,7 @@ std::shared_ptr<SHAMapItem> SHAMap::peekFirstItem (SHAMapTreeNode::TNType& type)
     return node->peekItem ();
 }
 
-std::shared_ptr<SHAMapItem> SHAMap::peekLastItem () const
+SHAMapItem::pointer SHAMap::peekLastItem () const
 {
     SHAMapTreeNode* node = lastBelow (root_.get ());
 
@@ -540,13 +541,13 @@ std::shared_ptr<SHAMapItem> SHAMap::peekLastItem () const
     return node->peekItem ();
 }
 
-std::shared_ptr<SHAMapItem> SHAMap::peekNextItem (uint256 const& id) const
+SHAMapItem::pointer SHAMap::peekNextItem (uint256 const& id) const
 {
     SHAMapTreeNode::TNType type;
     return peekNextItem (id, type);
 }
 
-std::shared_ptr<SHAMapItem> SHAMap::peekNextItem (uint256 const& id, SHAMapTreeNode::TNType& type) const
+SHAMapItem::pointer SHAMap::peekNextItem (uint256 const& id, SHAMapTreeNode::TNType& type) const
 {
     // Get a pointer to the next item in the tree after a given item - item need not be in tree
 
@@ -589,7 +590,7 @@ std::shared_ptr<SHAMapItem> SHAMap::peekNextItem (uint256 const& id, SHAMapTreeN
 }
 
 // Get a pointer to the previous item in the tree after a given item - item need not be in tree
-std::shared_ptr<SHAMapItem> SHAMap::peekPrevItem (uint256 const& id) const
+SHAMapItem::pointer SHAMap::peekPrevItem (uint256 const& id) const
 {
     auto stack = getStack (id, true);
 
@@ -622,7 +623,7 @@ std::shared_ptr<SHAMapItem> SHAMap::peekPrevItem (uint256 const& id) const
     return no_item;
 }
 
-std::shared_ptr<SHAMapItem> SHAMap::peekItem (uint256 const& id) const
+SHAMapItem::pointer SHAMap::peekItem (uint256 const& id) const
 {
     SHAMapTreeNode* leaf = walkToPointer (id);
 
@@ -632,7 +633,7 @@ std::shared_ptr<SHAMapItem> SHAMap::peekItem (uint256 const& id) const
     return leaf->peekItem ();
 }
 
-std::shared_ptr<SHAMapItem> SHAMap::peekItem (uint256 const& id, SHAMapTreeNode::TNType& type) const
+SHAMapItem::pointer SHAMap::peekItem (uint256 const& id, SHAMapTreeNode::TNType& type) const
 {
     SHAMapTreeNode* leaf = walkToPointer (id);
 
@@ -643,7 +644,7 @@ std::shared_ptr<SHAMapItem> SHAMap::peekItem (uint256 const& id, SHAMapTreeNode:
     return leaf->peekItem ();
 }
 
-std::shared_ptr<SHAMapItem> SHAMap::peekItem (uint256 const& id, uint256& hash) const
+SHAMapItem::pointer SHAMap::peekItem (uint256 const& id, uint256& hash) const
 {
     SHAMapTreeNode* leaf = walkToPointer (id);
 
@@ -711,7 +712,7 @@ bool SHAMap::delItem (uint256 const& id)
             else if (bc == 1)
             {
                 // If there's only one item, pull up on the thread
-                std::shared_ptr<SHAMapItem> item = onlyBelow (node.get ());
+                SHAMapItem::pointer item = onlyBelow (node.get ());
 
                 if (item)
                 {
@@ -742,7 +743,7 @@ bool SHAMap::delItem (uint256 const& id)
 }
 
 bool
-SHAMap::addGiveItem (std::shared_ptr<SHAMapItem> const& item,
+SHAMap::addGiveItem (SHAMapItem::pointer const& item,
                      bool isTransaction, bool hasMeta)
 {
     // add the specified item, does not update
@@ -776,7 +777,7 @@ SHAMap::addGiveItem (std::shared_ptr<SHAMapItem> const& item,
     else
     {
         // this is a leaf node that has to be made an inner node holding two items
-        std::shared_ptr<SHAMapItem> otherItem = node->peekItem ();
+        SHAMapItem::pointer otherItem = node->peekItem ();
         assert (otherItem && (tag != otherItem->getTag ()));
 
         node->makeInner ();
@@ -813,7 +814,8 @@ SHAMap::addGiveItem (std::shared_ptr<SHAMapItem> const& item,
 
 bool SHAMap::addItem (const SHAMapItem& i, bool isTransaction, bool hasMetaData)
 {
-    return addGiveItem (std::make_shared<SHAMapItem> (i), isTransaction, hasMetaData);
+    return addGiveItem (make_shamapitem (i.getTag (), i.data (), i.size ()),
+        isTransaction, hasMetaData);
 }
 
 uint256
@@ -829,7 +831,7 @@ SHAMap::getHash () const
 }
 
 bool
-SHAMap::updateGiveItem (std::shared_ptr<SHAMapItem> const& item,
+SHAMap::updateGiveItem (SHAMapItem::pointer const& item,
                         bool isTransaction, bool hasMeta)
 {
     // can't change the tag but can change the hash
@@ -924,7 +926,7 @@ void SHAMap::writeNode (
     Serializer s;
     node->addRaw (s, snfPREFIX);
     f_.db().store (t,
-        std::move (s.modData ()), node->getNodeHash ());
+        std::move (s.modData ()), node->getNodeHash (), ledgerSeq_);
 }
 
 // We can't modify an inner node someone else might have a
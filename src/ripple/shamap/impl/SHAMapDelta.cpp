@@ -19,6 +19,8 @@
 
 #include <BeastConfig.h>
 #include <ripple/shamap/SHAMap.h>
+#include <atomic>
+#include <mutex>
     
 namespace ripple {
 
@@ -31,7 +33,7 @@ namespace ripple {
 // synchronizing matching branches too.)
 
 bool SHAMap::walkBranch (SHAMapTreeNode* node,
-                         std::shared_ptr<SHAMapItem> const& otherMapItem, bool isFirstMap,
+                         SHAMapItem::pointer const& otherMapItem, bool isFirstMap,
                          Delta& differences, int& maxCount) const
 {
     // Walk a branch of a SHAMap that's matched by an empty branch or single item in the other map
@@ -55,22 +57,22 @@ bool SHAMap::walkBranch (SHAMapTreeNode* node,
         else
         {
             // This is a leaf node, process its item
-            std::shared_ptr<SHAMapItem> item = node->peekItem ();
+            SHAMapItem::pointer item = node->peekItem ();
 
             if (emptyBranch || (item->getTag () != otherMapItem->getTag ()))
             {
                 // unmatched
                 if (isFirstMap)
                     differences.insert (std::make_pair (item->getTag (),
-                                      DeltaRef (item, std::shared_ptr<SHAMapItem> ())));
+                                      DeltaRef (item, SHAMapItem::pointer ())));
                 else
                     differences.insert (std::make_pair (item->getTag (),
-                                      DeltaRef (std::shared_ptr<SHAMapItem> (), item)));
+                                      DeltaRef (SHAMapItem::pointer (), item)));
 
                 if (--maxCount <= 0)
                     return false;
             }
-            else if (item->peekData () != otherMapItem->peekData ())
+            else if (item->slice () != otherMapItem->slice ())
             {
                 // non-matching items with same tag
                 if (isFirstMap)
@@ -98,12 +100,12 @@ bool SHAMap::walkBranch (SHAMapTreeNode* node,
         // otherMapItem was unmatched, must add
         if (isFirstMap) // this is first map, so other item is from second
             differences.insert (std::make_pair (otherMapItem->getTag (),
-                                                DeltaRef (std::shared_ptr<SHAMapItem>(),
+                                                DeltaRef (SHAMapItem::pointer (),
                                                           otherMapItem)));
         else
             differences.insert (std::make_pair (otherMapItem->getTag (),
                                                 DeltaRef (otherMapItem,
-                                                      std::shared_ptr<SHAMapItem> ())));
+                                                      SHAMapItem::pointer ())));
 
         if (--maxCount <= 0)
             return false;
@@ -147,7 +149,7 @@ SHAMap::compare (std::shared_ptr<SHAMap> const& otherMap,
             // two leaves
             if (ourNode->peekItem()->getTag () == otherNode->peekItem()->getTag ())
             {
-                if (ourNode->peekItem()->peekData () != otherNode->peekItem()->peekData ())
+                if (ourNode->peekItem()->slice () != otherNode->peekItem()->slice ())
                 {
                     differences.insert (std::make_pair (ourNode->peekItem()->getTag (),
                                                  DeltaRef (ourNode->peekItem (),
@@ -160,12 +162,12 @@ SHAMap::compare (std::shared_ptr<SHAMap> const& otherMap,
             {
                 differences.insert (std::make_pair(ourNode->peekItem()->getTag (),
                                                    DeltaRef(ourNode->peekItem(),
-                                                   std::shared_ptr<SHAMapItem> ())));
+                                                   SHAMapItem::pointer ())));
                 if (--maxCount <= 0)
                     return false;
 
                 differences.insert(std::make_pair(otherNode->peekItem()->getTag (),
-                                                  DeltaRef(std::shared_ptr<SHAMapItem>(),
+                                                  DeltaRef(SHAMapItem::pointer (),
                                                   otherNode->peekItem ())));
                 if (--maxCount <= 0)
                     return false;
@@ -193,7 +195,7 @@ SHAMap::compare (std::shared_ptr<SHAMap> const& otherMap,
                         // We have a branch, the other tree does not
                         SHAMapTreeNode* iNode = descendThrow (ourNode, i);
                         if (!walkBranch (iNode,
-                                         std::shared_ptr<SHAMapItem> (), true,
+                                         SHAMapItem::pointer (), true,
                                          differences, maxCount))
                             return false;
                     }
@@ -203,7 +205,7 @@ SHAMap::compare (std::shared_ptr<SHAMap> const& otherMap,
                         SHAMapTreeNode* iNode =
                             otherMap->descendThrow(otherNode, i);
                         if (!otherMap->walkBranch (iNode,
-                                                   std::shared_ptr<SHAMapItem>(),
+                                                   SHAMapItem::pointer (),
                                                    false, differences, maxCount))
                             return false;
                     }
@@ -256,4 +258,136 @@ void SHAMap::walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissi
     }
 }
 
+void SHAMap::prefetchChildren (SHAMapTreeNode& node) const
+{
+    if (!backed_)
+        return;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        if (!node.isEmptyBranch (i) && !node.getChildPointer (i))
+        {
+            uint256 const& hash = node.getChildHash (i);
+            if (!getCache (hash))
+            {
+                NodeObject::pointer obj;
+                f_.db().asyncFetch (hash, obj);
+            }
+        }
+    }
+}
+
+bool SHAMap::walkMap (std::vector<SHAMapMissingNode>& missingNodes,
+    int maxMissing, ForEach const& forEach,
+        std::function <bool ()> const& stop) const
+{
+    // Levels walked on the calling thread, this leaves up to 256 subtrees
+    int const splitDepth = 2;
+
+    if (!root_->isInner () || maxMissing <= 0)
+        return true;
+
+    std::mutex mutex;
+    std::atomic <bool> done (false);
+    std::atomic <bool> stopped (false);
+
+    // Return false once enough missing nodes were found
+    auto const missing = [&](uint256 const& hash)
+    {
+        std::lock_guard <std::mutex> sl (mutex);
+        if (maxMissing <= 0)
+            return false;
+        missingNodes.emplace_back (type_, hash);
+        if (--maxMissing > 0)
+            return true;
+        done = true;
+        return false;
+    };
+
+    // Unlike descendNoStore, a missing child is not an error here
+    auto const child = [this](std::shared_ptr<SHAMapTreeNode> const& node,
+        int branch)
+    {
+        std::shared_ptr<SHAMapTreeNode> ret = node->getChild (branch);
+        if (!ret && backed_)
+            ret = fetchNodeNT (node->getChildHash (branch));
+        return ret;
+    };
+
+    std::vector <std::shared_ptr<SHAMapTreeNode>> subtrees (1, root_);
+    prefetchChildren (*root_);
+
+    for (int depth = 0; depth < splitDepth; ++depth)
+    {
+        std::vector <std::shared_ptr<SHAMapTreeNode>> next;
+
+        for (auto const& node : subtrees)
+        {
+            for (int i = 0; i < 16; ++i)
+            {
+                if (node->isEmptyBranch (i))
+                    continue;
+
+                std::shared_ptr<SHAMapTreeNode> nextNode = child (node, i);
+
+                if (!nextNode)
+                {
+                    if (!missing (node->getChildHash (i)))
+                        return true;
+                }
+                else if (nextNode->isInner ())
+                {
+                    prefetchChildren (*nextNode);
+                    next.push_back (std::move (nextNode));
+                }
+            }
+        }
+
+        subtrees.swap (next);
+    }
+
+    forEach (subtrees.size (), [&](std::size_t index)
+    {
+        std::stack <std::shared_ptr<SHAMapTreeNode>,
+            std::vector <std::shared_ptr<SHAMapTreeNode>>> nodeStack;
+
+        nodeStack.push (subtrees[index]);
+
+        while (!nodeStack.empty () && !done)
+        {
+            if (stop && stop ())
+            {
+                stopped = true;
+                done = true;
+                return;
+            }
+
+            std::shared_ptr<SHAMapTreeNode> node = std::move (nodeStack.top());
+            nodeStack.pop ();
+
+            for (int i = 0; i < 16; ++i)
+            {
+                if (node->isEmptyBranch (i))
+                    continue;
+
+                std::shared_ptr<SHAMapTreeNode> nextNode = child (node, i);
+
+                if (!nextNode)
+                {
+                    if (!missing (node->getChildHash (i)))
+                        return;
+                }
+                else if (nextNode->isInner ())
+                {
+                    // Read the next level while this one is checked
+                    prefetchChildren (*nextNode);
+                    nodeStack.push (std::move (nextNode));
+                }
+            }
+        }
+    });
+
+    return !stopped;
+}
+
 } // ripple
@@ -17,30 +17,110 @@
 */
 //==============================================================================
 
+
 #include <BeastConfig.h>
 #include <ripple/shamap/SHAMapItem.h>
-    
+#include <ripple/basics/SlabAllocator.h>
+#include <ripple/protocol/Serializer.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <new>
+
 namespace ripple {
 
-class SHAMap;
+namespace {
 
-SHAMapItem::SHAMapItem (uint256 const& tag, Blob const& data)
-    : mTag (tag)
-    , mData (data)
+// Total block sizes, header included. Most ledger entries and
+// transactions fit in one of these; anything larger goes to the heap.
+std::array <std::size_t, 8> const itemClasses =
+    {{ 128, 192, 256, 320, 384, 512, 768, 1024 }};
+
+// Approximate number of bytes in each slab
+std::size_t const itemSlabBytes = 256 * 1024;
+
+class ItemSlabs
 {
+public:
+    ItemSlabs ()
+    {
+        for (std::size_t i = 0; i < itemClasses.size (); ++i)
+            slabs_[i].reset (new SlabAllocator (
+                itemClasses[i], itemSlabBytes / itemClasses[i]));
+    }
+
+    // Returns nullptr if the block is too large for any class
+    SlabAllocator* find (std::size_t bytes)
+    {
+        auto const iter = std::lower_bound (
+            itemClasses.begin (), itemClasses.end (), bytes);
+        if (iter == itemClasses.end ())
+            return nullptr;
+        return slabs_[iter - itemClasses.begin ()].get ();
+    }
+
+private:
+    std::array <std::unique_ptr <SlabAllocator>, itemClasses.size ()> slabs_;
+};
+
+// Intentionally never destroyed, since items may outlive static objects.
+ItemSlabs& itemSlabs ()
+{
+    static ItemSlabs* const slabs = new ItemSlabs;
+    return *slabs;
+}
+
 }
 
-SHAMapItem::SHAMapItem (uint256 const& tag, const Serializer& data)
+SHAMapItem::SHAMapItem (uint256 const& tag, std::size_t size)
     : mTag (tag)
-    , mData (data.peekData ())
+    , mSize (static_cast <std::uint32_t> (size))
+{
+}
+
+void SHAMapItem::destroy () const
+{
+    std::size_t const bytes = sizeof (SHAMapItem) + mSize;
+    void* const p = const_cast <SHAMapItem*> (this);
+    this->~SHAMapItem ();
+
+    if (SlabAllocator* const slab = itemSlabs ().find (bytes))
+        slab->deallocate (p);
+    else
+        ::operator delete (p);
+}
+
+SHAMapItem::pointer
+make_shamapitem (uint256 const& tag, void const* data, std::size_t size)
+{
+    std::size_t const bytes = sizeof (SHAMapItem) + size;
+    SlabAllocator* const slab = itemSlabs ().find (bytes);
+    void* const p = slab ? slab->allocate () : ::operator new (bytes);
+
+    SHAMapItem* const item = new (p) SHAMapItem (tag, size);
+    if (size != 0)
+        std::memcpy (item + 1, data, size);
+    return item;
+}
+
+SHAMapItem::pointer
+make_shamapitem (uint256 const& tag, Blob const& data)
+{
+    return make_shamapitem (tag, data.data (), data.size ());
+}
+
+SHAMapItem::pointer
+make_shamapitem (uint256 const& tag, Serializer const& s)
 {
+    return make_shamapitem (tag, s.peekData ());
 }
 
 // VFALCO This function appears not to be called
-void SHAMapItem::dump (beast::Journal journal)
+void SHAMapItem::dump (beast::Journal journal) const
 {
     if (journal.info) journal.info <<
-        "SHAMapItem(" << mTag << ") " << mData.size () << "bytes";
+        "SHAMapItem(" << mTag << ") " << mSize << "bytes";
 }
 
 } // ripple
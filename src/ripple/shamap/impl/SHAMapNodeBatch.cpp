@@ -0,0 +1,251 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/shamap/SHAMapNodeBatch.h>
+#include <beast/nudb/detail/varint.h>
+#include <lz4/lib/lz4.h>
+#include <array>
+#include <cassert>
+#include <cstring>
+
+namespace ripple {
+
+// The wire type of an inner node sent as a branch mask and the hashes
+// of the branches which are present. Only batches carry it.
+static int const wireMaskedInner = 5;
+
+// Batches this large are not accepted from peers
+static std::size_t const maxBatchSize = 32 * 1024 * 1024;
+
+// Hashes do not compress, so only batches that are mostly leaf data
+// are worth running through LZ4
+static std::size_t const minCompressSize = 256;
+
+// Rewrite an inner node in wire format with a branch mask,
+// if that makes it smaller. Returns false to send it as is.
+static
+bool
+maskInner (Blob const& raw, Blob& out)
+{
+    if (raw.empty ())
+        return false;
+
+    std::array <uint256, 16> hashes;
+    int const type = raw.back ();
+    int const len = raw.size () - 1;
+
+    if (type == 2)
+    {
+        // full inner
+        if (len != 512)
+            return false;
+
+        for (int i = 0; i < 16; ++i)
+            hashes[i] = uint256::fromVoid (raw.data () + (i * 32));
+    }
+    else if (type == 3)
+    {
+        // compressed inner
+        for (int i = 0; i < (len / 33); ++i)
+        {
+            int const pos = raw[32 + (i * 33)];
+
+            if (pos >= 16)
+                return false;
+
+            hashes[pos] = uint256::fromVoid (raw.data () + (i * 33));
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    std::uint16_t mask = 0;
+    int count = 0;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        if (hashes[i].isNonZero ())
+        {
+            mask |= (0x8000 >> i);
+            ++count;
+        }
+    }
+
+    if ((2 + (count * 32) + 1) >= raw.size ())
+        return false;
+
+    out.clear ();
+    out.reserve (2 + (count * 32) + 1);
+    out.push_back (static_cast<unsigned char> (mask >> 8));
+    out.push_back (static_cast<unsigned char> (mask & 0xff));
+
+    for (int i = 0; i < 16; ++i)
+    {
+        if (mask & (0x8000 >> i))
+            out.insert (out.end (), hashes[i].begin (), hashes[i].end ());
+    }
+
+    out.push_back (wireMaskedInner);
+    return true;
+}
+
+static
+void
+addVarint (Blob& out, std::size_t v)
+{
+    using namespace beast::nudb::detail;
+    auto const offset = out.size ();
+    out.resize (offset + size_varint (v));
+    write_varint (out.data () + offset, v);
+}
+
+Blob
+packNodes (std::vector<SHAMapNodeID> const& nodeIDs,
+    std::vector<Blob> const& rawNodes)
+{
+    assert (nodeIDs.size () == rawNodes.size ());
+
+    Blob records;
+    Blob masked;
+    std::size_t leafBytes = 0;
+
+    for (std::size_t i = 0; i < nodeIDs.size (); ++i)
+    {
+        int const depth = nodeIDs[i].getDepth ();
+        uint256 const& id = nodeIDs[i].getNodeID ();
+        records.push_back (static_cast<unsigned char> (depth));
+        records.insert (records.end (), id.begin (),
+            id.begin () + ((depth + 1) / 2));
+
+        Blob const* raw = &rawNodes[i];
+
+        if (maskInner (*raw, masked))
+            raw = &masked;
+        else if (!raw->empty () && (raw->back () != 2) &&
+                (raw->back () != 3))
+            leafBytes += raw->size ();
+
+        addVarint (records, raw->size ());
+        records.insert (records.end (), raw->begin (), raw->end ());
+    }
+
+    Blob packed;
+
+    if ((records.size () >= minCompressSize) &&
+        (leafBytes >= (records.size () / 2)))
+    {
+        packed.push_back (1);
+        addVarint (packed, records.size ());
+
+        auto const offset = packed.size ();
+        packed.resize (offset + LZ4_compressBound (records.size ()));
+
+        int const size = LZ4_compress (
+            reinterpret_cast<char const*> (records.data ()),
+            reinterpret_cast<char*> (packed.data () + offset),
+            records.size ());
+
+        if ((size > 0) && ((offset + size) < (records.size () + 1)))
+        {
+            packed.resize (offset + size);
+            return packed;
+        }
+
+        packed.clear ();
+    }
+
+    packed.reserve (records.size () + 1);
+    packed.push_back (0);
+    packed.insert (packed.end (), records.begin (), records.end ());
+    return packed;
+}
+
+bool
+unpackNodes (Slice const& packed, Blob& buffer,
+    std::vector<SHAMapNodeID>& nodeIDs, std::vector<Slice>& rawNodes)
+{
+    using namespace beast::nudb::detail;
+
+    std::uint8_t const* p = packed.data () + 1;
+    std::size_t remain = packed.size () - 1;
+
+    if (packed.data ()[0] == 1)
+    {
+        std::size_t size;
+        auto const used = read_varint (p, remain, size);
+
+        if ((used == 0) || (size == 0) || (size > maxBatchSize))
+            return false;
+
+        buffer.resize (size);
+
+        if (LZ4_decompress_safe (
+                reinterpret_cast<char const*> (p + used),
+                reinterpret_cast<char*> (buffer.data ()),
+                remain - used, size) != static_cast<int> (size))
+            return false;
+
+        p = buffer.data ();
+        remain = buffer.size ();
+    }
+    else if (packed.data ()[0] != 0)
+    {
+        return false;
+    }
+
+    while (remain != 0)
+    {
+        // Rebuild the node ID in the form SHAMapNodeID reads
+        std::array <std::uint8_t, 33> rawID {};
+        int const depth = *p;
+        int const pathSize = (depth + 1) / 2;
+
+        if ((depth > 64) || (remain < (1 + pathSize)))
+            return false;
+
+        std::memcpy (rawID.data (), p + 1, pathSize);
+        rawID[32] = depth;
+
+        // An odd depth leaves the low nibble of the last byte unused
+        if ((depth & 1) && (rawID[pathSize - 1] & 0x0f))
+            return false;
+
+        p += 1 + pathSize;
+        remain -= 1 + pathSize;
+
+        std::size_t size;
+        auto const used = read_varint (p, remain, size);
+
+        if ((used == 0) || (size == 0) || (size > (remain - used)))
+            return false;
+
+        nodeIDs.emplace_back (rawID.data (), rawID.size ());
+        rawNodes.emplace_back (p + used, size);
+        p += used + size;
+        remain -= used + size;
+    }
+
+    return true;
+}
+
+} // ripple
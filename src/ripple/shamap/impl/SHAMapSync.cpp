@@ -29,7 +29,7 @@ namespace ripple {
 static const uint256 uZero;
 
 static bool visitLeavesHelper (
-    std::function <void (std::shared_ptr<SHAMapItem> const&)> const& function,
+    std::function <void (SHAMapItem::pointer const&)> const& function,
     SHAMapTreeNode& node)
 {
     // Adapt visitNodes to visitLeaves
@@ -39,7 +39,7 @@ static bool visitLeavesHelper (
     return false;
 }
 
-void SHAMap::visitLeaves (std::function<void (std::shared_ptr<SHAMapItem> const& item)> const& leafFunction) const
+void SHAMap::visitLeaves (std::function<void (SHAMapItem::pointer const& item)> const& leafFunction) const
 {
     visitNodes (std::bind (visitLeavesHelper,
             std::cref (leafFunction), std::placeholders::_1));
@@ -125,6 +125,15 @@ void SHAMap::getMissingNodes (std::vector<SHAMapNodeID>& nodeIDs, std::vector<ui
         return;
     }
 
+    // The tree may have been proven complete before a restart
+    if (backed_ && f_.fullbelowstore().contains (root_->getNodeHash ()))
+    {
+        root_->setFullBelowGen (generation);
+        f_.fullbelow().insert (root_->getNodeHash ());
+        clearSynching ();
+        return;
+    }
+
     if (!root_->isInner ())
     {
         if (journal_.warning) journal_.warning <<
@@ -287,7 +296,14 @@ void SHAMap::getMissingNodes (std::vector<SHAMapNodeID>& nodeIDs, std::vector<ui
     }
 
     if (nodeIDs.empty ())
+    {
+        // Only remember the tree if the cache was not cleared meanwhile
+        if (backed_ && root_->isFullBelow (generation) &&
+                (generation == f_.fullbelow().getGeneration()))
+            f_.fullbelowstore().insert (root_->getNodeHash ());
+
         clearSynching ();
+    }
 }
 
 std::vector<uint256> SHAMap::getNeededHashes (int max, SHAMapSyncFilter* filter)
@@ -398,7 +414,7 @@ bool SHAMap::getRootNode (Serializer& s, SHANodeFormat format) const
     return true;
 }
 
-SHAMapAddNode SHAMap::addRootNode (Blob const& rootNode,
+SHAMapAddNode SHAMap::addRootNode (Slice const& rootNode,
     SHANodeFormat format, SHAMapSyncFilter* filter)
 {
     // we already have a root_ node
@@ -439,7 +455,7 @@ SHAMapAddNode SHAMap::addRootNode (Blob const& rootNode,
     return SHAMapAddNode::useful ();
 }
 
-SHAMapAddNode SHAMap::addRootNode (uint256 const& hash, Blob const& rootNode, SHANodeFormat format,
+SHAMapAddNode SHAMap::addRootNode (uint256 const& hash, Slice const& rootNode, SHANodeFormat format,
                                    SHAMapSyncFilter* filter)
 {
     // we already have a root_ node
@@ -479,7 +495,7 @@ SHAMapAddNode SHAMap::addRootNode (uint256 const& hash, Blob const& rootNode, SH
 }
 
 SHAMapAddNode
-SHAMap::addKnownNode (const SHAMapNodeID& node, Blob const& rawNode,
+SHAMap::addKnownNode (const SHAMapNodeID& node, Slice const& rawNode,
                       SHAMapSyncFilter* filter)
 {
     // return value: true=okay, false=error
@@ -604,7 +620,7 @@ bool SHAMap::deepCompare (SHAMap& other) const
             auto otherNodePeek = otherNode->peekItem();
             if (nodePeek->getTag() != otherNodePeek->getTag())
                 return false;
-            if (nodePeek->peekData() != otherNodePeek->peekData())
+            if (nodePeek->slice() != otherNodePeek->slice())
                 return false;
         }
         else if (node->isInner ())
@@ -57,7 +57,7 @@ SHAMapTreeNode::SHAMapTreeNode (const SHAMapTreeNode& node, std::uint32_t seq)
     }
 }
 
-SHAMapTreeNode::SHAMapTreeNode (std::shared_ptr<SHAMapItem> const& item,
+SHAMapTreeNode::SHAMapTreeNode (SHAMapItem::pointer const& item,
                                 TNType type, std::uint32_t seq)
     : mItem (item)
     , mSeq (seq)
@@ -65,11 +65,11 @@ SHAMapTreeNode::SHAMapTreeNode (std::shared_ptr<SHAMapItem> const& item,
     , mIsBranch (0)
     , mFullBelowGen (0)
 {
-    assert (item->peekData ().size () >= 12);
+    assert (item->size () >= 12);
     updateHash ();
 }
 
-SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
+SHAMapTreeNode::SHAMapTreeNode (Slice const& rawNode,
                                 std::uint32_t seq, SHANodeFormat format,
                                 uint256 const& hash, bool hashValid)
     : mSeq (seq)
@@ -77,27 +77,20 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
     , mIsBranch (0)
     , mFullBelowGen (0)
 {
+    // The node is parsed in place, only the item payload is copied
     if (format == snfWIRE)
     {
-        if (rawNode.empty ())
-        {
-#ifdef BEAST_DEBUG
-            deprecatedLogs().journal("SHAMapTreeNode").fatal <<
-                "Wire format node is empty";
-            assert (false);
-#endif
-            throw std::runtime_error ("invalid node AW type");
-        }
-
-        Serializer s (rawNode.begin (), rawNode.end () - 1);
-        int type = rawNode.back ();
-        int len = s.getLength ();
+        // The last byte is the node type
+        std::uint8_t const* data = rawNode.data ();
+        int len = rawNode.size () - 1;
+        int type = data[len];
 
-        if ((type < 0) || (type > 4))
+        if (type > 5)
         {
 #ifdef BEAST_DEBUG
             deprecatedLogs().journal("SHAMapTreeNode").fatal <<
-                "Invalid wire format node" << strHex (rawNode);
+                "Invalid wire format node" <<
+                    strHex (rawNode.data (), rawNode.size ());
             assert (false);
 #endif
             throw std::runtime_error ("invalid node AW type");
@@ -106,7 +99,8 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
         if (type == 0)
         {
             // transaction
-            mItem = std::make_shared<SHAMapItem> (s.getPrefixHash (HashPrefix::transactionID), s.peekData ());
+            mItem = make_shamapitem (Serializer::getPrefixHash (
+                HashPrefix::transactionID, data, len), data, len);
             mType = tnTRANSACTION_NM;
         }
         else if (type == 1)
@@ -115,13 +109,12 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
             if (len < (256 / 8))
                 throw std::runtime_error ("short AS node");
 
-            uint256 u;
-            s.get256 (u, len - (256 / 8));
-            s.chop (256 / 8);
+            len -= (256 / 8);
+            uint256 u = uint256::fromVoid (data + len);
 
             if (u.isZero ()) throw std::runtime_error ("invalid AS node");
 
-            mItem = std::make_shared<SHAMapItem> (u, s.peekData ());
+            mItem = make_shamapitem (u, data, len);
             mType = tnACCOUNT_STATE;
         }
         else if (type == 2)
@@ -132,7 +125,7 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
 
             for (int i = 0; i < 16; ++i)
             {
-                s.get256 (mHashes[i], i * 32);
+                mHashes[i] = uint256::fromVoid (data + (i * 32));
 
                 if (mHashes[i].isNonZero ())
                     mIsBranch |= (1 << i);
@@ -145,12 +138,11 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
             // compressed inner
             for (int i = 0; i < (len / 33); ++i)
             {
-                int pos;
-                s.get8 (pos, 32 + (i * 33));
+                int pos = data[32 + (i * 33)];
 
-                if ((pos < 0) || (pos >= 16)) throw std::runtime_error ("invalid CI node");
+                if (pos >= 16) throw std::runtime_error ("invalid CI node");
 
-                s.get256 (mHashes[pos], i * 33);
+                mHashes[pos] = uint256::fromVoid (data + (i * 33));
 
                 if (mHashes[pos].isNonZero ())
                     mIsBranch |= (1 << pos);
@@ -164,16 +156,44 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
             if (len < (256 / 8))
                 throw std::runtime_error ("short TM node");
 
-            uint256 u;
-            s.get256 (u, len - (256 / 8));
-            s.chop (256 / 8);
+            len -= (256 / 8);
+            uint256 u = uint256::fromVoid (data + len);
 
             if (u.isZero ())
                 throw std::runtime_error ("invalid TM node");
 
-            mItem = std::make_shared<SHAMapItem> (u, s.peekData ());
+            mItem = make_shamapitem (u, data, len);
             mType = tnTRANSACTION_MD;
         }
+        else if (type == 5)
+        {
+            // inner with a branch mask, only found in node batches
+            if (len < 2)
+                throw std::runtime_error ("short MI node");
+
+            int const mask = (data[0] << 8) | data[1];
+            int pos = 2;
+
+            for (int i = 0; i < 16; ++i)
+            {
+                if ((mask & (0x8000 >> i)) == 0)
+                    continue;
+
+                if ((pos + 32) > len)
+                    throw std::runtime_error ("short MI node");
+
+                mHashes[i] = uint256::fromVoid (data + pos);
+                pos += 32;
+
+                if (mHashes[i].isNonZero ())
+                    mIsBranch |= (1 << i);
+            }
+
+            if (pos != len)
+                throw std::runtime_error ("invalid MI node");
+
+            mType = tnINNER;
+        }
     }
 
     else if (format == snfPREFIX)
@@ -184,28 +204,30 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
             throw std::runtime_error ("invalid P node");
         }
 
-        std::uint32_t prefix = rawNode[0];
+        std::uint8_t const* data = rawNode.data ();
+        std::uint32_t prefix = data[0];
         prefix <<= 8;
-        prefix |= rawNode[1];
+        prefix |= data[1];
         prefix <<= 8;
-        prefix |= rawNode[2];
+        prefix |= data[2];
         prefix <<= 8;
-        prefix |= rawNode[3];
-        Serializer s (rawNode.begin () + 4, rawNode.end ());
+        prefix |= data[3];
+        data += 4;
+        int len = rawNode.size () - 4;
 
         if (prefix == HashPrefix::transactionID)
         {
-            mItem = std::make_shared<SHAMapItem> (getSHA512Half (rawNode), s.peekData ());
+            mItem = make_shamapitem (getSHA512Half (
+                rawNode.data (), rawNode.size ()), data, len);
             mType = tnTRANSACTION_NM;
         }
         else if (prefix == HashPrefix::leafNode)
         {
-            if (s.getLength () < 32)
+            if (len < 32)
                 throw std::runtime_error ("short PLN node");
 
-            uint256 u;
-            s.get256 (u, s.getLength () - 32);
-            s.chop (32);
+            len -= 32;
+            uint256 u = uint256::fromVoid (data + len);
 
             if (u.isZero ())
             {
@@ -213,17 +235,17 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
                 throw std::runtime_error ("invalid PLN node");
             }
 
-            mItem = std::make_shared<SHAMapItem> (u, s.peekData ());
+            mItem = make_shamapitem (u, data, len);
             mType = tnACCOUNT_STATE;
         }
         else if (prefix == HashPrefix::innerNode)
         {
-            if (s.getLength () != 512)
+            if (len != 512)
                 throw std::runtime_error ("invalid PIN node");
 
             for (int i = 0; i < 16; ++i)
             {
-                s.get256 (mHashes[i], i * 32);
+                mHashes[i] = uint256::fromVoid (data + (i * 32));
 
                 if (mHashes[i].isNonZero ())
                     mIsBranch |= (1 << i);
@@ -234,13 +256,12 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
         else if (prefix == HashPrefix::txNode)
         {
             // transaction with metadata
-            if (s.getLength () < 32)
+            if (len < 32)
                 throw std::runtime_error ("short TXN node");
 
-            uint256 txID;
-            s.get256 (txID, s.getLength () - 32);
-            s.chop (32);
-            mItem = std::make_shared<SHAMapItem> (txID, s.peekData ());
+            len -= 32;
+            uint256 txID = uint256::fromVoid (data + len);
+            mItem = make_shamapitem (txID, data, len);
             mType = tnTRANSACTION_MD;
         }
         else
@@ -292,13 +313,13 @@ bool SHAMapTreeNode::updateHash ()
     }
     else if (mType == tnTRANSACTION_NM)
     {
-        nh = Serializer::getPrefixHash (HashPrefix::transactionID, mItem->peekData ());
+        nh = Serializer::getPrefixHash (HashPrefix::transactionID, mItem->data (), mItem->size ());
     }
     else if (mType == tnACCOUNT_STATE)
     {
         Serializer s (mItem->size() + (256 + 32) / 8);
         s.add32 (HashPrefix::leafNode);
-        s.addRaw (mItem->peekData ());
+        s.addRaw (mItem->data (), mItem->size ());
         s.add256 (mItem->getTag ());
         nh = s.getSHA512Half ();
     }
@@ -306,7 +327,7 @@ bool SHAMapTreeNode::updateHash ()
     {
         Serializer s (mItem->size() + (256 + 32) / 8);
         s.add32 (HashPrefix::txNode);
-        s.addRaw (mItem->peekData ());
+        s.addRaw (mItem->data (), mItem->size ());
         s.add256 (mItem->getTag ());
         nh = s.getSHA512Half ();
     }
@@ -381,12 +402,12 @@ void SHAMapTreeNode::addRaw (Serializer& s, SHANodeFormat format)
         if (format == snfPREFIX)
         {
             s.add32 (HashPrefix::leafNode);
-            s.addRaw (mItem->peekData ());
+            s.addRaw (mItem->data (), mItem->size ());
             s.add256 (mItem->getTag ());
         }
         else
         {
-            s.addRaw (mItem->peekData ());
+            s.addRaw (mItem->data (), mItem->size ());
             s.add256 (mItem->getTag ());
             s.add8 (1);
         }
@@ -396,11 +417,11 @@ void SHAMapTreeNode::addRaw (Serializer& s, SHANodeFormat format)
         if (format == snfPREFIX)
         {
             s.add32 (HashPrefix::transactionID);
-            s.addRaw (mItem->peekData ());
+            s.addRaw (mItem->data (), mItem->size ());
         }
         else
         {
-            s.addRaw (mItem->peekData ());
+            s.addRaw (mItem->data (), mItem->size ());
             s.add8 (0);
         }
     }
@@ -409,12 +430,12 @@ void SHAMapTreeNode::addRaw (Serializer& s, SHANodeFormat format)
         if (format == snfPREFIX)
         {
             s.add32 (HashPrefix::txNode);
-            s.addRaw (mItem->peekData ());
+            s.addRaw (mItem->data (), mItem->size ());
             s.add256 (mItem->getTag ());
         }
         else
         {
-            s.addRaw (mItem->peekData ());
+            s.addRaw (mItem->data (), mItem->size ());
             s.add256 (mItem->getTag ());
             s.add8 (4);
         }
@@ -423,7 +444,7 @@ void SHAMapTreeNode::addRaw (Serializer& s, SHANodeFormat format)
         assert (false);
 }
 
-bool SHAMapTreeNode::setItem (std::shared_ptr<SHAMapItem> const& i, TNType type)
+bool SHAMapTreeNode::setItem (SHAMapItem::pointer const& i, TNType type)
 {
     mType = type;
     mItem = i;
@@ -451,7 +472,7 @@ int SHAMapTreeNode::getBranchCount () const
 
 void SHAMapTreeNode::makeInner ()
 {
-    mItem.reset ();
+    mItem = nullptr;
     mIsBranch = 0;
     memset (mHashes, 0, sizeof (mHashes));
     mType = tnINNER;
@@ -82,13 +82,13 @@ public:
         beast::Journal mJournal;
     };
 
-    std::shared_ptr <Item>
+    Item::pointer
     make_random_item (beast::Random& r)
     {
         Serializer s;
         for (int d = 0; d < 3; ++d)
             s.add32 (r.nextInt ());
-        return std::make_shared <Item> (
+        return make_shamapitem (
             to256(s.getRIPEMD160()), s.peekData ());
     }
 
@@ -97,7 +97,7 @@ public:
     {
         while (n--)
         {
-            std::shared_ptr <SHAMapItem> item (
+            SHAMapItem::pointer item (
                 make_random_item (r));
             auto const result (t.addItem (*item, false, false));
             assert (result);
@@ -0,0 +1,203 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/shamap/FullBelowStore.h>
+#include <ripple/shamap/SHAMap.h>
+#include <ripple/shamap/tests/common.h>
+#include <beast/module/core/diagnostic/UnitTestUtilities.h>
+#include <beast/unit_test/suite.h>
+#include <boost/filesystem.hpp>
+#include <cstring>
+
+namespace ripple {
+namespace shamap {
+namespace tests {
+
+class FullBelowStore_test : public beast::unit_test::suite
+{
+    static uint256 makeHash (std::uint32_t n)
+    {
+        uint256 hash;
+        hash.begin ()[0] = 0xA5;
+        std::memcpy (hash.begin () + 1, &n, sizeof (n));
+        return hash;
+    }
+
+    static std::string makePath (
+        beast::UnitTestUtilities::TempDirectory const& dir)
+    {
+        boost::filesystem::path const dirPath (
+            dir.getFullPathName ().toStdString ());
+        boost::filesystem::create_directories (dirPath);
+        return (dirPath / "full_below.idx").string ();
+    }
+
+public:
+    void testRecord ()
+    {
+        testcase ("record");
+
+        beast::UnitTestUtilities::TempDirectory dir ("full_below");
+        std::string const path = makePath (dir);
+        beast::Journal j;
+
+        {
+            FullBelowStore store (j);
+            store.insert (makeHash (0));
+            expect (! store.contains (makeHash (0)), "Closed store");
+
+            expect (store.open (path), "Should create");
+            for (std::uint32_t i = 0; i < 10; ++i)
+                store.insert (makeHash (i));
+            store.sweep ();
+
+            // Not written out, so forgotten on close
+            store.insert (makeHash (10));
+            expect (store.contains (makeHash (10)));
+            expect (store.size () == 11);
+        }
+
+        {
+            FullBelowStore store (j);
+            expect (store.open (path), "Should reopen");
+            expect (store.size () == 10);
+            expect (store.contains (makeHash (9)));
+            expect (! store.contains (makeHash (10)));
+
+            auto const roots = store.getRoots ();
+            expect (roots.size () == 10);
+            expect (! roots.empty () && roots.front () == makeHash (0));
+
+            // Rotation forgets everything, also on disk
+            store.clear ();
+            expect (store.size () == 0);
+            expect (! store.contains (makeHash (0)));
+            store.insert (makeHash (20));
+            store.sweep ();
+        }
+
+        {
+            FullBelowStore store (j);
+            expect (store.open (path), "Should reopen");
+            expect (store.size () == 1);
+            expect (store.contains (makeHash (20)));
+        }
+    }
+
+    void testCompact ()
+    {
+        testcase ("compact");
+
+        beast::UnitTestUtilities::TempDirectory dir ("full_below");
+        std::string const path = makePath (dir);
+        beast::Journal j;
+
+        {
+            FullBelowStore store (j, 8);
+            expect (store.open (path), "Should create");
+            for (std::uint32_t i = 0; i < 20; ++i)
+            {
+                store.insert (makeHash (i));
+                store.sweep ();
+            }
+            expect (store.size () <= 8, std::to_string (store.size ()));
+            expect (store.contains (makeHash (19)));
+            expect (! store.contains (makeHash (0)));
+        }
+
+        {
+            FullBelowStore store (j, 8);
+            expect (store.open (path), "Should reopen");
+            expect (store.size () <= 8, std::to_string (store.size ()));
+            expect (store.contains (makeHash (19)));
+            expect (store.contains (makeHash (18)));
+        }
+    }
+
+    void testSync ()
+    {
+        testcase ("sync");
+
+        beast::UnitTestUtilities::TempDirectory dir ("full_below");
+        std::string const path = makePath (dir);
+        beast::Journal const j;
+
+        TestFamily f (j);
+        expect (f.fullbelowstore ().open (path), "Should create");
+
+        SHAMap source (SHAMapType::FREE, f, j);
+        for (std::uint32_t i = 1; i <= 100; ++i)
+        {
+            Serializer s;
+            s.add32 (i);
+            s.add64 (i);
+            source.addItem (*make_shamapitem (s.getSHA512Half (),
+                s.peekData ()), false, false);
+        }
+        source.flushDirty (hotACCOUNT_NODE, 1);
+        uint256 const root = source.getHash ();
+        expect (! f.fullbelowstore ().contains (root));
+
+        {
+            SHAMap map (SHAMapType::FREE, root, f, j);
+            expect (map.fetchRoot (root, nullptr), "Should fetch root");
+
+            std::vector <SHAMapNodeID> nodeIDs;
+            std::vector <uint256> hashes;
+            map.getMissingNodes (nodeIDs, hashes, 256, nullptr);
+            expect (nodeIDs.empty ());
+            expect (f.fullbelowstore ().contains (root),
+                "Complete tree should be recorded");
+        }
+
+        f.fullbelowstore ().sweep ();
+        f.fullbelowstore ().close ();
+
+        {
+            // A restart forgets the cache but not the record
+            f.fullbelow ().clear ();
+            expect (f.fullbelowstore ().open (path), "Should reopen");
+            expect (f.fullbelowstore ().contains (root));
+
+            SHAMap map (SHAMapType::FREE, root, f, j);
+            expect (map.fetchRoot (root, nullptr), "Should fetch root");
+
+            std::vector <SHAMapNodeID> nodeIDs;
+            std::vector <uint256> hashes;
+            map.getMissingNodes (nodeIDs, hashes, 256, nullptr);
+            expect (nodeIDs.empty ());
+            expect (! map.isSynching ());
+            expect (f.fullbelow ().touch_if_exists (root));
+        }
+    }
+
+    void run ()
+    {
+        testRecord ();
+        testCompact ();
+        testSync ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(FullBelowStore,shamap,ripple);
+
+} // tests
+} // shamap
+} // ripple
@@ -64,26 +64,30 @@ public:
         h5.SetHex ("a92891fe4ef6cee585fdc6fda0e09eb4d386363158ec3321b8123e5a772c6ca7");
 
         SHAMap sMap (SHAMapType::FREE, f, beast::Journal());
-        SHAMapItem i1 (h1, IntToVUC (1)), i2 (h2, IntToVUC (2)), i3 (h3, IntToVUC (3)), i4 (h4, IntToVUC (4)), i5 (h5, IntToVUC (5));
-        unexpected (!sMap.addItem (i2, true, false), "no add");
-        unexpected (!sMap.addItem (i1, true, false), "no add");
-
-        std::shared_ptr<SHAMapItem> i;
+        auto i1 = make_shamapitem (h1, IntToVUC (1));
+        auto i2 = make_shamapitem (h2, IntToVUC (2));
+        auto i3 = make_shamapitem (h3, IntToVUC (3));
+        auto i4 = make_shamapitem (h4, IntToVUC (4));
+        auto i5 = make_shamapitem (h5, IntToVUC (5));
+        unexpected (!sMap.addItem (*i2, true, false), "no add");
+        unexpected (!sMap.addItem (*i1, true, false), "no add");
+
+        SHAMapItem::pointer i;
         i = sMap.peekFirstItem ();
-        unexpected (!i || (*i != i1), "bad traverse");
+        unexpected (!i || (*i != *i1), "bad traverse");
         i = sMap.peekNextItem (i->getTag ());
-        unexpected (!i || (*i != i2), "bad traverse");
+        unexpected (!i || (*i != *i2), "bad traverse");
         i = sMap.peekNextItem (i->getTag ());
         unexpected (i, "bad traverse");
-        sMap.addItem (i4, true, false);
-        sMap.delItem (i2.getTag ());
-        sMap.addItem (i3, true, false);
+        sMap.addItem (*i4, true, false);
+        sMap.delItem (i2->getTag ());
+        sMap.addItem (*i3, true, false);
         i = sMap.peekFirstItem ();
-        unexpected (!i || (*i != i1), "bad traverse");
+        unexpected (!i || (*i != *i1), "bad traverse");
         i = sMap.peekNextItem (i->getTag ());
-        unexpected (!i || (*i != i3), "bad traverse");
+        unexpected (!i || (*i != *i3), "bad traverse");
         i = sMap.peekNextItem (i->getTag ());
-        unexpected (!i || (*i != i4), "bad traverse");
+        unexpected (!i || (*i != *i4), "bad traverse");
         i = sMap.peekNextItem (i->getTag ());
         unexpected (i, "bad traverse");
 
@@ -0,0 +1,206 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/shamap/SHAMap.h>
+#include <ripple/shamap/SHAMapNodeBatch.h>
+#include <ripple/shamap/tests/common.h>
+#include <beast/unit_test/suite.h>
+#include <beast/random/xor_shift_engine.h>
+
+namespace ripple {
+namespace shamap {
+namespace tests {
+
+class SHAMapNodeBatch_test : public beast::unit_test::suite
+{
+public:
+    // Leaves look like ledger entries: mostly fixed fields
+    // with a few that vary.
+    static
+    SHAMapItem::pointer
+    makeItem (beast::xor_shift_engine& gen, bool compressible)
+    {
+        Serializer s;
+        for (int i = 0; i < 4; ++i)
+            s.add64 (gen ());
+        for (int i = 0; i < 12; ++i)
+            s.add64 (compressible ? 0x1100220033004400ULL : gen ());
+        return make_shamapitem (s.getSHA512Half (), s.peekData ());
+    }
+
+    // Sync a copy of the source map using only node batches.
+    // Returns the number of batches that were compressed.
+    int
+    syncByBatch (SHAMap& source, SHAMap& destination,
+        std::size_t& packedBytes, std::size_t& plainBytes)
+    {
+        int compressed = 0;
+        packedBytes = 0;
+        plainBytes = 0;
+
+        std::vector<SHAMapNodeID> nodeIDs;
+        std::vector<Blob> rawNodes;
+        expect (source.getNodeFat (SHAMapNodeID (), nodeIDs, rawNodes,
+            false, 0));
+        expect (destination.addRootNode (
+            makeSlice (rawNodes.front ()), snfWIRE, nullptr).isGood ());
+
+        for (int passes = 0; passes < 100; ++passes)
+        {
+            std::vector<SHAMapNodeID> missing;
+            std::vector<uint256> hashes;
+            destination.getMissingNodes (missing, hashes, 256, nullptr);
+            if (missing.empty ())
+                break;
+
+            nodeIDs.clear ();
+            rawNodes.clear ();
+            for (auto const& id : missing)
+                expect (source.getNodeFat (id, nodeIDs, rawNodes, true, 2));
+
+            for (auto const& raw : rawNodes)
+                plainBytes += 33 + raw.size ();
+
+            Blob const packed = packNodes (nodeIDs, rawNodes);
+            packedBytes += packed.size ();
+            if (packed.front () == 1)
+                ++compressed;
+
+            std::vector<SHAMapNodeID> gotIDs;
+            std::vector<Slice> gotNodes;
+            Blob buffer;
+            if (! expect (unpackNodes (makeSlice (packed), buffer,
+                    gotIDs, gotNodes), "unpack"))
+                return compressed;
+            expect (gotIDs == nodeIDs, "node IDs");
+
+            for (std::size_t i = 0; i < gotIDs.size (); ++i)
+            {
+                auto const result = destination.addKnownNode (
+                    gotIDs[i], gotNodes[i], nullptr);
+                expect (result.isGood (), "addKnownNode");
+            }
+        }
+
+        return compressed;
+    }
+
+    void
+    testSync (bool compressible)
+    {
+        testcase (compressible ? "sync compressible" : "sync random");
+
+        beast::Journal const j;
+        beast::xor_shift_engine gen;
+        TestFamily f (j);
+        SHAMap source (SHAMapType::FREE, f, j);
+        SHAMap destination (SHAMapType::FREE, f, j);
+
+        for (int i = 0; i < 5000; ++i)
+            source.addItem (*makeItem (gen, compressible), false, false);
+        source.setImmutable ();
+        destination.setSynching ();
+
+        std::size_t packedBytes;
+        std::size_t plainBytes;
+        int const compressed = syncByBatch (
+            source, destination, packedBytes, plainBytes);
+
+        destination.clearSynching ();
+        expect (destination.getHash () == source.getHash (), "hash");
+        expect (packedBytes < plainBytes, "smaller");
+        if (compressible)
+            expect (compressed > 0, "compressed");
+        log << (compressible ? "compressible" : "random") <<
+            ": " << plainBytes << " bytes as nodes, " <<
+            packedBytes << " bytes as batches";
+    }
+
+    void
+    testMalformed ()
+    {
+        testcase ("malformed");
+
+        beast::xor_shift_engine gen;
+        TestFamily f (beast::Journal {});
+        SHAMap map (SHAMapType::FREE, f, beast::Journal {});
+        for (int i = 0; i < 64; ++i)
+            map.addItem (*makeItem (gen, true), false, false);
+
+        std::vector<SHAMapNodeID> nodeIDs;
+        std::vector<Blob> rawNodes;
+        expect (map.getNodeFat (SHAMapNodeID (), nodeIDs, rawNodes, true, 2));
+        Blob const packed = packNodes (nodeIDs, rawNodes);
+
+        auto const unpacks = [](Blob const& b)
+        {
+            std::vector<SHAMapNodeID> ids;
+            std::vector<Slice> nodes;
+            Blob buffer;
+            return unpackNodes (makeSlice (b), buffer, ids, nodes);
+        };
+
+        expect (unpacks (packed));
+
+        // Every truncation is either rejected or yields fewer nodes
+        for (std::size_t size = 1; size < packed.size (); ++size)
+        {
+            Blob const b (packed.begin (), packed.begin () + size);
+            std::vector<SHAMapNodeID> ids;
+            std::vector<Slice> nodes;
+            Blob buffer;
+            if (unpackNodes (makeSlice (b), buffer, ids, nodes))
+                expect (ids.size () < nodeIDs.size ());
+        }
+
+        Blob b (packed);
+        b[0] = 2;
+        expect (! unpacks (b), "format");
+
+        // Depth too deep
+        b = Blob {0, 65};
+        expect (! unpacks (b), "depth");
+
+        // Odd depth with the unused nibble set, then one byte of data
+        b = Blob {0, 1, 0x1f, 1, 0};
+        expect (! unpacks (b), "nibble");
+        b = Blob {0, 1, 0x10, 1, 0};
+        expect (unpacks (b), "nibble clear");
+
+        // Data running past the end
+        b = Blob {0, 0, 5, 0};
+        expect (! unpacks (b), "size");
+    }
+
+    void
+    run ()
+    {
+        testSync (true);
+        testSync (false);
+        testMalformed ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SHAMapNodeBatch,shamap,ripple);
+
+} // tests
+} // shamap
+} // ripple
@@ -37,13 +37,13 @@ namespace tests {
 class sync_test : public beast::unit_test::suite
 {
 public:
-    static std::shared_ptr<SHAMapItem> makeRandomAS ()
+    static SHAMapItem::pointer makeRandomAS ()
     {
         Serializer s;
 
         for (int d = 0; d < 3; ++d) s.add32 (rand ());
 
-        return std::make_shared<SHAMapItem> (to256 (s.getRIPEMD160 ()), s.peekData ());
+        return make_shamapitem (to256 (s.getRIPEMD160 ()), s.peekData ());
     }
 
     bool confuseMap (SHAMap& map, int count)
@@ -56,7 +56,7 @@ public:
 
         for (int i = 0; i < count; ++i)
         {
-            std::shared_ptr<SHAMapItem> item = makeRandomAS ();
+            SHAMapItem::pointer item = makeRandomAS ();
             items.push_back (item->getTag ());
 
             if (!map.addItem (*item, false, false))
@@ -130,7 +130,7 @@ public:
 
         unexpected (gotNodes.size () < 1, "NodeSize");
 
-        unexpected (!destination.addRootNode (*gotNodes.begin (), snfWIRE, nullptr).isGood(), "AddRootNode");
+        unexpected (!destination.addRootNode (makeSlice (*gotNodes.begin ()), snfWIRE, nullptr).isGood(), "AddRootNode");
 
         nodeIDs.clear ();
         gotNodes.clear ();
@@ -185,7 +185,7 @@ public:
                 bytes += rawNodeIterator->size ();
 #endif
 
-                if (!destination.addKnownNode (*nodeIDIterator, *rawNodeIterator, nullptr).isGood ())
+                if (!destination.addKnownNode (*nodeIDIterator, makeSlice (*rawNodeIterator), nullptr).isGood ())
                 {
                     fail ("AddKnownNode");
                 }
@@ -0,0 +1,439 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/shamap/SHAMap.h>
+#include <ripple/shamap/tests/common.h>
+#include <ripple/basics/BasicConfig.h>
+#include <ripple/json/json_value.h>
+#include <ripple/json/to_string.h>
+#include <beast/module/core/diagnostic/UnitTestUtilities.h>
+#include <beast/random/xor_shift_engine.h>
+#include <beast/unit_test/suite.h>
+#include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined(BEAST_LINUX) || defined(BEAST_MAC) || defined(BEAST_BSD)
+#include <sys/resource.h>
+#endif
+
+namespace ripple {
+namespace shamap {
+namespace tests {
+
+/** Measures SHAMap operations on generated maps.
+
+    The argument is a list of configurations separated by ';', each a list
+    of key=value pairs separated by ',':
+
+        items       Number of items in the map
+        keys        "random", "sequential" or "clustered"
+        size        Bytes of payload per item
+        type        Node store backend, followed by any of its own options
+
+    One line of JSON is printed for each configuration.
+*/
+class SHAMapTiming_test : public beast::unit_test::suite
+{
+public:
+#ifndef NDEBUG
+    std::size_t const default_items = 10000;
+#else
+    std::size_t const default_items = 100000; // release
+#endif
+
+    using clock_type = std::chrono::steady_clock;
+
+    enum class Keys
+    {
+        random,
+        sequential,
+
+        // Runs of keys sharing all but their last bytes, the way
+        // the entries of a directory do
+        clustered
+    };
+
+    // Produces the n-th key and payload deterministically
+    class Sequence
+    {
+    private:
+        enum
+        {
+            clusterSize = 64
+        };
+
+        beast::xor_shift_engine gen_;
+        Keys keys_;
+        std::size_t size_;
+
+        void
+        fill (std::uint8_t* buffer, std::size_t bytes)
+        {
+            while (bytes > 0)
+            {
+                auto const v = gen_();
+                auto const n = std::min (bytes, sizeof (v));
+                std::memcpy (buffer, &v, n);
+                buffer += n;
+                bytes -= n;
+            }
+        }
+
+    public:
+        Sequence (Keys keys, std::size_t size)
+            : keys_ (keys)
+            , size_ (size)
+        {
+        }
+
+        uint256
+        key (std::size_t n)
+        {
+            uint256 result;
+            auto const data = &*result.begin ();
+
+            switch (keys_)
+            {
+            case Keys::random:
+                gen_.seed (n + 1);
+                fill (data, result.size ());
+                break;
+
+            case Keys::sequential:
+                // Start at one, since a zero key is not a valid item
+                result.zero ();
+                for (std::size_t i = 0; i < sizeof (n); ++i)
+                    data[result.size () - 1 - i] =
+                        static_cast <std::uint8_t> ((n + 1) >> (8 * i));
+                break;
+
+            case Keys::clustered:
+                gen_.seed (n / clusterSize + 1);
+                fill (data, result.size () - 8);
+                gen_.seed (n + 1);
+                fill (data + result.size () - 8, 8);
+                break;
+            }
+
+            return result;
+        }
+
+        // Each version of an item has a different payload
+        SHAMapItem::pointer
+        item (std::size_t n, std::size_t version)
+        {
+            Blob data (size_);
+            gen_.seed ((n + 1) * 31 + version);
+            fill (data.data (), data.size ());
+            return make_shamapitem (key (n), data);
+        }
+    };
+
+    // Per operation latencies
+    class Latencies
+    {
+    private:
+        std::vector <clock_type::duration> samples_;
+        clock_type::duration total_ {};
+
+    public:
+        explicit
+        Latencies (std::size_t reserve)
+        {
+            samples_.reserve (reserve);
+        }
+
+        template <class Function>
+        void
+        time (Function&& f)
+        {
+            auto const start = clock_type::now ();
+            f ();
+            auto const elapsed = clock_type::now () - start;
+            samples_.push_back (elapsed);
+            total_ += elapsed;
+        }
+
+        Json::Value
+        getJson ()
+        {
+            using namespace std::chrono;
+
+            Json::Value ret (Json::objectValue);
+
+            if (samples_.empty ())
+                return ret;
+
+            std::sort (samples_.begin (), samples_.end ());
+            auto const percentile = [this](std::size_t p)
+            {
+                return static_cast <Json::UInt> (duration_cast <nanoseconds> (
+                    samples_[(samples_.size () - 1) * p / 100]).count ());
+            };
+
+            ret["ops"] = static_cast <Json::UInt> (samples_.size ());
+            ret["ops_per_sec"] = samples_.size () /
+                duration_cast <duration <double>> (total_).count ();
+            ret["p50_ns"] = percentile (50);
+            ret["p99_ns"] = percentile (99);
+            return ret;
+        }
+    };
+
+    template <class Function>
+    static
+    Json::UInt
+    elapsedMillis (Function&& f)
+    {
+        auto const start = clock_type::now ();
+        f ();
+        return static_cast <Json::UInt> (
+            std::chrono::duration_cast <std::chrono::milliseconds> (
+                clock_type::now () - start).count ());
+    }
+
+    static
+    Json::UInt
+    peakResidentKB ()
+    {
+    #if defined(BEAST_LINUX) || defined(BEAST_BSD)
+        struct rusage usage;
+        if (getrusage (RUSAGE_SELF, &usage) == 0)
+            return static_cast <Json::UInt> (usage.ru_maxrss);
+    #elif defined(BEAST_MAC)
+        // Reported in bytes rather than kilobytes
+        struct rusage usage;
+        if (getrusage (RUSAGE_SELF, &usage) == 0)
+            return static_cast <Json::UInt> (usage.ru_maxrss / 1024);
+    #endif
+        return 0;
+    }
+
+    static
+    Json::Value
+    getHitRate (TreeNodeCache& cache)
+    {
+        auto const counts = cache.getHitsAndMisses ();
+        Json::Value ret (Json::objectValue);
+        ret["hits"] = static_cast <Json::UInt> (counts.first);
+        ret["misses"] = static_cast <Json::UInt> (counts.second);
+        ret["hit_rate"] = cache.getHitRate ();
+        return ret;
+    }
+
+    static
+    Section
+    parse (std::string s)
+    {
+        Section section;
+        std::vector <std::string> v;
+        boost::split (v, s,
+            boost::algorithm::is_any_of (","));
+        section.append(v);
+        return section;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void
+    do_test (Section const& config, std::string const& config_string)
+    {
+        std::size_t const items = get <std::size_t> (
+            config, "items", default_items);
+        std::size_t const size = get <std::size_t> (config, "size", 100);
+        std::string const keyName = get <std::string> (
+            config, "keys", "random");
+
+        Keys keys;
+        if (keyName == "random")
+            keys = Keys::random;
+        else if (keyName == "sequential")
+            keys = Keys::sequential;
+        else if (keyName == "clustered")
+            keys = Keys::clustered;
+        else
+        {
+            fail ("Unknown key distribution: " + keyName);
+            return;
+        }
+
+        beast::Journal const j;
+        TestFamily f (config, j);
+        Sequence seq (keys, size);
+
+        Json::Value result (Json::objectValue);
+        result["config"] = config_string;
+
+        auto map = std::make_shared <SHAMap> (SHAMapType::STATE, f, j);
+
+        {
+            Latencies insert (items);
+            for (std::size_t i = 0; i < items; ++i)
+            {
+                auto const item = seq.item (i, 0);
+                insert.time ([&]{ map->addGiveItem (item, false, false); });
+            }
+            result["insert"] = insert.getJson ();
+        }
+
+        // Hashes are computed lazily, when first asked for
+        uint256 hash;
+        result["hash_ms"] = elapsedMillis ([&]{ hash = map->getHash (); });
+
+        {
+            std::map <std::string, std::size_t> types;
+            std::size_t nodes = 0;
+            map->visitNodes ([&](SHAMapTreeNode& node)
+            {
+                ++nodes;
+                ++types[node.isInner () ? "inner" : "leaf"];
+                return false;
+            });
+
+            Json::Value& counts = (result["nodes"] = Json::objectValue);
+            for (auto const& type : types)
+                counts[type.first] = static_cast <Json::UInt> (type.second);
+
+            // Items carry their payloads inline, and are counted with
+            // the leaves which hold them
+            if (nodes != 0)
+                result["estimated_bytes_per_node"] = static_cast <Json::UInt> (
+                    (nodes * sizeof (SHAMapTreeNode) +
+                        items * (sizeof (SHAMapItem) + size)) / nodes);
+        }
+
+        {
+            int flushed = 0;
+            result["flush_ms"] = elapsedMillis ([&]{
+                flushed = map->flushDirty (hotACCOUNT_NODE, 1); });
+            result["flushed"] = flushed;
+        }
+
+        {
+            Latencies iterate (items + 1);
+            SHAMapItem::pointer item;
+            iterate.time ([&]{ item = map->peekFirstItem (); });
+            while (item)
+                iterate.time ([&]{
+                    item = map->peekNextItem (item->getTag ()); });
+            result["iterate"] = iterate.getJson ();
+        }
+
+        auto copy = map->snapShot (true);
+
+        {
+            Latencies update (items);
+            for (std::size_t i = 0; i < items; ++i)
+            {
+                auto const item = seq.item (i, 1);
+                update.time ([&]{ copy->updateGiveItem (item, false, false); });
+            }
+            result["update"] = update.getJson ();
+            result["rehash_ms"] = elapsedMillis ([&]{ copy->getHash (); });
+        }
+
+        {
+            SHAMap::Delta delta;
+            result["compare_ms"] = elapsedMillis ([&]{
+                map->compare (copy, delta, items + 1); });
+            expect (delta.size () == items, "every item differs");
+        }
+
+        // Load the flushed map back through the cache and the backend
+        {
+            f.treecache ().clear ();
+            f.treecache ().clearStats ();
+
+            for (auto const pass : { "fetch_cold", "fetch_warm" })
+            {
+                std::size_t leaves = 0;
+                result[pass]["ms"] = elapsedMillis ([&]{
+                    SHAMap loaded (SHAMapType::STATE, hash, f, j);
+                    if (loaded.fetchRoot (hash, nullptr))
+                    {
+                        loaded.setImmutable ();
+                        loaded.visitLeaves ([&](SHAMapItem::pointer const&)
+                            { ++leaves; });
+                    }
+                });
+                result[pass]["treecache"] = getHitRate (f.treecache ());
+                f.treecache ().clearStats ();
+                expect (leaves == items, "every item is fetched");
+            }
+        }
+
+        {
+            Latencies remove (items);
+            for (std::size_t i = 0; i < items; ++i)
+            {
+                auto const key = seq.key (i);
+                remove.time ([&]{ copy->delItem (key); });
+            }
+            result["delete"] = remove.getJson ();
+        }
+
+        result["peak_rss_kb"] = peakResidentKB ();
+
+        log << to_string (result);
+    }
+
+    void
+    run() override
+    {
+        testcase ("SHAMapTiming", suite::abort_on_fail);
+
+        std::string default_args =
+            "keys=random,type=memory"
+            ";keys=clustered,type=memory"
+            ";keys=sequential,type=memory"
+            ";keys=random,type=nudb"
+            ;
+
+        auto args = arg().empty() ? default_args : arg();
+        std::vector <std::string> config_strings;
+        boost::split (config_strings, args,
+            boost::algorithm::is_any_of (";"));
+
+        for (auto const& config_string : config_strings)
+        {
+            if (config_string.empty ())
+                continue;
+
+            Section config = parse (config_string);
+            if (! config.exists ("path"))
+                config.set ("path",
+                    beast::UnitTestUtilities::TempDirectory(
+                        "test_db").getFullPathName().toStdString());
+            do_test (config, config_string);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(SHAMapTiming,shamap,ripple);
+
+} // tests
+} // shamap
+} // ripple
@@ -0,0 +1,132 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/shamap/SHAMap.h>
+#include <ripple/shamap/tests/common.h>
+#include <ripple/basics/Slice.h>
+#include <beast/unit_test/suite.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+namespace shamap {
+namespace tests {
+
+class SHAMapWalk_test : public beast::unit_test::suite
+{
+    // Runs the calls on a few threads, the way parallelFor does
+    static void threaded (std::size_t n, std::function <void (std::size_t)> f)
+    {
+        std::atomic <std::size_t> next (0);
+        std::vector <std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back ([&]
+            {
+                std::size_t i;
+                while ((i = next++) < n)
+                    f (i);
+            });
+        }
+        for (auto& t : threads)
+            t.join ();
+    }
+
+    static void fill (SHAMap& map, int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            Serializer s;
+            s.add32 (i);
+            s.add64 (i);
+            map.addItem (*make_shamapitem (s.getSHA512Half (),
+                s.peekData ()), false, false);
+        }
+    }
+
+public:
+    void run ()
+    {
+        beast::Journal const j;
+        TestFamily f (j);
+
+        SHAMap source (SHAMapType::FREE, f, j);
+        fill (source, 2000);
+        source.flushDirty (hotACCOUNT_NODE, 1);
+        uint256 const root = source.getHash ();
+
+        Serializer rootNode;
+        source.getRootNode (rootNode, snfWIRE);
+
+        {
+            testcase ("complete");
+
+            SHAMap map (SHAMapType::FREE, root, f, j);
+            expect (map.fetchRoot (root, nullptr), "Should fetch root");
+
+            std::vector <SHAMapMissingNode> missing;
+            map.walkMap (missing, 32);
+            expect (missing.empty ());
+
+            expect (map.walkMap (missing, 32, threaded, nullptr));
+            expect (missing.empty ());
+        }
+
+        {
+            testcase ("missing");
+
+            // A store holding nothing but the root
+            Section section;
+            section.set ("type", "memory");
+            section.set ("path", "SHAMapWalk_test");
+            TestFamily empty (section, j);
+            SHAMap map (SHAMapType::FREE, root, empty, j);
+            expect (map.addRootNode (root, makeSlice (rootNode.peekData ()),
+                snfWIRE, nullptr).isGood (), "Should add root");
+
+            std::vector <SHAMapMissingNode> missing;
+            expect (map.walkMap (missing, 8, threaded, nullptr));
+            expect (missing.size () == 8, std::to_string (missing.size ()));
+
+            missing.clear ();
+            expect (map.walkMap (missing, 1000, threaded, nullptr));
+            expect (missing.size () == 16, std::to_string (missing.size ()));
+        }
+
+        {
+            testcase ("stop");
+
+            SHAMap map (SHAMapType::FREE, root, f, j);
+            expect (map.fetchRoot (root, nullptr), "Should fetch root");
+
+            std::vector <SHAMapMissingNode> missing;
+            expect (! map.walkMap (missing, 32, threaded,
+                [] { return true; }), "Should stop");
+            expect (missing.empty ());
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SHAMapWalk,shamap,ripple);
+
+} // tests
+} // shamap
+} // ripple
@@ -23,6 +23,7 @@
 #include <BeastConfig.h>
 #include <ripple/shamap/Family.h>
 #include <ripple/shamap/FullBelowCache.h>
+#include <ripple/shamap/FullBelowStore.h>
 #include <ripple/shamap/TreeNodeCache.h>
 #include <ripple/shamap/SHAMap.h>
 #include <ripple/basics/StringUtilities.h>
@@ -43,19 +44,33 @@ private:
     NodeStore::DummyScheduler scheduler_;
     TreeNodeCache treecache_;
     FullBelowCache fullbelow_;
+    FullBelowStore fullbelowstore_;
     std::unique_ptr<NodeStore::Database> db_;
 
 public:
     explicit
     TestFamily (beast::Journal j)
+        : TestFamily (memorySection (), j)
+    {
+    }
+
+    TestFamily (Section const& backend, beast::Journal j)
         : treecache_ ("TreeNodeCache", 65536, 60, clock_, j)
         , fullbelow_ ("full_below", clock_)
+        , fullbelowstore_ (j)
+    {
+        db_ = NodeStore::Manager::instance ().make_Database (
+            "test", scheduler_, j, 1, backend);
+    }
+
+    static
+    Section
+    memorySection ()
     {
         Section testSection;
         testSection.set("type", "memory");
         testSection.set("Path", "SHAMap_test");
-        db_ = NodeStore::Manager::instance ().make_Database (
-            "test", scheduler_, j, 1, testSection);
+        return testSection;
     }
 
     beast::manual_clock <std::chrono::steady_clock>
@@ -76,6 +91,18 @@ public:
         return fullbelow_;
     }
 
+    FullBelowStore&
+    fullbelowstore() override
+    {
+        return fullbelowstore_;
+    }
+
+    FullBelowStore const&
+    fullbelowstore() const override
+    {
+        return fullbelowstore_;
+    }
+
     TreeNodeCache&
     treecache() override
     {
@@ -22,7 +22,10 @@
 #include <ripple/app/main/Application.cpp>
 #include <ripple/app/main/CollectorManager.cpp>
 #include <ripple/app/main/Main.cpp>
+#include <ripple/app/main/MemoryGovernor.cpp>
 #include <ripple/app/main/NodeStoreScheduler.cpp>
+
+#include <ripple/app/main/tests/MemoryGovernor.test.cpp>
 #include <ripple/resource/Manager.h>
 #include <ripple/rpc/Manager.h>
 #include <beast/module/core/time/Time.h>
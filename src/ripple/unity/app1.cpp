@@ -22,3 +22,4 @@
 #include <ripple/app/consensus/LedgerConsensus.cpp>
 #include <ripple/app/ledger/LedgerCleaner.cpp>
 #include <ripple/app/ledger/LedgerMaster.cpp>
+#include <ripple/app/ledger/OpenLedgerRecord.cpp>
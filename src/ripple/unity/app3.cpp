@@ -19,9 +19,13 @@
 
 #include <BeastConfig.h>
 
+#include <ripple/app/ledger/BookIndex.cpp>
 #include <ripple/app/ledger/Ledger.cpp>
+#include <ripple/app/ledger/LedgerReplay.cpp>
 #include <ripple/app/misc/AccountState.cpp>
 
 #include <ripple/app/tests/common_ledger.cpp>
 #include <ripple/app/ledger/tests/Ledger_test.cpp>
+#include <ripple/app/ledger/tests/LedgerReplay.test.cpp>
+#include <ripple/app/ledger/tests/OpenLedgerRecord.test.cpp>
 #include <ripple/app/tests/Path_test.cpp>
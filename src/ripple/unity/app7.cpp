@@ -20,6 +20,7 @@
 #include <BeastConfig.h>
 
 #include <ripple/app/ledger/InboundLedgers.cpp>
+#include <ripple/app/ledger/LedgerHashIndex.cpp>
 #include <ripple/app/ledger/LedgerHistory.cpp>
 #include <ripple/app/tx/TransactionAcquire.cpp>
 #include <ripple/app/tx/LocalTxs.cpp>
@@ -27,3 +28,6 @@
 #include <ripple/app/misc/NetworkOPs.cpp>
 #include <ripple/app/misc/impl/AccountTxPaging.cpp>
 #include <ripple/app/misc/tests/AccountTxPaging.test.cpp>
+#include <ripple/app/misc/impl/FetchPackCache.cpp>
+#include <ripple/app/misc/tests/FetchPackCache.test.cpp>
+#include <ripple/app/ledger/tests/LedgerHashIndex.test.cpp>
@@ -27,12 +27,16 @@
 #include <ripple/nodestore/backend/RocksDBFactory.cpp>
 #include <ripple/nodestore/backend/RocksDBQuickFactory.cpp>
 
+#include <ripple/nodestore/impl/BatchReader.cpp>
 #include <ripple/nodestore/impl/BatchWriter.cpp>
 #include <ripple/nodestore/impl/DatabaseImp.h>
 #include <ripple/nodestore/impl/DatabaseRotatingImp.cpp>
+#include <ripple/nodestore/impl/DatabaseShardImp.cpp>
 #include <ripple/nodestore/impl/DummyScheduler.cpp>
 #include <ripple/nodestore/impl/DecodedBlob.cpp>
 #include <ripple/nodestore/impl/EncodedBlob.cpp>
+#include <ripple/nodestore/impl/FilteredBackend.cpp>
+#include <ripple/nodestore/impl/KeyFilter.cpp>
 #include <ripple/nodestore/impl/ManagerImp.cpp>
 #include <ripple/nodestore/impl/NodeObject.cpp>
 #include <ripple/nodestore/impl/ScopedMetrics.cpp>
@@ -41,5 +45,6 @@
 #include <ripple/nodestore/tests/Basics.test.cpp>
 #include <ripple/nodestore/tests/Database.test.cpp>
 #include <ripple/nodestore/tests/import_test.cpp>
+#include <ripple/nodestore/tests/KeyFilter.test.cpp>
 #include <ripple/nodestore/tests/Timing.test.cpp>
 
@@ -43,6 +43,7 @@
 #include <ripple/protocol/impl/STInteger.cpp>
 #include <ripple/protocol/impl/STLedgerEntry.cpp>
 #include <ripple/protocol/impl/STObject.cpp>
+#include <ripple/protocol/impl/STObjectView.cpp>
 #include <ripple/protocol/impl/STParsedJSON.cpp>
 #include <ripple/protocol/impl/STPathSet.cpp>
 #include <ripple/protocol/impl/STTx.cpp>
@@ -56,6 +57,7 @@
 #include <ripple/protocol/tests/Serializer.test.cpp>
 #include <ripple/protocol/tests/STAmount.test.cpp>
 #include <ripple/protocol/tests/STObject.test.cpp>
+#include <ripple/protocol/tests/STObjectView.test.cpp>
 #include <ripple/protocol/tests/STTx.test.cpp>
 
 #if DOXYGEN
@@ -18,13 +18,19 @@
 //==============================================================================
 
 #include <BeastConfig.h>
+#include <ripple/shamap/impl/FullBelowStore.cpp>
 #include <ripple/shamap/impl/SHAMap.cpp>
 #include <ripple/shamap/impl/SHAMapDelta.cpp>
 #include <ripple/shamap/impl/SHAMapItem.cpp>
 #include <ripple/shamap/impl/SHAMapMissingNode.cpp>
+#include <ripple/shamap/impl/SHAMapNodeBatch.cpp>
 #include <ripple/shamap/impl/SHAMapNodeID.cpp>
 #include <ripple/shamap/impl/SHAMapSync.cpp>
 #include <ripple/shamap/impl/SHAMapTreeNode.cpp>
 #include <ripple/shamap/tests/FetchPack.test.cpp>
+#include <ripple/shamap/tests/FullBelowStore.test.cpp>
 #include <ripple/shamap/tests/SHAMap.test.cpp>
+#include <ripple/shamap/tests/SHAMapNodeBatch.test.cpp>
 #include <ripple/shamap/tests/SHAMapSync.test.cpp>
+#include <ripple/shamap/tests/SHAMapTiming.test.cpp>
+#include <ripple/shamap/tests/SHAMapWalk.test.cpp>
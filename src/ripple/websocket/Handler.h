@@ -29,6 +29,7 @@
 #include <ripple/websocket/Connection.h>
 #include <ripple/websocket/WebSocket.h>
 
+#include <chrono>
 #include <memory>
 
 namespace ripple {
@@ -76,6 +77,13 @@ private:
     beast::insight::Event rpc_io_;
     beast::insight::Event rpc_size_;
     beast::insight::Event rpc_time_;
+    beast::insight::Counter ws_accepts_;
+    beast::insight::Counter ws_failures_;
+    beast::insight::Counter ws_too_slow_;
+    beast::insight::Counter ws_sends_;
+    beast::insight::Gauge ws_connections_;
+    beast::insight::Event ws_handshake_time_;
+    beast::insight::Event ws_send_size_;
     ServerDescription desc_;
 
 protected:
@@ -86,6 +94,10 @@ protected:
     typedef hash_map <connection_ptr, wsc_ptr> MapType;
     MapType mMap;
 
+    // When each accepted connection started its handshake.
+    using clock_type = std::chrono::steady_clock;
+    hash_map <connection_ptr, clock_type::time_point> mHandshakes;
+
 public:
     HandlerImpl (ServerDescription const& desc) : desc_ (desc)
     {
@@ -94,6 +106,15 @@ public:
         rpc_io_ = group->make_event ("io");
         rpc_size_ = group->make_event ("size");
         rpc_time_ = group->make_event ("time");
+
+        auto const& ws (desc_.collectorManager.group ("websocket"));
+        ws_accepts_ = ws->make_counter ("accepts");
+        ws_failures_ = ws->make_counter ("failures");
+        ws_too_slow_ = ws->make_counter ("too_slow");
+        ws_sends_ = ws->make_counter ("sends");
+        ws_connections_ = ws->make_gauge ("connections");
+        ws_handshake_time_ = ws->make_event ("handshake_time");
+        ws_send_size_ = ws->make_event ("send_size");
     }
 
     HandlerImpl(HandlerImpl const&) = delete;
@@ -114,11 +135,16 @@ public:
     {
         try
         {
+            ++ws_sends_;
+            ws_send_size_.notify (
+                static_cast <beast::insight::Event::value_type> (
+                    mpMessage->get_payload ().size ()));
             cpClient->send (
                 mpMessage->get_payload (), mpMessage->get_opcode ());
         }
         catch (...)
         {
+            ++ws_too_slow_;
             WebSocket::closeTooSlowClient (*cpClient, crTooSlow);
         }
     }
@@ -131,10 +157,15 @@ public:
             WriteLog (broadcast ? lsTRACE : lsDEBUG, HandlerLog)
                     << "Ws:: Sending '" << strMessage << "'";
 
+            ++ws_sends_;
+            ws_send_size_.notify (
+                static_cast <beast::insight::Event::value_type> (
+                    strMessage.size ()));
             cpClient->send (strMessage);
         }
         catch (...)
         {
+            ++ws_too_slow_;
             WebSocket::closeTooSlowClient (*cpClient, crTooSlow);
         }
     }
@@ -194,10 +225,27 @@ public:
         ptr->onSendEmpty ();
     }
 
+    void on_handshake_init (connection_ptr cpClient) override
+    {
+        ++ws_accepts_;
+
+        ScopedLockType sl (mLock);
+        mHandshakes[cpClient] = clock_type::now ();
+    }
+
     void on_open (connection_ptr cpClient) override
     {
         ScopedLockType   sl (mLock);
 
+        auto const handshake = mHandshakes.find (cpClient);
+        if (handshake != mHandshakes.end ())
+        {
+            ws_handshake_time_.notify (
+                std::chrono::duration_cast <std::chrono::milliseconds> (
+                    clock_type::now () - handshake->second));
+            mHandshakes.erase (handshake);
+        }
+
         try
         {
             auto remoteEndpoint = cpClient->get_socket ().remote_endpoint ();
@@ -213,6 +261,7 @@ public:
 
             assert (result.second);
             (void) result.second;
+            ws_connections_ = mMap.size ();
             WriteLog (lsDEBUG, HandlerLog) <<
                 "Ws:: on_open(" << remoteEndpoint << ")";
         }
@@ -251,6 +300,7 @@ public:
 
     void on_fail (connection_ptr cpClient) override
     {
+        ++ws_failures_;
         doClose (cpClient, "on_fail");
     }
 
@@ -261,6 +311,7 @@ public:
         wsc_ptr ptr;
         {
             ScopedLockType   sl (mLock);
+            mHandshakes.erase (cpClient);
             auto it = mMap.find (cpClient);
 
             if (it == mMap.end ())
@@ -282,6 +333,7 @@ public:
             // prevent the ConnectionImpl from being destroyed until we release
             // the lock
             mMap.erase (it);
+            ws_connections_ = mMap.size ();
         }
         ptr->preDestroy (); // Must be done before we return
         try
@@ -22,8 +22,12 @@
 
 #include <ripple/basics/Log.h>
 #include <ripple/websocket/WebSocket.h>
+#include <ripple/basics/BasicConfig.h>
 #include <beast/cxx14/memory.h> // <memory>
 #include <beast/threads/Thread.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
 
 namespace ripple {
 namespace websocket {
@@ -38,15 +42,24 @@ private:
     using LockType = std::recursive_mutex;
     using ScopedLockType = std::lock_guard <LockType>;
 
+    // Threads running each endpoint's io_service unless configured
+    static int const defaultThreads = 2;
+
     ServerDescription desc_;
+    std::size_t const threads_;
     LockType m_endpointLock;
     typename WebSocket::EndpointPtr m_endpoint;
 
+    // Extra threads sharing the io_service with the listening thread.
+    // Handlers for one connection are serialized by its strand.
+    std::vector <std::thread> m_workers;
+
 public:
     Server (ServerDescription const& desc)
        : beast::Stoppable (WebSocket::versionName(), desc.source)
         , Thread ("websocket")
         , desc_(desc)
+        , threads_ (threadCount (desc))
     {
         startThread ();
     }
@@ -69,9 +82,19 @@ private:
         }
 
         WriteLog (lsWARNING, WebSocket)
-            << "Websocket: listening on " << desc_.port;
+            << "Websocket: listening on " << desc_.port
+            << " with " << threads_ << " threads";
+
+        // The workers start once the listening thread is running the
+        // io_service, so they always find the acceptor's pending work.
+        m_endpoint->get_io_service ().post (
+            std::bind (&Server::startWorkers, this));
 
         listen();
+
+        for (auto& worker : m_workers)
+            worker.join ();
+        m_workers.clear ();
         {
             ScopedLockType lock (m_endpointLock);
             m_endpoint.reset();
@@ -102,6 +125,44 @@ private:
     }
 
     void listen();
+
+    // Called on the listening thread
+    void startWorkers ()
+    {
+        if (! m_workers.empty ())
+            return;
+
+        for (std::size_t i = 1; i < threads_; ++i)
+            m_workers.emplace_back (&Server::runWorker, this);
+    }
+
+    void runWorker ()
+    {
+        setCurrentThreadName ("websocket");
+
+        for (;;)
+        {
+            try
+            {
+                m_endpoint->get_io_service ().run ();
+                break;
+            }
+            catch (std::exception const& e)
+            {
+                WriteLog (lsWARNING, WebSocket)
+                    << "Websocket: worker exception: " << e.what ();
+            }
+        }
+    }
+
+    // A port's own section overrides [server]
+    static std::size_t threadCount (ServerDescription const& desc)
+    {
+        int const threads = get<int> (desc.config[desc.port.name],
+            "websocket_threads", get<int> (desc.config["server"],
+                "websocket_threads", defaultThreads));
+        return std::max (threads, 1);
+    }
 };
 
 } // websocket
@@ -64,6 +64,12 @@ EndpointPtr04  WebSocket04::makeEndpoint (HandlerPtr&& handler)
 {
     auto endpoint = std::make_shared <Endpoint> (std::move (handler));
 
+    endpoint->set_tcp_post_init_handler (
+        [endpoint] (websocketpp::connection_hdl hdl) {
+            if (auto conn = endpoint->get_con_from_hdl(hdl))
+                endpoint->handler()->on_handshake_init (conn);
+        });
+
     endpoint->set_open_handler (
         [endpoint] (websocketpp::connection_hdl hdl) {
             if (auto conn = endpoint->get_con_from_hdl(hdl))
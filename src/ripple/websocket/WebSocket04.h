@@ -40,6 +40,7 @@ struct WebSocket04
     class Handler
     {
     public:
+        virtual void on_handshake_init (ConnectionPtr) = 0;
         virtual void on_open (ConnectionPtr) = 0;
         virtual void on_close (ConnectionPtr) = 0;
         virtual void on_fail (ConnectionPtr) = 0;